@@ -0,0 +1,501 @@
+/*!
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//System includes
+#include <sys/types.h>
+#include <unistd.h>
+#include <string.h>
+#include <stdlib.h>
+
+//Library includes
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+//Project includes
+#include "NetStream.h"
+#include "NetStreamView.h"
+#include "Streamable.h"
+#include "BufferPool.h"
+#include "SmallNetStream.h"
+#include "ByteOrder.h"
+#include "Schema.h"
+#include "ColumnBatch.h"
+
+using namespace Inet;
+
+//Forward decl funcs
+void GetArgs(int argc, char **argv);
+
+//Globals
+double minTime				= 0.05;
+bool json							= false;
+bool firstResult			= true;
+
+//Values encoded per timed batch
+const size_t BATCH		= 1000;
+
+//Allocation counter, maintained by the replacement operator new below
+std::atomic<size_t> allocations(0);
+
+void* operator new(size_t bytes) {
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	if(void* p = malloc(bytes ? bytes : 1))
+		return p;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+/*!	@brief Print one result as a CSV row or JSON object
+ *	@param bench The benchmark name
+ *	@param type The value type or workload measured
+ *	@param size Payload bytes per operation
+ *	@param ops The number of operations timed
+ *	@param seconds The elapsed time
+ *	@param allocs The number of allocations made while timing
+ */
+void Report(const std::string& bench, const std::string& type, size_t size,
+	size_t ops, double seconds, size_t allocs)
+{
+	const double ns = seconds * 1e9 / ops;
+	const double rate = (double)size * ops / seconds;
+	const double perOp = (double)allocs / ops;
+
+	if(json) {
+		std::cout << (firstResult ? "[\n" : ",\n")
+			<< "  {\"bench\":\"" << bench << "\",\"type\":\"" << type
+			<< "\",\"size\":" << size << ",\"ops\":" << ops
+			<< ",\"ns_per_op\":" << ns << ",\"bytes_per_sec\":" << rate
+			<< ",\"allocs_per_op\":" << perOp << "}";
+	}
+	else {
+		if(firstResult)
+			std::cout << "bench,type,size,ops,ns_per_op,bytes_per_sec,allocs_per_op" << std::endl;
+		std::cout << bench << "," << type << "," << size << "," << ops << ","
+			<< ns << "," << rate << "," << perOp << std::endl;
+	}
+	firstResult = false;
+}
+
+/*!	@brief Time a batch function, repeating until the minimum time is reached
+ *	@param bench The benchmark name
+ *	@param type The value type or workload measured
+ *	@param size Payload bytes per operation
+ *	@param batch The number of operations performed by each call of fn
+ *	@param fn The function to time
+ */
+template<typename Fn>
+void Run(const std::string& bench, const std::string& type, size_t size,
+	size_t batch, Fn fn)
+{
+	typedef std::chrono::steady_clock Clock_t;
+
+	//Warm up caches and any pooled storage
+	fn();
+
+	size_t calls = 1;
+	for(;;) {
+		const size_t allocs = allocations.load();
+		const Clock_t::time_point start = Clock_t::now();
+		for(size_t i = 0; i < calls; i++)
+			fn();
+		const double seconds = std::chrono::duration<double>(Clock_t::now() - start).count();
+		const size_t made = allocations.load() - allocs;
+
+		if(seconds >= minTime) {
+			Report(bench, type, size, calls * batch, seconds, made);
+			return;
+		}
+		calls *= 2;
+	}
+}
+
+/*!	@brief Benchmark encode and decode of a batch of one value type
+ *	@param type Name of the type
+ *	@param val The value to encode
+ *	@param compact True to write compact integers
+ */
+template<typename T>
+void Value(const std::string& type, const T& val, bool compact = false) {
+	NetStream out(NetStream::Order::FIFO), in(NetStream::Order::FIFO);
+	T result;
+
+	out.setCompact(compact);
+	in.setCompact(compact);
+	for(size_t i = 0; i < BATCH; i++)
+		in << val;
+	const size_t size = in.size() / BATCH;
+
+	Run("encode", type, size, BATCH, [&]() {
+		out.prepareRaw(0);
+		for(size_t i = 0; i < BATCH; i++)
+			out << val;
+	});
+
+	Run("decode", type, size, BATCH, [&]() {
+		in.seek(0);
+		for(size_t i = 0; i < BATCH; i++)
+			in >> result;
+	});
+
+	Run("view_decode", type, size, BATCH, [&]() {
+		NetStreamView view(in.data().data(), in.size(), NetStream::Order::FIFO);
+		for(size_t i = 0; i < BATCH; i++)
+			view >> result;
+	});
+}
+
+/*!	@brief Benchmark blob write and zero-copy read
+ *	@param bytes The size of each blob
+ */
+void Blob(size_t bytes) {
+	NetStream out(NetStream::Order::FIFO), in(NetStream::Order::FIFO);
+	const std::vector<char> blob(bytes, 'b');
+	const char* p;
+	size_t length;
+
+	for(size_t i = 0; i < BATCH; i++)
+		in.write(blob.data(), blob.size());
+
+	Run("encode", "blob", bytes, BATCH, [&]() {
+		out.prepareRaw(0);
+		for(size_t i = 0; i < BATCH; i++)
+			out.write(blob.data(), blob.size());
+	});
+
+	//Borrowed blobs only record where the payload is
+	if(bytes >= NetStream::MIN_BORROWED_BYTES) {
+		Run("encode_ref", "blob", bytes, BATCH, [&]() {
+			out.prepareRaw(0);
+			for(size_t i = 0; i < BATCH; i++)
+				out.writeRef(blob.data(), blob.size());
+		});
+	}
+
+	Run("decode", "blob", bytes, BATCH, [&]() {
+		in.seek(0);
+		for(size_t i = 0; i < BATCH; i++)
+			in.read(p, length);
+	});
+}
+
+/*!	@brief Benchmark repeated symbols written in full and through the dictionary
+ *	@param interning True to intern the strings
+ */
+void Symbols(bool interning) {
+	const std::vector<std::string> symbols = {
+		"INET.NASDAQ", "SOCK.NYSE", "STREAM.LSE", "FRAME.XETRA", "VIEW.TSE"
+	};
+	const std::string type = interning ? "symbol_interned" : "symbol";
+	NetStream in(NetStream::Order::FIFO);
+	std::string result;
+	std::string_view view;
+
+	in.setInterning(interning);
+	for(size_t i = 0; i < BATCH; i++)
+		in << symbols[i % symbols.size()];
+	const size_t size = in.size() / BATCH;
+
+	Run("encode", type, size, BATCH, [&]() {
+		NetStream out(NetStream::Order::FIFO);
+		out.setInterning(interning);
+		for(size_t i = 0; i < BATCH; i++)
+			out << symbols[i % symbols.size()];
+	});
+
+	Run("decode", type, size, BATCH, [&]() {
+		in.seek(0);
+		for(size_t i = 0; i < BATCH; i++)
+			in >> result;
+	});
+
+	Run("view_decode", type, size, BATCH, [&]() {
+		in.seek(0);
+		for(size_t i = 0; i < BATCH; i++)
+			in >> view;
+	});
+}
+
+/*!	@brief Benchmark array encode and decode
+ *	@param type Name of the element type
+ *	@param count The number of elements in each array
+ *	@param val The value of every element
+ */
+template<typename T>
+void Array(const std::string& type, size_t count, const T& val) {
+	NetStream out(NetStream::Order::FIFO), in(NetStream::Order::FIFO);
+	const std::vector<T> values(count, val);
+	std::vector<T> result;
+	const size_t batch = BATCH / 10;
+
+	for(size_t i = 0; i < batch; i++)
+		in << values;
+
+	Run("encode", type, count * sizeof(T), batch, [&]() {
+		out.prepareRaw(0);
+		for(size_t i = 0; i < batch; i++)
+			out << values;
+	});
+
+	Run("decode", type, count * sizeof(T), batch, [&]() {
+		in.seek(0);
+		for(size_t i = 0; i < batch; i++)
+			in >> result;
+	});
+}
+
+/*!	@brief Typical message mixing scalar, string and nested values */
+class Quote : public Streamable {
+public:
+	u_int64_t								id = 1234567;
+	u_int32_t								account = 42;
+	int64_t									price = -15025;
+	u_int16_t								quantity = 100;
+	char										side = 'B';
+	std::string							symbol = "INET";
+	std::vector<u_int32_t>	legs = { 1, 2, 3, 4 };
+
+	u_int32_t encodedSize() const override {
+		return NetStream::encodedSize(id) + NetStream::encodedSize(account) +
+			NetStream::encodedSize(price) + NetStream::encodedSize(quantity) +
+			NetStream::encodedSize(side) + NetStream::encodedSize(symbol) +
+			NetStream::encodedSize(legs);
+	}
+
+	void encode(NetStream& stream) const override {
+		stream << id << account << price << quantity << side << symbol << legs;
+	}
+
+	void decode(NetStream& stream) override {
+		stream >> id >> account >> price >> quantity >> side >> symbol >> legs;
+	}
+};
+
+/*!	@brief Benchmark whole mixed messages, including stream construction */
+void Mixed() {
+	BufferPool pool;
+	Quote quote;
+	NetStream encoded(NetStream::Order::FIFO);
+	encoded << quote;
+	const size_t size = encoded.size();
+
+	Run("encode", "mixed", size, 1, [&]() {
+		NetStream stream(NetStream::Order::FIFO);
+		stream << quote;
+	});
+
+	Run("encode", "mixed_pooled", size, 1, [&]() {
+		NetStream stream(pool, NetStream::Order::FIFO);
+		stream << quote;
+	});
+
+	Run("encode", "mixed_inline", size, 1, [&]() {
+		SmallNetStream<256> stream(NetStream::Order::FIFO);
+		stream << quote;
+	});
+
+	Run("decode", "mixed", size, 1, [&]() {
+		encoded.seek(0);
+		encoded >> quote;
+	});
+}
+
+/*!	@brief Wide fixed-width record for row and column layout comparison */
+struct Tick {
+	u_int64_t		id;
+	int64_t			time;
+	double			bid;
+	double			ask;
+	u_int32_t		bidSize;
+	u_int32_t		askSize;
+};
+
+typedef Field<&Tick::id>			TickId_t;
+typedef Field<&Tick::time>		TickTime_t;
+typedef Field<&Tick::bid>			TickBid_t;
+typedef Field<&Tick::ask>			TickAsk_t;
+typedef Field<&Tick::bidSize>	TickBidSize_t;
+typedef Field<&Tick::askSize>	TickAskSize_t;
+
+typedef Schema<Tick, TickId_t, TickTime_t, TickBid_t, TickAsk_t,
+	TickBidSize_t, TickAskSize_t> TickSchema_t;
+typedef ColumnBatch<Tick, TickId_t, TickTime_t, TickBid_t, TickAsk_t,
+	TickBidSize_t, TickAskSize_t> TickBatch_t;
+
+/*!	@brief Benchmark record sets written row by row and column by column
+ *	@param count The number of records in each set
+ */
+void Columns(size_t count) {
+	std::vector<Tick> ticks(count), result;
+	std::vector<double> bids;
+	NetStream rows(NetStream::Order::FIFO), columns(NetStream::Order::FIFO),
+		compact(NetStream::Order::FIFO);
+
+	for(size_t i = 0; i < count; i++)
+		ticks[i] = { 1000000 + i, (int64_t)(1600000000000 + i * 3), 100.0 + i * 0.01,
+			100.02 + i * 0.01, (u_int32_t)(i % 500), (u_int32_t)(i % 700) };
+	compact.setCompact(true);
+
+	TickSchema_t::encode(rows, ticks.data(), ticks.size());
+	TickBatch_t::encode(columns, ticks);
+	TickBatch_t::encode(compact, ticks);
+
+	Run("encode", "rows", rows.size() / count, count, [&]() {
+		NetStream stream(NetStream::Order::FIFO);
+		TickSchema_t::encode(stream, ticks.data(), ticks.size());
+	});
+
+	Run("encode", "columns", columns.size() / count, count, [&]() {
+		NetStream stream(NetStream::Order::FIFO);
+		TickBatch_t::encode(stream, ticks);
+	});
+
+	Run("encode", "columns_compact", compact.size() / count, count, [&]() {
+		NetStream stream(NetStream::Order::FIFO);
+		stream.setCompact(true);
+		TickBatch_t::encode(stream, ticks);
+	});
+
+	Run("decode", "rows", rows.size() / count, count, [&]() {
+		NetStreamView view(rows.data().data(), rows.size(), NetStream::Order::FIFO);
+		result.resize(count);
+		for(Tick& tick : result)
+			TickSchema_t::decode(view, tick);
+	});
+
+	Run("decode", "columns", columns.size() / count, count, [&]() {
+		NetStreamView view(columns.data().data(), columns.size(), NetStream::Order::FIFO);
+		TickBatch_t::decode(view, result);
+	});
+
+	Run("decode", "columns_compact", compact.size() / count, count, [&]() {
+		NetStreamView view(compact.data().data(), compact.size(), NetStream::Order::FIFO);
+		TickBatch_t::decode(view, result);
+	});
+
+	Run("decode", "column_one", columns.size() / count, count, [&]() {
+		NetStreamView view(columns.data().data(), columns.size(), NetStream::Order::FIFO);
+		TickBatch_t::column<TickBid_t>(view, bids);
+	});
+}
+
+/*!	@brief NetStream benchmark - times encode and decode of each value type
+ *	@param argc Command line argument count
+ *	@param argv Pointer to array of command line arguments
+ *	@return Non-zero return value on application error
+ */
+int main(int argc, char *argv[]) {
+	try {
+		GetArgs(argc, argv);
+
+		//Fixed-width values
+		Value("char", 'c');
+		Value("uchar", (u_char)'C');
+		Value("int16", (int16_t)-1234);
+		Value("uint16", (u_int16_t)1234);
+		Value("int32", (int32_t)-123456);
+		Value("uint32", (u_int32_t)123456);
+		Value("int64", (int64_t)-1234567890123LL);
+		Value("uint64", (u_int64_t)1234567890123ULL);
+		Value("float32", 1234.5f);
+		Value("float64", 1234.5678);
+
+		//Compact values
+		Value("varint_small", (u_int32_t)100, true);
+		Value("varint_large", (u_int64_t)1234567890123ULL, true);
+		Value("zigzag", (int32_t)-100, true);
+
+		//String size sweep
+		for(size_t bytes = 8; bytes <= 64 * 1024; bytes *= 8)
+			Value("string_" + std::to_string(bytes), std::string(bytes, 's'));
+
+		//Repeated strings
+		Symbols(false);
+		Symbols(true);
+
+		//Variable length values
+		Blob(256);
+		Blob(64 * 1024);
+		Array("array_u32", 64, (u_int32_t)0x01020304);
+		Array("array_f64", 64, 1234.5678);
+
+		//Whole messages
+		Mixed();
+
+		//Record sets
+		Columns(10000);
+
+		if(json && !firstResult)
+			std::cout << "\n]" << std::endl;
+	}
+	catch(const std::exception &e) {
+		std::cerr << e.what() << std::endl;
+		return 1;
+	}
+	catch(const int& i) {
+		//Help
+	}
+
+	return 0;
+}
+
+/*!	@brief Process command line arguments
+ * 	@param argc As passed to main()
+ * 	@param argv As passed to main()
+ */
+void GetArgs(int argc, char **argv) {
+	//Declare locals
+	int c;
+
+	//Iterate over arguments
+	while((c = getopt(argc, argv, "t:jh")) != -1) {
+		switch(c) {
+			//Minimum time spent on each benchmark
+			case 't':
+				if(strlen(optarg) > 0) minTime = atof(optarg) / 1000.0;
+				break;
+
+			//Write JSON rather than CSV
+			case 'j':
+				json = true;
+				break;
+
+			//Help or any other arg will land here
+			case 'h':
+			default:
+				std::cout << "NetStream encode/decode benchmark for the Inet::Socket C++ library." << std::endl;
+				std::cout << "Results are written to standard output as CSV, one row per benchmark," << std::endl;
+				std::cout << "with the array conversion backend (" << NetOrderBackend() << ") noted on stderr." << std::endl << std::endl;
+				std::cout << "Usage: " << std::endl;
+				std::cout << "   streambench [OPTION]..." << std::endl << std::endl;
+				std::cout << "Options: " << std::endl;
+				std::cout << "  -t <MS>       Minimum time spent on each benchmark, 50ms by default" << std::endl;
+				std::cout << "  -j            Write results as a JSON array instead of CSV" << std::endl;
+				std::cout << "  -h            Display help for this application" << std::endl;
+				throw 0;
+		}
+	}
+
+	std::cerr << "Array byte order backend: " << NetOrderBackend() << std::endl;
+}
@@ -23,7 +23,9 @@
 #include <sys/socket.h>
 #include <sys/un.h>
 #include <unistd.h>
+#include <fcntl.h>
 #include <errno.h>
+#include <string.h>
 
 //Library includes
 #include <utility>
@@ -68,10 +70,33 @@ AbstractSocket& AbstractSocket::operator=(AbstractSocket&& other) noexcept {
 		//Call base class move
 		//Move socket instance
 		socket_ = std::move(other.socket_);
+		blocking_ = other.blocking_;
 	}
 
 	//Return self ref
 	return *this;
 }
 
+/*!	@brief Switch the socket between blocking and non-blocking mode
+ *	@param blocking False to set O_NONBLOCK on the socket
+ */
+void AbstractSocket::setBlocking(const bool blocking) {
+	blocking_ = blocking;
+	if(socket_ != INVALID_SOCKET)
+		applyBlocking();
+}
+
+/*!	@brief Apply the blocking mode to the open socket */
+void AbstractSocket::applyBlocking() {
+	//Declare local
+	const int flags = ::fcntl(socket_, F_GETFL, 0);
+
+	if(flags < 0)
+		throw SocketException(LastError(), std::string("Error reading socket flags: ") + strerror(LastError()));
+
+	const int mode = blocking_ ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK);
+	if(mode != flags && ::fcntl(socket_, F_SETFL, mode) < 0)
+		throw SocketException(LastError(), std::string("Error setting blocking mode: ") + strerror(LastError()));
+}
+
 }; //Inet namespace
@@ -79,9 +79,30 @@ public:
 	 */
 	AbstractSocket& operator=(AbstractSocket &&other) noexcept;
 
+	/*!	@brief Returns the descriptor of the underlying socket */
+	inline socket_t handle() const { return socket_; }
+
+	/*!	@brief Returns true if calls on the socket wait until they can complete */
+	inline bool blocking() const { return blocking_; }
+
+	/*!	@brief Switch the socket between blocking and non-blocking mode
+	 *	Applied to the open socket straight away, and to the socket created
+	 *	by a later bind() or connect(). In non-blocking mode calls that would
+	 *	have to wait return straight away instead, see WOULD_BLOCK.
+	 *	@param blocking False to set O_NONBLOCK on the socket
+	 *	@throw SocketException if the mode cannot be changed
+	 */
+	void setBlocking(const bool blocking);
+
 protected:
+	/*!	@brief Apply the blocking mode to the open socket */
+	void applyBlocking();
+
 	/*!< Handle to the internal socket */
 	socket_t				socket_ = INVALID_SOCKET;
+
+	/*!< Blocking mode applied to the socket */
+	bool						blocking_ = true;
 };
 
 }; //Inet namespace
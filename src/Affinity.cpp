@@ -0,0 +1,72 @@
+/*!
+ *
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//System includes
+#include <sys/types.h>
+#include <pthread.h>
+#include <sched.h>
+
+//Library includes
+#include <algorithm>
+
+//Project includes
+#include "Affinity.h"
+
+//Namespace container
+namespace Inet {
+
+/*!	@brief Returns the cores the process is allowed to run on */
+std::vector<int> AllowedCpus() {
+	//Declare locals
+	std::vector<int> cores;
+	cpu_set_t set;
+
+	CPU_ZERO(&set);
+	if(sched_getaffinity(0, sizeof(set), &set) == 0) {
+		for(int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+			if(CPU_ISSET(cpu, &set))
+				cores.push_back(cpu);
+		}
+	}
+
+	//Fall back on the hardware thread count if the mask is unavailable
+	if(cores.empty()) {
+		for(unsigned cpu = 0; cpu < std::max(1u, std::thread::hardware_concurrency()); cpu++)
+			cores.push_back((int)cpu);
+	}
+
+	return cores;
+}
+
+/*!	@brief Pin a thread to a single core
+ *	@param thread The thread to pin
+ *	@param cpu The core to run it on
+ *	@return True if pinned
+ */
+bool PinThread(std::thread& thread, const int cpu) {
+	//Declare local
+	cpu_set_t set;
+
+	CPU_ZERO(&set);
+	CPU_SET(cpu, &set);
+	return pthread_setaffinity_np(thread.native_handle(), sizeof(set), &set) == 0;
+}
+
+} //Inet namespace
@@ -0,0 +1,51 @@
+/*!
+ *
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+//Include once
+#ifndef AFFINITY_H_INCLUDED
+#define AFFINITY_H_INCLUDED
+
+//System includes
+#include <sys/types.h>
+
+//Library includes
+#include <thread>
+#include <vector>
+
+//Namespace container
+namespace Inet {
+
+/*!	@brief Returns the cores the process is allowed to run on
+ *	Taken from the process affinity mask, so cores excluded by taskset or a
+ *	cpuset cgroup are left out. Never empty.
+ */
+std::vector<int> AllowedCpus();
+
+/*!	@brief Pin a thread to a single core
+ *	@param thread The thread to pin
+ *	@param cpu The core to run it on
+ *	@return True if pinned, false if the core can't be used
+ */
+bool PinThread(std::thread& thread, const int cpu);
+
+} //Inet namespace
+
+#endif //AFFINITY_H_INCLUDED
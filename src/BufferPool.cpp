@@ -0,0 +1,147 @@
+/*!
+ *
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed Addin the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//System includes
+
+//Library includes
+
+//Project includes
+#include "BufferPool.h"
+
+//Namespace container
+namespace Inet {
+
+/*!	@brief Construct an empty pool
+ *	@param maxBuffers The largest number of buffers the pool will keep
+ *	@param maxCapacity Buffers with more capacity than this are freed
+ *	@param initialCapacity Capacity reserved for newly allocated buffers
+ */
+BufferPool::BufferPool(const size_t maxBuffers, const size_t maxCapacity,
+	const size_t initialCapacity) :
+	maxBuffers_(maxBuffers), maxCapacity_(maxCapacity),
+	initialCapacity_(initialCapacity)
+{
+	//Holding list never grows past the limit
+	buffers_.reserve(maxBuffers_);
+}
+
+/*!	@brief Destructor */
+BufferPool::~BufferPool() {}
+
+/*!	@brief Returns the pool belonging to the calling thread
+ *	@return Reference to the thread's pool
+ */
+BufferPool& BufferPool::local() {
+	static thread_local BufferPool pool;
+	return pool;
+}
+
+/*!	@brief Take an empty buffer from the pool
+ *	@return A pooled buffer if one is available, otherwise a new buffer
+ */
+BufferPool::Buffer_t BufferPool::acquire() {
+	//Declare local
+	Buffer_t buffer;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stats_.acquired++;
+		if(!buffers_.empty()) {
+			buffer = std::move(buffers_.back());
+			buffers_.pop_back();
+			stats_.reused++;
+			stats_.pooled--;
+			stats_.pooledBytes -= buffer.capacity();
+			return buffer;
+		}
+	}
+
+	//Allocate outside the lock
+	buffer.reserve(initialCapacity_);
+	return buffer;
+}
+
+/*!	@brief Return a buffer to the pool
+ *	@param buffer The buffer to return, left empty
+ */
+void BufferPool::release(Buffer_t&& buffer) {
+	//Declare local
+	Buffer_t kept;
+
+	//Take over heap storage with a plain allocator, inline storage stays put
+	buffer.clear();
+	if(!buffer.get_allocator().owns(buffer.data()))
+		kept = std::move(buffer);
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		if(buffers_.size() < maxBuffers_ && kept.capacity() > 0 &&
+			kept.capacity() <= maxCapacity_) {
+			stats_.released++;
+			stats_.pooled++;
+			stats_.pooledBytes += kept.capacity();
+			buffers_.push_back(std::move(kept));
+			return;
+		}
+		stats_.discarded++;
+	}
+
+	//Anything not kept is freed outside the lock
+}
+
+/*!	@brief Pre-allocate buffers so the first streams do not allocate
+ *	@param count The number of buffers to add, up to the pool limit
+ */
+void BufferPool::prime(const size_t count) {
+	for(size_t i = 0; i < count; i++) {
+		Buffer_t buffer;
+		buffer.reserve(initialCapacity_);
+
+		std::lock_guard<std::mutex> lock(mutex_);
+		if(buffers_.size() >= maxBuffers_)
+			break;
+		stats_.pooled++;
+		stats_.pooledBytes += buffer.capacity();
+		buffers_.push_back(std::move(buffer));
+	}
+}
+
+/*!	@brief Free all pooled buffers */
+void BufferPool::clear() {
+	//Declare local
+	std::vector<Buffer_t> buffers;
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		buffers.swap(buffers_);
+		buffers_.reserve(maxBuffers_);
+		stats_.pooled = 0;
+		stats_.pooledBytes = 0;
+	}
+}
+
+/*!	@brief Returns a snapshot of the pool's counters
+ *	@return Copy of the counters taken under the pool lock
+ */
+BufferPool::Stats BufferPool::stats() const {
+	std::lock_guard<std::mutex> lock(mutex_);
+	return stats_;
+}
+} //Inet namespace end
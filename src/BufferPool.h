@@ -0,0 +1,120 @@
+/*!
+ *
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed Addin the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef BUFFERPOOL_H_INCLUDED
+#define BUFFERPOOL_H_INCLUDED
+
+//System includes
+#include <sys/types.h>
+
+//Library includes
+#include <vector>
+#include <mutex>
+
+//Project includes
+#include "NetStream.h"
+
+//Namespace container
+namespace Inet {
+
+/*!	@brief Bounded pool of reusable stream buffers
+ *	Streams constructed with a pool take their storage from it and hand it
+ *	back, capacity intact, when they are destroyed. Once the pool is warm a
+ *	stream of similar size is built and released without touching the heap.
+ *	The pool keeps at most a fixed number of buffers, and buffers that have
+ *	grown past a capacity limit are freed instead of kept, so memory held by
+ *	the pool stays bounded. All operations are safe to call from any thread.
+ */
+class BufferPool {
+public:
+	///Typedefs local to class
+	typedef NetStream::Buffer_t					Buffer_t;
+
+	/*!	@brief Pool usage counters */
+	struct Stats {
+		size_t		acquired = 0;		///< Buffers handed out
+		size_t		reused = 0;			///< Buffers handed out from the pool
+		size_t		released = 0;		///< Buffers returned and kept
+		size_t		discarded = 0;	///< Buffers returned and freed
+		size_t		pooled = 0;			///< Buffers currently held
+		size_t		pooledBytes = 0;///< Capacity of the buffers currently held
+	};
+
+public:
+	/*!	@brief Construct an empty pool
+	 *	@param maxBuffers The largest number of buffers the pool will keep
+	 *	@param maxCapacity Buffers with more capacity than this are freed on
+	 *		release rather than kept
+	 *	@param initialCapacity Capacity reserved for buffers the pool has to
+	 *		allocate because it is empty
+	 */
+	explicit BufferPool(const size_t maxBuffers = 64,
+		const size_t maxCapacity = 64 * 1024, const size_t initialCapacity = 256);
+
+	/*!	@brief Copy constructor, delete default */
+	BufferPool(const BufferPool& other) = delete;
+
+	/*!	@brief Assignment operator, delete default */
+	BufferPool& operator=(const BufferPool& other) = delete;
+
+	/*!	@brief Destructor, frees all pooled buffers */
+	virtual ~BufferPool();
+
+	/*!	@brief Returns the pool belonging to the calling thread
+	 *	Created on first use with the default limits and destroyed when the
+	 *	thread exits, so streams using it must not outlive the thread.
+	 */
+	static BufferPool& local();
+
+	/*!	@brief Take an empty buffer from the pool
+	 *	@return A pooled buffer if one is available, otherwise a new buffer
+	 *		with the initial capacity reserved
+	 */
+	Buffer_t acquire();
+
+	/*!	@brief Return a buffer to the pool
+	 *	The buffer is cleared and kept if the pool has room and its capacity
+	 *	is within the limit, otherwise it is freed. Inline stream storage is
+	 *	never kept.
+	 *	@param buffer The buffer to return, left empty
+	 */
+	void release(Buffer_t&& buffer);
+
+	/*!	@brief Pre-allocate buffers so the first streams do not allocate
+	 *	@param count The number of buffers to add, up to the pool limit
+	 */
+	void prime(const size_t count);
+
+	/*!	@brief Free all pooled buffers */
+	void clear();
+
+	/*!	@brief Returns a snapshot of the pool's counters */
+	Stats stats() const;
+
+private:
+	mutable std::mutex		mutex_;
+	std::vector<Buffer_t>	buffers_;
+	Stats									stats_;
+	const size_t					maxBuffers_;
+	const size_t					maxCapacity_;
+	const size_t					initialCapacity_;
+};
+} //Inet namespace
+
+#endif // BUFFERPOOL_H_INCLUDED
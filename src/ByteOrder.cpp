@@ -0,0 +1,194 @@
+/*!
+ *
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//System includes
+#include <memory.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BYTEORDER_X86_SIMD
+#endif
+
+//Library includes
+#include <cstdint>
+
+//Project includes
+#include "ByteOrder.h"
+
+//Namespace container
+namespace Inet {
+
+//Module-local conversion routines
+namespace {
+
+/*! @brief Signature shared by all array conversion routines */
+typedef void (*NetOrderCopy_t)(void*, const void*, size_t);
+
+/*!	@brief Reverse the bytes of a single value */
+inline uint16_t Swap(uint16_t val) { return __builtin_bswap16(val); }
+inline uint32_t Swap(uint32_t val) { return __builtin_bswap32(val); }
+inline uint64_t Swap(uint64_t val) { return __builtin_bswap64(val); }
+
+/*!	@brief Portable conversion, one value at a time
+ *	@param dst Destination buffer
+ *	@param src Source buffer
+ *	@param count The number of values to copy
+ */
+template<typename T>
+void ScalarCopy(void* dst, const void* src, size_t count) {
+	//Declare local
+	char* d = (char*)dst;
+	const char* s = (const char*)src;
+	T val;
+
+	for(size_t i = 0; i < count; i++) {
+		memcpy(&val, s + i * sizeof(T), sizeof(T));
+		val = Swap(val);
+		memcpy(d + i * sizeof(T), &val, sizeof(T));
+	}
+}
+
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+/*!	@brief Byte order matches the network, plain copy */
+void NativeCopy16(void* dst, const void* src, size_t count) { memmove(dst, src, count * 2); }
+void NativeCopy32(void* dst, const void* src, size_t count) { memmove(dst, src, count * 4); }
+void NativeCopy64(void* dst, const void* src, size_t count) { memmove(dst, src, count * 8); }
+#endif
+
+#ifdef BYTEORDER_X86_SIMD
+/*!	@brief Shuffle control reversing each T-sized lane of a 32-byte register */
+template<typename T>
+struct ShuffleMask {
+	char bytes[32];
+	constexpr ShuffleMask() : bytes() {
+		for(int i = 0; i < 32; i++)
+			bytes[i] = (char)((i % 16) / sizeof(T) * sizeof(T) + (sizeof(T) - 1 - i % sizeof(T)));
+	}
+};
+
+/*!	@brief SSSE3 conversion, 16 bytes per shuffle */
+template<typename T>
+__attribute__((target("ssse3")))
+void Ssse3Copy(void* dst, const void* src, size_t count) {
+	//Declare local
+	static constexpr ShuffleMask<T> control;
+	const __m128i mask = _mm_loadu_si128((const __m128i*)control.bytes);
+	const size_t bytes = count * sizeof(T);
+	char* d = (char*)dst;
+	const char* s = (const char*)src;
+	size_t i = 0;
+
+	for(; i + 16 <= bytes; i += 16) {
+		__m128i v = _mm_loadu_si128((const __m128i*)(s + i));
+		_mm_storeu_si128((__m128i*)(d + i), _mm_shuffle_epi8(v, mask));
+	}
+
+	//Remaining values that don't fill a register
+	ScalarCopy<T>(d + i, s + i, (bytes - i) / sizeof(T));
+}
+
+/*!	@brief AVX2 conversion, 32 bytes per shuffle */
+template<typename T>
+__attribute__((target("avx2")))
+void Avx2Copy(void* dst, const void* src, size_t count) {
+	//Declare local
+	static constexpr ShuffleMask<T> control;
+	const __m256i mask = _mm256_loadu_si256((const __m256i*)control.bytes);
+	const size_t bytes = count * sizeof(T);
+	char* d = (char*)dst;
+	const char* s = (const char*)src;
+	size_t i = 0;
+
+	for(; i + 32 <= bytes; i += 32) {
+		__m256i v = _mm256_loadu_si256((const __m256i*)(s + i));
+		_mm256_storeu_si256((__m256i*)(d + i), _mm256_shuffle_epi8(v, mask));
+	}
+
+	//Remaining values that don't fill a register
+	ScalarCopy<T>(d + i, s + i, (bytes - i) / sizeof(T));
+}
+#endif //BYTEORDER_X86_SIMD
+
+/*!	@brief Conversion routines selected for the running CPU */
+struct Backend {
+	const char*			name;
+	NetOrderCopy_t	copy16;
+	NetOrderCopy_t	copy32;
+	NetOrderCopy_t	copy64;
+};
+
+/*!	@brief Select the conversion routines once, on first use
+ *	@return The backend for this host
+ */
+const Backend& Selected() {
+	static const Backend backend = []() -> Backend {
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+		return { "native", NativeCopy16, NativeCopy32, NativeCopy64 };
+#else
+#ifdef BYTEORDER_X86_SIMD
+		__builtin_cpu_init();
+		if(__builtin_cpu_supports("avx2"))
+			return { "avx2", Avx2Copy<uint16_t>, Avx2Copy<uint32_t>, Avx2Copy<uint64_t> };
+		if(__builtin_cpu_supports("ssse3"))
+			return { "ssse3", Ssse3Copy<uint16_t>, Ssse3Copy<uint32_t>, Ssse3Copy<uint64_t> };
+#endif //BYTEORDER_X86_SIMD
+		return { "scalar", ScalarCopy<uint16_t>, ScalarCopy<uint32_t>, ScalarCopy<uint64_t> };
+#endif
+	}();
+	return backend;
+}
+
+} //Module-local namespace
+
+/*!	@brief Copy an array of 16-bit values between host and network byte order
+ *	@param dst Destination buffer, need not be aligned
+ *	@param src Source buffer, need not be aligned
+ *	@param count The number of 16-bit values to copy
+ */
+void NetOrderCopy16(void* dst, const void* src, size_t count) {
+	Selected().copy16(dst, src, count);
+}
+
+/*!	@brief Copy an array of 32-bit values between host and network byte order
+ *	@param dst Destination buffer, need not be aligned
+ *	@param src Source buffer, need not be aligned
+ *	@param count The number of 32-bit values to copy
+ */
+void NetOrderCopy32(void* dst, const void* src, size_t count) {
+	Selected().copy32(dst, src, count);
+}
+
+/*!	@brief Copy an array of 64-bit values between host and network byte order
+ *	@param dst Destination buffer, need not be aligned
+ *	@param src Source buffer, need not be aligned
+ *	@param count The number of 64-bit values to copy
+ */
+void NetOrderCopy64(void* dst, const void* src, size_t count) {
+	Selected().copy64(dst, src, count);
+}
+
+/*!	@brief Returns the name of the array conversion selected for this CPU
+ *	@return One of "avx2", "ssse3", "scalar" or "native" (big-endian host)
+ */
+const char* NetOrderBackend() {
+	return Selected().name;
+}
+
+} //Inet namespace
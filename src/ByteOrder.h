@@ -0,0 +1,147 @@
+/*!
+ *
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//Include once
+#ifndef BYTEORDER_H_INCLUDED
+#define BYTEORDER_H_INCLUDED
+
+//System includes
+#include <sys/types.h>
+#include <memory.h>
+
+//Library includes
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+//Namespace container
+namespace Inet {
+
+/*!	@brief Convert a single integer between host and network byte order
+ *	Resolved at compile time to a no-op or a single byte-swap instruction.
+ *	@param val The value to convert
+ *	@return The value with its byte order reversed on little-endian hosts
+ */
+template<typename T>
+constexpr T NetOrder(const T val) {
+	static_assert(std::is_integral<T>::value, "NetOrder requires an integer type");
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	if constexpr(sizeof(T) == 2)
+		return (T)__builtin_bswap16((uint16_t)val);
+	else if constexpr(sizeof(T) == 4)
+		return (T)__builtin_bswap32((uint32_t)val);
+	else if constexpr(sizeof(T) == 8)
+		return (T)__builtin_bswap64((uint64_t)val);
+#endif
+	return val;
+}
+
+/*!	@brief Unsigned integer with the width of a floating-point type */
+template<typename T> struct FloatBits;
+template<> struct FloatBits<float> { typedef uint32_t type; };
+template<> struct FloatBits<double> { typedef uint64_t type; };
+
+static_assert(sizeof(float) == 4 && sizeof(double) == 8,
+	"Floating-point values must be IEEE-754 single and double precision");
+
+/*!	@brief Store a floating-point value in network byte order
+ *	The value is swapped as its integer bit pattern, so the swapped bytes
+ *	never pass through a floating-point register and every bit is kept.
+ *	@param dst Destination, need not be aligned
+ *	@param val The value to store
+ */
+template<typename T>
+inline void NetOrderStore(void* dst, const T val) {
+	typename FloatBits<T>::type bits;
+	memcpy(&bits, &val, sizeof(T));
+	bits = NetOrder(bits);
+	memcpy(dst, &bits, sizeof(T));
+}
+
+/*!	@brief Load a floating-point value stored in network byte order
+ *	@param src Source, need not be aligned
+ *	@return The value in host byte order
+ */
+template<typename T>
+inline T NetOrderLoad(const void* src) {
+	typename FloatBits<T>::type bits;
+	T val;
+	memcpy(&bits, src, sizeof(T));
+	bits = NetOrder(bits);
+	memcpy(&val, &bits, sizeof(T));
+	return val;
+}
+
+/*!	@brief Copy an array of 16-bit values between host and network byte order
+ *	The conversion is its own inverse, so the same call encodes and decodes.
+ *	Source and destination may be the same buffer but must not otherwise overlap.
+ *	@param dst Destination buffer, need not be aligned
+ *	@param src Source buffer, need not be aligned
+ *	@param count The number of 16-bit values to copy
+ */
+void NetOrderCopy16(void* dst, const void* src, size_t count);
+
+/*!	@brief Copy an array of 32-bit values between host and network byte order
+ *	@param dst Destination buffer, need not be aligned
+ *	@param src Source buffer, need not be aligned
+ *	@param count The number of 32-bit values to copy
+ */
+void NetOrderCopy32(void* dst, const void* src, size_t count);
+
+/*!	@brief Copy an array of 64-bit values between host and network byte order
+ *	@param dst Destination buffer, need not be aligned
+ *	@param src Source buffer, need not be aligned
+ *	@param count The number of 64-bit values to copy
+ */
+void NetOrderCopy64(void* dst, const void* src, size_t count);
+
+/*!	@brief Copy an array of integers or floats between host and network byte order
+ *	Selects the conversion for the element width at compile time. Floats
+ *	are converted as their bit patterns, using the same vector swaps.
+ *	@param dst Destination buffer, need not be aligned
+ *	@param src Source buffer, need not be aligned
+ *	@param count The number of values to copy
+ */
+template<typename T>
+inline void NetOrderCopy(void* dst, const void* src, const size_t count) {
+	static_assert(std::is_arithmetic<T>::value, "NetOrderCopy requires an arithmetic type");
+
+	//Empty vectors may hand over null pointers, which memcpy must never see
+	if(count == 0)
+		return;
+
+	if constexpr(sizeof(T) == 2)
+		NetOrderCopy16(dst, src, count);
+	else if constexpr(sizeof(T) == 4)
+		NetOrderCopy32(dst, src, count);
+	else if constexpr(sizeof(T) == 8)
+		NetOrderCopy64(dst, src, count);
+	else
+		memcpy(dst, src, count * sizeof(T));
+}
+
+/*!	@brief Returns the name of the array conversion selected for this CPU
+ *	@return One of "avx2", "ssse3", "scalar" or "native" (big-endian host)
+ */
+const char* NetOrderBackend();
+
+} //Inet namespace
+
+#endif //BYTEORDER_H_INCLUDED
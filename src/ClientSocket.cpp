@@ -103,6 +103,10 @@ void ClientSocket::connect(const Address &pAddr) {
 
 		throw SocketException(errno, std::string("ClientSocket::connect() failed: ") + gai_strerror(errno));
 	}
+
+	//Connected, switch to non-blocking if requested
+	if(!blocking_)
+		applyBlocking();
 }
 
 /*!	@brief
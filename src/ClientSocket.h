@@ -62,6 +62,8 @@ public:
 	ClientSocket &operator=(ClientSocket &&other) noexcept;
 
 	/*!	@brief Connect to the specified endpoint address
+	 *	The connect itself always waits for the connection to be made, the
+	 *	blocking mode set with setBlocking() applies once it is connected.
 	 *	@param pAddr
 	 */
 	void connect(const Address& pAddr);
@@ -0,0 +1,331 @@
+/*!
+ *
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//Include once
+#ifndef COLUMNBATCH_H_INCLUDED
+#define COLUMNBATCH_H_INCLUDED
+
+//System includes
+#include <sys/types.h>
+#include <stdint.h>
+
+//Library includes
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+//Project includes
+#include "ByteOrder.h"
+#include "NetStream.h"
+#include "NetStreamView.h"
+#include "Schema.h"
+#include "StreamException.h"
+
+//Namespace container
+namespace Inet {
+
+/*!	@brief Array element type used to store a column of field values
+ *	Wider integers and floats are stored as themselves, 8-bit integers as
+ *	unsigned char and enumerations as their underlying integer.
+ */
+template<typename T, typename Enable = void>
+struct ColumnElement {
+	static_assert(std::is_arithmetic<T>::value,
+		"Columns must be integers, floats or enumerations");
+	typedef T type;
+};
+
+/*!	@brief 8-bit integer columns, including bool */
+template<typename T>
+struct ColumnElement<T, typename std::enable_if<std::is_integral<T>::value && sizeof(T) == 1>::type> {
+	typedef u_char type;
+};
+
+/*!	@brief Enumeration columns, as the underlying integer */
+template<typename T>
+struct ColumnElement<T, typename std::enable_if<std::is_enum<T>::value>::type> {
+	typedef typename ColumnElement<typename std::underlying_type<T>::type>::type type;
+};
+
+/*!	@brief Record set encoded column by column
+ *	Uses the same Field list as a Schema, for example
+ *		typedef ColumnBatch<Quote, Field<&Quote::id>, Field<&Quote::price>> QuoteBatch_t;
+ *	but instead of writing each record's fields together, a batch writes the
+ *	record count followed by one array value per field holding that field
+ *	from every record. Each column goes through the array encoding, so
+ *	integer columns of a compact stream are packed as varints.
+ *
+ *	The batch is embedded as a single STREAM value, so it can be skipped or
+ *	mixed with other values in either stream order. Inside it the columns
+ *	are always laid out first to last, and a reader asking for some columns
+ *	steps over the others in constant time using their lengths.
+ */
+template<typename Message, typename... Fields>
+class ColumnBatch {
+public:
+	/*!	@brief Number of columns in the batch */
+	static constexpr size_t columns = sizeof...(Fields);
+	static_assert(columns > 0, "A batch needs at least one column");
+
+	/*!	@brief Append a batch of records to the stream
+	 *	@param stream The stream to write to, its compact setting is used for
+	 *		the row count and integer columns
+	 *	@param msgs Pointer to the first record to encode
+	 *	@param count The number of records to encode
+	 *	@throw StreamException if the batch exceeds the 32-bit length limit
+	 */
+	static void encode(NetStream& stream, const Message* msgs, const size_t count) {
+		if(count > UINT32_MAX)
+			throw StreamException(STREAM_ERR_LENGTH, STREAM_MSG_LENGTH);
+
+		//Declare local
+		const NetStream::Order order = stream.order_;
+		const size_t overhead = sizeof(u_int32_t) + 2;
+
+		//Reserve for the whole batch, the columns then fit without growing
+		stream.reserve(stream.buffer_.size() + count * (Fields::size + ... + 0) + (columns + 1) * 16 + overhead);
+
+		//Marker, plus room for the length ahead of the payload in FIFO streams.
+		// The columns are written in place, always forward, as in a FIFO stream.
+		const size_t head = stream.buffer_.size();
+		stream.extend((order == NetStream::Order::FIFO) ? 1 + sizeof(u_int32_t) : 1)[0] = (char)NetStream::Type::STREAM;
+		const size_t start = stream.buffer_.size();
+		stream.order_ = NetStream::Order::FIFO;
+		try {
+			stream << (u_int32_t)count;
+			(store<Fields>(stream, msgs, count), ...);
+		}
+		catch(...) {
+			stream.order_ = order;
+			stream.buffer_.resize(head);
+			throw;
+		}
+		stream.order_ = order;
+
+		const size_t length = stream.buffer_.size() - start;
+		if(length > UINT32_MAX) {
+			stream.buffer_.resize(head);
+			throw StreamException(STREAM_ERR_LENGTH, STREAM_MSG_LENGTH);
+		}
+		const u_int32_t netlength = NetOrder((u_int32_t)length);
+
+		if(order == NetStream::Order::FIFO) {
+			memcpy(&stream.buffer_[start - sizeof(u_int32_t)], &netlength, sizeof(u_int32_t));
+			stream.extend(1)[0] = (char)NetStream::Type::STREAM;
+		}
+		else {
+			char* p = stream.extend(overhead - 1);
+			memcpy(p, &netlength, sizeof(u_int32_t));
+			p[sizeof(u_int32_t)] = (char)NetStream::Type::STREAM;
+		}
+	}
+
+	/*!	@brief Append a batch of records to the stream
+	 *	@param stream The stream to write to
+	 *	@param msgs The records to encode
+	 *	@throw StreamException if the batch exceeds the 32-bit length limit
+	 */
+	static void encode(NetStream& stream, const std::vector<Message>& msgs) {
+		encode(stream, msgs.data(), msgs.size());
+	}
+
+	/*!	@brief Decode every column of the next batch
+	 *	@param stream The stream to read from
+	 *	@param msgs Records to receive the decoded fields, resized to the
+	 *		number of records in the batch
+	 *	@throw StreamException if the batch is malformed, nothing is consumed
+	 *		and the records are unchanged
+	 */
+	static void decode(NetStream& stream, std::vector<Message>& msgs) {
+		decodeColumns<Fields...>(stream, msgs);
+	}
+
+	/*!	@brief Decode every column of the next batch from a view
+	 *	@param view The view to read from
+	 *	@param msgs Records to receive the decoded fields
+	 *	@throw StreamException if the batch is malformed, nothing is consumed
+	 *		and the records are unchanged
+	 */
+	static void decode(NetStreamView& view, std::vector<Message>& msgs) {
+		decodeColumns<Fields...>(view, msgs);
+	}
+
+	/*!	@brief Decode selected columns of the next batch
+	 *	Only the listed fields are written into the records, the others keep
+	 *	whatever value they had, or are value-initialized if the vector grows.
+	 *	@param stream The stream to read from
+	 *	@param msgs Records to receive the decoded fields, resized to the
+	 *		number of records in the batch
+	 *	@throw StreamException if the batch is malformed, nothing is consumed
+	 *		and the records are unchanged
+	 */
+	template<typename... Selected>
+	static void decodeColumns(NetStream& stream, std::vector<Message>& msgs) {
+		NetStreamView reader(stream);
+		decodeColumns<Selected...>(reader, msgs);
+		stream.commit(reader);
+	}
+
+	/*!	@brief Decode selected columns of the next batch from a view
+	 *	@param view The view to read from
+	 *	@param msgs Records to receive the decoded fields
+	 *	@throw StreamException if the batch is malformed, nothing is consumed
+	 *		and the records are unchanged
+	 */
+	template<typename... Selected>
+	static void decodeColumns(NetStreamView& view, std::vector<Message>& msgs) {
+		static_assert((contains<Selected>() && ...), "Selected field is not part of the batch");
+
+		//Declare local
+		NetStreamView reader(view);
+		NetStreamView batch(nullptr, 0, NetStream::Order::FIFO);
+		u_int32_t rows;
+
+		reader >> batch;
+		batch >> rows;
+
+		//Every row takes at least a byte in each column, checked before allocating
+		if((u_int64_t)rows * columns > batch.remaining())
+			throw StreamException(STREAM_ERR_INVALID_LENGTH, STREAM_MSG_INVALID_LENGTH);
+
+		//Decode into new records, only copying the old ones if some fields keep their value
+		std::vector<Message> decoded;
+		if constexpr(sizeof...(Selected) < columns)
+			decoded.assign(msgs.begin(), msgs.begin() + std::min<size_t>(rows, msgs.size()));
+		decoded.resize(rows);
+		(load<Fields, selects<Fields, Selected...>()>(batch, decoded), ...);
+
+		//Hand over the records and consume the batch only once every column has been read
+		msgs.swap(decoded);
+		view = reader;
+	}
+
+	/*!	@brief Decode a single column of the next batch without building records
+	 *	@param stream The stream to read from
+	 *	@param values Vector to receive the field from every record
+	 *	@throw StreamException if the batch is malformed, nothing is consumed
+	 */
+	template<typename Selected>
+	static void column(NetStream& stream, std::vector<typename Selected::Value_t>& values) {
+		NetStreamView reader(stream);
+		column<Selected>(reader, values);
+		stream.commit(reader);
+	}
+
+	/*!	@brief Decode a single column of the next batch from a view
+	 *	@param view The view to read from
+	 *	@param values Vector to receive the field from every record
+	 *	@throw StreamException if the batch is malformed, nothing is consumed
+	 */
+	template<typename Selected>
+	static void column(NetStreamView& view, std::vector<typename Selected::Value_t>& values) {
+		static_assert(contains<Selected>(), "Selected field is not part of the batch");
+		typedef typename Selected::Value_t Value_t;
+		typedef typename ColumnElement<Value_t>::type Element_t;
+
+		//Declare local
+		NetStreamView reader(view);
+		NetStreamView batch(nullptr, 0, NetStream::Order::FIFO);
+		u_int32_t rows;
+		bool found = false;
+
+		reader >> batch;
+		batch >> rows;
+
+		//Step over the columns ahead of the selected one
+		auto visit = [&](auto field) {
+			typedef decltype(field) Field_t;
+			if(found)
+				return;
+			if(!std::is_same<Field_t, Selected>::value) {
+				batch.skip();
+				return;
+			}
+
+			if constexpr(std::is_same<Value_t, Element_t>::value) {
+				batch >> values;
+			}
+			else {
+				std::vector<Element_t> elements;
+				batch >> elements;
+				values.resize(elements.size());
+				for(size_t i = 0; i < elements.size(); i++)
+					values[i] = (Value_t)elements[i];
+			}
+			found = true;
+		};
+		(visit(Fields()), ...);
+
+		if(values.size() != rows)
+			throw StreamException(STREAM_ERR_INVALID_LENGTH, STREAM_MSG_INVALID_LENGTH);
+
+		view = reader;
+	}
+
+private:
+	/*!	@brief Returns true if the field is one of the batch's columns */
+	template<typename Selected>
+	static constexpr bool contains() {
+		return (std::is_same<Fields, Selected>::value || ...);
+	}
+
+	/*!	@brief Returns true if the field is in the selected list */
+	template<typename F, typename... Selected>
+	static constexpr bool selects() {
+		return (std::is_same<F, Selected>::value || ...);
+	}
+
+	/*!	@brief Gather one field from every record and write it as an array */
+	template<typename F>
+	static void store(NetStream& batch, const Message* msgs, const size_t count) {
+		typedef typename ColumnElement<typename F::Value_t>::type Element_t;
+		static_assert(sizeof(Element_t) == sizeof(typename F::Value_t),
+			"Column elements must have the width of the field");
+
+		//The field's bytes are the element's, so it is read in place from each record
+		const char* base = (count > 0) ? (const char*)&(msgs[0].*F::member) : nullptr;
+		batch.template appendArray<Element_t>(base, sizeof(Message), count);
+	}
+
+	/*!	@brief Read one column into the records, or step over it */
+	template<typename F, bool Wanted>
+	static void load(NetStreamView& batch, std::vector<Message>& msgs) {
+		typedef typename F::Value_t Value_t;
+		typedef typename ColumnElement<Value_t>::type Element_t;
+
+		if constexpr(!Wanted) {
+			batch.skip();
+		}
+		else {
+			std::vector<Element_t> values;
+			batch >> values;
+			if(values.size() != msgs.size())
+				throw StreamException(STREAM_ERR_INVALID_LENGTH, STREAM_MSG_INVALID_LENGTH);
+			for(size_t i = 0; i < values.size(); i++)
+				msgs[i].*F::member = (Value_t)values[i];
+		}
+	}
+};
+
+} //Inet namespace
+
+#endif //COLUMNBATCH_H_INCLUDED
@@ -22,15 +22,24 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/un.h>
+#include <sys/uio.h>
+#include <poll.h>
+#include <netinet/in.h>
 #include <unistd.h>
 #include <errno.h>
+#include <string.h>
+#include <limits.h>
 
 //Library includes
+#include <algorithm>
 #include <utility>
 #include <exception>
+#include <vector>
 
 //Project includes
 #include "ConnectionEndpoint.h"
+#include "NetStream.h"
+#include "ByteOrder.h"
 
 //Namespace container
 namespace Inet {
@@ -67,6 +76,7 @@ ConnectionEndpoint& ConnectionEndpoint::operator=(ConnectionEndpoint&& other) no
 	if(this != &other) {
 		//Call base class move
 		AbstractSocket::operator=(std::move(other));
+		maxFrameSize_ = other.maxFrameSize_;
 	}
 
 	//Return self ref
@@ -76,25 +86,39 @@ ConnectionEndpoint& ConnectionEndpoint::operator=(ConnectionEndpoint&& other) no
 /*!	@brief Send data to the connected endpoint
  *	@param buf A pointer to the buffer containing data to send
  *	@param len The number of bytes to send
- *	@return The nubmer of bytes successfully sent
+ *	@return The number of bytes successfully sent, or WOULD_BLOCK
  *	@throws On error sending data
  */
 int ConnectionEndpoint::send(const char* buf, int len) {
 	//Declare locals
 	int bytes = 0;
-	bytes = ::send(socket_, buf, len, 0);
+
+	do {
+		bytes = ::send(socket_, buf, len, 0);
+	} while(bytes < 0 && errno == EINTR);
+
+	if(bytes < 0) {
+		if(errno == EAGAIN || errno == EWOULDBLOCK)
+			return WOULD_BLOCK;
+		throw SocketException(errno, std::string("Send error: ") + strerror(errno));
+	}
+
 	return bytes;
 }
 
-/*!	@brief
- *
+/*!	@brief Receive data from the connected endpoint
+ *	@param buf The buffer to receive into
+ *	@param len The largest number of bytes to receive
+ *	@return The number of bytes received, 0 when closed, or WOULD_BLOCK
  */
 int ConnectionEndpoint::receive(char *buf, int len) {
 	//Declare locals
 	int bytes = 0;
-	bytes = ::read(socket_, buf, len);
 
-	//TODO: Handle non-blocking condition when no data present
+	do {
+		bytes = ::read(socket_, buf, len);
+	} while(bytes < 0 && errno == EINTR);
+
 	if(bytes == 0) {
 		//Read 0 bytes on blocking socket means connection has been closed
 		if(blocking_) {
@@ -103,12 +127,172 @@ int ConnectionEndpoint::receive(char *buf, int len) {
 	}
 
 	if(bytes < 0) {
-		throw SocketException(errno, std::string("Recieve error: ") + gai_strerror(errno));
+		//Nothing waiting on a non-blocking socket is not an error
+		if(errno == EAGAIN || errno == EWOULDBLOCK)
+			return WOULD_BLOCK;
+		throw SocketException(errno, std::string("Recieve error: ") + strerror(errno));
 	}
 
 	return bytes;
 }
 
+/*!	@brief Send the unread contents of a stream as one frame
+ *	@param stream The stream to send, left unchanged
+ *	@return The number of payload bytes sent
+ *	@throw SocketException if the stream is too large or the send fails
+ */
+int ConnectionEndpoint::sendStream(const NetStream& stream) {
+	//Declare locals
+	const u_int32_t length = stream.remaining();
+	u_int32_t netlength = NetOrder(length);
+	const char* data = stream.data().data();
+	u_int32_t from = stream.offset();
+	struct iovec prefix[2];
+	std::vector<struct iovec> pieces;
+	struct iovec* iov = prefix;
+	size_t count = 2;
+	struct msghdr msg;
+
+	if(length > maxFrameSize_)
+		throw SocketException(EMSGSIZE, "Frame exceeds the maximum frame size");
+
+	//Length prefix and payload go out in the same call
+	prefix[0].iov_base = &netlength;
+	prefix[0].iov_len = sizeof(u_int32_t);
+	prefix[1].iov_base = (void*)(data + from);
+	prefix[1].iov_len = length;
+
+	//Borrowed payloads are gathered in place between the stream's own bytes
+	if(!stream.segments().empty()) {
+		pieces.reserve(2 * stream.segments().size() + 2);
+		pieces.push_back(prefix[0]);
+		for(const NetStream::Segment& segment : stream.segments()) {
+			if(segment.offset < from)
+				continue;
+			pieces.push_back({ (void*)(data + from), segment.offset - from });
+			pieces.push_back({ (void*)segment.data, segment.bytes });
+			from = segment.offset;
+		}
+		pieces.push_back({ (void*)(data + from), stream.data().size() - from });
+		iov = pieces.data();
+		count = pieces.size();
+	}
+
+	memset(&msg, 0, sizeof(msg));
+	while(count > 0) {
+		//Never pass more vectors than the kernel accepts in one call
+		msg.msg_iov = iov;
+		msg.msg_iovlen = std::min<size_t>(count, IOV_MAX);
+
+		//A closed peer is reported as EPIPE rather than raising SIGPIPE
+		ssize_t bytes = ::sendmsg(socket_, &msg, MSG_NOSIGNAL);
+		if(bytes < 0) {
+			if(errno == EINTR)
+				continue;
+			if(errno == EAGAIN || errno == EWOULDBLOCK) {
+				waitReady(POLLOUT);
+				continue;
+			}
+			throw SocketException(errno, std::string("Send error: ") + strerror(errno));
+		}
+
+		//Step over whatever was written, the rest goes out on the next call
+		while(count > 0 && (size_t)bytes >= iov->iov_len) {
+			bytes -= iov->iov_len;
+			iov++;
+			count--;
+		}
+		if(count > 0) {
+			iov->iov_base = (char*)iov->iov_base + bytes;
+			iov->iov_len -= bytes;
+		}
+	}
+
+	return length;
+}
+
+/*!	@brief Receive one frame directly into a stream
+ *	@param stream The stream to receive the frame
+ *	@return True if a frame was received, false if the peer closed first
+ *	@throw SocketException if the frame is too large, cut short or the
+ *		receive fails
+ */
+bool ConnectionEndpoint::receiveStream(NetStream& stream) {
+	//Declare locals
+	u_int32_t length = 0;
+	size_t bytes = 0;
+
+	try {
+		//An orderly close before the next frame starts is not an error
+		bytes = receiveAll((char*)&length, sizeof(u_int32_t));
+		if(bytes == 0) {
+			stream.prepareRaw(0);
+			return false;
+		}
+		if(bytes < sizeof(u_int32_t))
+			throw SocketException(-1, "Peer has closed connection");
+
+		length = NetOrder(length);
+		if(length > maxFrameSize_)
+			throw SocketException(EMSGSIZE, "Frame exceeds the maximum frame size");
+
+		//Read the payload straight into the stream's storage
+		if(receiveAll(stream.prepareRaw(length), length) < length)
+			throw SocketException(-1, "Peer has closed connection");
+	}
+	catch(...) {
+		//Never leave part of a frame behind for the caller to decode
+		stream.prepareRaw(0);
+		throw;
+	}
+	return true;
+}
+
+/*!	@brief Receive the requested number of bytes, or fewer if the peer closes
+ *	@param buf The buffer to fill
+ *	@param len The number of bytes to read
+ *	@return The number of bytes read, less than len if the peer has closed
+ *	@throw SocketException if the receive fails
+ */
+size_t ConnectionEndpoint::receiveAll(char* buf, size_t len) {
+	//Declare local
+	size_t total = 0;
+
+	//Read directly, a blocking receive() reports the close as an error
+	while(total < len) {
+		const ssize_t bytes = ::read(socket_, buf + total, len - total);
+		if(bytes < 0) {
+			if(errno == EINTR)
+				continue;
+			if(errno == EAGAIN || errno == EWOULDBLOCK) {
+				waitReady(POLLIN);
+				continue;
+			}
+			throw SocketException(errno, std::string("Recieve error: ") + strerror(errno));
+		}
+		if(bytes == 0)
+			break;
+		total += bytes;
+	}
+	return total;
+}
+
+/*!	@brief Wait until a non-blocking socket is ready
+ *	@param events POLLIN or POLLOUT
+ */
+void ConnectionEndpoint::waitReady(const short events) {
+	//Declare local
+	struct pollfd pfd;
+
+	pfd.fd = socket_;
+	pfd.events = events;
+	pfd.revents = 0;
+	while(::poll(&pfd, 1, -1) < 0) {
+		if(errno != EINTR)
+			throw SocketException(errno, std::string("Poll error: ") + strerror(errno));
+	}
+}
+
 /*!	@brief
  *
  */
@@ -36,14 +36,25 @@
 //Namespace container
 namespace Inet {
 
-//Required for server socket friend relationship
+//Required for server socket and I/O engine friend relationships
 class ServerSocket;
+class IoEngine;
+
+//Framed message type, see NetStream.h
+class NetStream;
+
+///Default limit on the payload of a single NetStream frame
+const u_int32_t DEFAULT_MAX_FRAME_SIZE = 16 * 1024 * 1024;
+
+///Returned by send() and receive() on a non-blocking socket that is not ready
+const int WOULD_BLOCK = -1;
 
 /*	@brief
  *	@author James.A.Cleland@gmail.com
  */
 class ConnectionEndpoint : public AbstractSocket {
 	friend ServerSocket;
+	friend IoEngine;
 
 protected:
 	ConnectionEndpoint(socket_t sock, const SockAddrInPtr_t pAddr, int addrLen);
@@ -71,17 +82,63 @@ public:
 	ConnectionEndpoint& operator=(ConnectionEndpoint &&other) noexcept;
 
 	/*!	@brief Send data to the connected peer
-	 *	@todo This method is a placeholder, meant to behave in a manner
-	 *				identical to the runtime library equivilent.
+	 *	A non-blocking socket may accept only part of the data, in which case
+	 *	the caller sends the rest once the socket is writable again.
+	 *	@param buf A pointer to the data to send
+	 *	@param len The number of bytes to send
+	 *	@return The number of bytes sent, or WOULD_BLOCK if a non-blocking
+	 *		socket has no room for any of them
+	 *	@throw SocketException if the send fails
 	 */
 	virtual int send(const char* buf, int len);
 
 	/*!	@brief Receive data from the connected peer
-	 *	@todo This method is a placeholder, meant to behave in a manner
-	 *				identical to the runtime library equivilent.
+	 *	@param buf The buffer to receive into
+	 *	@param len The largest number of bytes to receive
+	 *	@return The number of bytes received, 0 if a non-blocking socket's
+	 *		peer has closed the connection, or WOULD_BLOCK if a non-blocking
+	 *		socket has no data waiting
+	 *	@throw SocketException if the receive fails, or a blocking socket's
+	 *		peer has closed the connection
 	 */
 	virtual int receive(char *buf, int len);
 
+	/*!	@brief Send the unread contents of a stream as one frame
+	 *	The frame is a 4-byte length in network byte order followed by the
+	 *	stream data, written together with a single gather call. Payloads
+	 *	the stream borrows are gathered from the caller's memory without
+	 *	being copied. Partial writes are continued until the whole frame has
+	 *	been sent, waiting for the socket to become writable if it is in
+	 *	non-blocking mode.
+	 *	@param stream The stream to send, left unchanged
+	 *	@return The number of payload bytes sent
+	 *	@throw SocketException if the stream exceeds the maximum frame size
+	 *		or the send fails
+	 */
+	virtual int sendStream(const NetStream& stream);
+
+	/*!	@brief Receive one frame directly into a stream
+	 *	The stream's contents are replaced by the frame payload, which is read
+	 *	into the stream's own storage. The stream keeps its order setting.
+	 *	Waits for the whole frame, in non-blocking mode too. The stream is
+	 *	left empty if the peer closes or the receive throws.
+	 *	@param stream The stream to receive the frame
+	 *	@return True if a frame was received, false if the peer closed the
+	 *		connection cleanly before the next frame began
+	 *	@throw SocketException if the frame exceeds the maximum frame size,
+	 *		in which case the connection can no longer be used, or the
+	 *		peer closes the connection mid-frame
+	 */
+	virtual bool receiveStream(NetStream& stream);
+
+	/*!	@brief Returns the largest frame payload sent or accepted */
+	inline u_int32_t maxFrameSize() const { return maxFrameSize_; }
+
+	/*!	@brief Set the largest frame payload sent or accepted
+	 *	@param bytes The limit in bytes
+	 */
+	inline void setMaxFrameSize(const u_int32_t bytes) { maxFrameSize_ = bytes; }
+
 	/*!	@brief Closes the connection
 	 */
 	virtual void close();
@@ -92,9 +149,21 @@ protected:
 	 */
 	bool closed();
 
+	/*!	@brief Receive the requested number of bytes, or fewer if the peer closes
+	 *	@param buf The buffer to fill
+	 *	@param len The number of bytes to read
+	 *	@return The number of bytes read, less than len if the peer has closed
+	 */
+	size_t receiveAll(char* buf, size_t len);
+
+	/*!	@brief Wait until a non-blocking socket is ready
+	 *	@param events POLLIN or POLLOUT
+	 */
+	void waitReady(const short events);
+
 protected:
 	SockAddrIn_t		peerAddress_;
-	bool						blocking_ = true;
+	u_int32_t				maxFrameSize_ = DEFAULT_MAX_FRAME_SIZE;
 };
 
 }; //Inet namespace
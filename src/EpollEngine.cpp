@@ -0,0 +1,233 @@
+/*!
+ *
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//System includes
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <poll.h>
+#include <errno.h>
+#include <string.h>
+
+//Library includes
+#include <utility>
+
+//Project includes
+#include "EpollEngine.h"
+
+//Namespace container
+namespace Inet {
+
+/*!	@brief Construct the engine
+ *	@param entries Ready sockets handled per wait
+ */
+EpollEngine::EpollEngine(const unsigned entries) :
+	loop_(entries)
+{
+}
+
+/*!	@brief Destructor */
+EpollEngine::~EpollEngine() {
+}
+
+/*!	@brief Queue an accept on a listening socket
+ *	@param sock The listening socket
+ *	@param done Called with the result and client
+ */
+void EpollEngine::accept(const AbstractSocket& sock, AcceptCompletion_t done) {
+	queue(sock, Op{ Type::ACCEPT, nullptr, 0, nullptr, std::move(done) });
+}
+
+/*!	@brief Queue a receive
+ *	@param sock The connected socket
+ *	@param buf Buffer to receive into
+ *	@param len The largest number of bytes to receive
+ *	@param done Called with the result
+ */
+void EpollEngine::receive(const AbstractSocket& sock, char* buf, const size_t len, Completion_t done) {
+	queue(sock, Op{ Type::RECEIVE, buf, len, std::move(done), nullptr });
+}
+
+/*!	@brief Queue a send
+ *	@param sock The connected socket
+ *	@param buf The data to send
+ *	@param len The number of bytes to send
+ *	@param done Called with the result
+ */
+void EpollEngine::send(const AbstractSocket& sock, const char* buf, const size_t len, Completion_t done) {
+	queue(sock, Op{ Type::SEND, (char*)buf, len, std::move(done), nullptr });
+}
+
+/*!	@brief Cancel the pending operations of a socket and forget it
+ *	@param sock The socket whose operations are cancelled
+ */
+void EpollEngine::cancel(const AbstractSocket& sock) {
+	auto it = watches_.find(sock.handle());
+	if(it == watches_.end())
+		return;
+
+	//Completions are delivered by the next poll, like any other
+	Watch& watch = *it->second;
+	for(std::deque<Op>* ops : { &watch.reads, &watch.writes }) {
+		for(Op& op : *ops)
+			results_.push_back(Result{ std::move(op), -ECANCELED, {}, 0 });
+		ops->clear();
+	}
+
+	loop_.remove(sock);
+	retired_.push_back(std::move(it->second));
+	watches_.erase(it);
+}
+
+/*!	@brief Try queued operations and dispatch completions
+ *	@param timeout Milliseconds to wait for a socket to become ready
+ *	@return The number of completion callbacks called
+ */
+size_t EpollEngine::poll(const int timeout) {
+	//Declare local
+	size_t dispatched = drain();
+
+	//Wait only when nothing could be completed straight away
+	if(dispatched == 0 && pending_ > 0) {
+		loop_.poll(timeout);
+		dispatched = drain();
+	}
+
+	retired_.clear();
+	return dispatched;
+}
+
+/*!	@brief Queue an operation and try it on the next poll
+ *	@param sock The socket to operate on
+ *	@param op The operation
+ */
+void EpollEngine::queue(const AbstractSocket& sock, Op&& op) {
+	//Declare local
+	const socket_t handle = sock.handle();
+
+	auto it = watches_.find(handle);
+	if(it == watches_.end()) {
+		//Readiness only marks the socket to be tried again, its mode is left alone
+		loop_.watch(handle, EventLoop::READ | EventLoop::WRITE, [this, handle](u_int32_t) {
+			ready_.push_back(handle);
+		});
+		it = watches_.emplace(handle, std::unique_ptr<Watch>(new Watch{ handle, sock.blocking(), {}, {} })).first;
+	}
+
+	if(op.type == Type::SEND)
+		it->second->writes.push_back(std::move(op));
+	else
+		it->second->reads.push_back(std::move(op));
+	ready_.push_back(handle);
+	pending_++;
+}
+
+/*!	@brief Run the socket's queued operations until one would block
+ *	@param watch The socket
+ *	@param ops Its reads or writes
+ */
+void EpollEngine::service(Watch& watch, std::deque<Op>& ops) {
+	while(!ops.empty()) {
+		//Declare local
+		Op& op = ops.front();
+		SockAddrIn_t address;
+		socklen_t addrLen = sizeof(address);
+		ssize_t result;
+
+		switch(op.type) {
+			case Type::ACCEPT:
+				//accept() has no per-call flag, so a blocking listener is checked first
+				if(watch.blocking && !waiting(watch.handle))
+					return;
+				result = ::accept4(watch.handle, (SockAddrPtr_t)&address, &addrLen, SOCK_CLOEXEC);
+				break;
+			case Type::RECEIVE:
+				result = ::recv(watch.handle, op.buf, op.len, MSG_DONTWAIT);
+				break;
+			default:
+				result = ::send(watch.handle, op.buf, op.len, MSG_NOSIGNAL | MSG_DONTWAIT);
+				break;
+		}
+
+		if(result < 0) {
+			if(errno == EINTR)
+				continue;
+			//Wait for the next readiness edge
+			if(errno == EAGAIN || errno == EWOULDBLOCK)
+				return;
+			result = -errno;
+		}
+
+		results_.push_back(Result{ std::move(op), (int)result, address, (int)addrLen });
+		ops.pop_front();
+	}
+}
+
+/*!	@brief Returns true if a connection is waiting on a listening socket
+ *	@param handle The listening socket
+ */
+bool EpollEngine::waiting(const socket_t handle) {
+	//Declare local
+	struct pollfd check = { handle, POLLIN, 0 };
+	int ready;
+
+	//Errors are left for accept() to report
+	while((ready = ::poll(&check, 1, 0)) < 0 && errno == EINTR);
+	return ready != 0;
+}
+
+/*!	@brief Service ready sockets and call callbacks until nothing is left
+ *	@return The number of completion callbacks called
+ */
+size_t EpollEngine::drain() {
+	//Declare local
+	size_t dispatched = 0;
+	std::vector<socket_t> ready;
+	std::vector<Result> results;
+
+	while(!ready_.empty() || !results_.empty()) {
+		ready.swap(ready_);
+		for(socket_t handle : ready) {
+			auto it = watches_.find(handle);
+			if(it == watches_.end())
+				continue;
+			service(*it->second, it->second->reads);
+			service(*it->second, it->second->writes);
+		}
+		ready.clear();
+
+		//Callbacks may queue more work, picked up on the next pass
+		results.swap(results_);
+		for(Result& result : results) {
+			pending_--;
+			dispatched++;
+			if(result.op.type != Type::ACCEPT)
+				result.op.done(result.result);
+			else if(result.result < 0)
+				result.op.accepted(result.result, ConnectionEndpoint());
+			else
+				result.op.accepted(0, endpoint(result.result, result.address, result.addrLen));
+		}
+		results.clear();
+	}
+
+	return dispatched;
+}
+
+} //Inet namespace
@@ -0,0 +1,129 @@
+/*!
+ *
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//Include once
+#ifndef EPOLLENGINE_H_INCLUDED
+#define EPOLLENGINE_H_INCLUDED
+
+//System includes
+#include <sys/types.h>
+
+//Library includes
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+//Project includes
+#include "IoEngine.h"
+#include "EventLoop.h"
+
+//Namespace container
+namespace Inet {
+
+/*!	@brief Readiness-based engine for kernels without io_uring
+ *	Each operation is tried straight away with a non-blocking call, and if
+ *	the socket would block it waits in an EventLoop until the socket is
+ *	ready. Operations on one socket complete in the order they were queued.
+ *
+ *	Like the io_uring engine, it leaves the mode of the sockets alone and
+ *	works with blocking and non-blocking sockets alike. Receives and sends
+ *	use MSG_DONTWAIT, and accepts on a blocking listener first check that
+ *	a connection is waiting. A blocking listener shared with another
+ *	acceptor can still stall poll() if that acceptor takes the connection
+ *	in between, so put shared listeners in non-blocking mode.
+ *	Registered buffers and sockets are accepted but make no difference.
+ */
+class EpollEngine : public IoEngine {
+public:
+	/*!	@brief Construct the engine
+	 *	@param entries Ready sockets handled per wait
+	 *	@throw SocketException if the epoll instance cannot be created
+	 */
+	explicit EpollEngine(const unsigned entries = 256);
+
+	/*!	@brief Destructor */
+	virtual ~EpollEngine();
+
+	virtual const char* name() const { return "epoll"; }
+	virtual void accept(const AbstractSocket& sock, AcceptCompletion_t done);
+	virtual void receive(const AbstractSocket& sock, char* buf, const size_t len, Completion_t done);
+	virtual void send(const AbstractSocket& sock, const char* buf, const size_t len, Completion_t done);
+	virtual void cancel(const AbstractSocket& sock);
+	virtual size_t poll(const int timeout = -1);
+	virtual size_t pending() const { return pending_; }
+
+protected:
+	///Operation kinds
+	enum class Type {
+		ACCEPT,
+		RECEIVE,
+		SEND
+	};
+
+	/*!	@brief Queued operation */
+	struct Op {
+		Type								type;
+		char*								buf;				///< Data to receive into or send
+		size_t							len;				///< Bytes to transfer
+		Completion_t				done;				///< Receive and send completion
+		AcceptCompletion_t	accepted;		///< Accept completion
+	};
+
+	/*!	@brief Operations queued on one socket */
+	struct Watch {
+		socket_t						handle;
+		bool								blocking;		///< Accepts must check for a waiting connection
+		std::deque<Op>			reads;			///< Accepts and receives, in order
+		std::deque<Op>			writes;			///< Sends, in order
+	};
+
+	/*!	@brief Finished operation waiting for its callback */
+	struct Result {
+		Op									op;
+		int									result;
+		SockAddrIn_t				address;
+		int									addrLen;
+	};
+
+	/*!	@brief Queue an operation and try it on the next poll */
+	void queue(const AbstractSocket& sock, Op&& op);
+
+	/*!	@brief Run the socket's queued operations until one would block */
+	void service(Watch& watch, std::deque<Op>& ops);
+
+	/*!	@brief Returns true if a connection is waiting on a listening socket */
+	static bool waiting(const socket_t handle);
+
+	/*!	@brief Service ready sockets and call callbacks until nothing is left */
+	size_t drain();
+
+private:
+	EventLoop																	loop_;
+	std::unordered_map<socket_t, std::unique_ptr<Watch>>	watches_;
+	std::vector<std::unique_ptr<Watch>>				retired_;	///< Cancelled, freed after dispatch
+	std::vector<socket_t>											ready_;		///< Sockets to try
+	std::vector<Result>												results_;	///< Completions to dispatch
+	size_t																		pending_ = 0;
+};
+
+} //Inet namespace
+
+#endif //EPOLLENGINE_H_INCLUDED
@@ -0,0 +1,232 @@
+/*!
+ *
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//System includes
+#include <sys/types.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+
+//Library includes
+#include <string>
+#include <utility>
+
+//Project includes
+#include "EventLoop.h"
+#include "SocketException.h"
+
+//Namespace container
+namespace Inet {
+
+/*!	@brief Construct an empty loop
+ *	@param maxEvents The largest number of ready sockets handled per wait
+ */
+EventLoop::EventLoop(const size_t maxEvents) :
+	epoll_(-1), wakeup_(-1), stopped_(false), events_(maxEvents > 0 ? maxEvents : 1)
+{
+	//Declare local
+	struct epoll_event event;
+
+	epoll_ = ::epoll_create1(EPOLL_CLOEXEC);
+	if(epoll_ < 0)
+		throw SocketException(errno, std::string("Error creating epoll instance: ") + strerror(errno));
+
+	//Wakeup descriptor lets stop() interrupt a wait from another thread
+	wakeup_ = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+	if(wakeup_ < 0) {
+		const int error = errno;
+		::close(epoll_);
+		throw SocketException(error, std::string("Error creating wakeup event: ") + strerror(error));
+	}
+
+	memset(&event, 0, sizeof(event));
+	event.events = EPOLLIN;
+	event.data.ptr = nullptr;
+	if(::epoll_ctl(epoll_, EPOLL_CTL_ADD, wakeup_, &event) < 0) {
+		const int error = errno;
+		::close(wakeup_);
+		::close(epoll_);
+		throw SocketException(error, std::string("Error watching wakeup event: ") + strerror(error));
+	}
+}
+
+/*!	@brief Destructor */
+EventLoop::~EventLoop() {
+	::close(wakeup_);
+	::close(epoll_);
+}
+
+/*!	@brief Register a socket
+ *	@param sock The socket to watch
+ *	@param events The events to watch for
+ *	@param callback Called with the events that occurred
+ */
+void EventLoop::add(const AbstractSocket& sock, const u_int32_t events, Callback_t callback) {
+	//Declare local
+	const socket_t handle = sock.handle();
+
+	if(registrations_.count(handle) > 0)
+		throw SocketException(EEXIST, "Socket is already registered with the event loop");
+
+	//Edge-triggered readiness requires callbacks to drain without blocking
+	if(sock.blocking())
+		throw SocketException(EINVAL, "Socket must be in non-blocking mode to be registered");
+
+	watch(handle, events, std::move(callback));
+}
+
+/*!	@brief Change the events watched for on a registered socket
+ *	@param sock The registered socket
+ *	@param events The events to watch for
+ */
+void EventLoop::modify(const AbstractSocket& sock, const u_int32_t events) {
+	//Declare local
+	struct epoll_event event;
+
+	auto it = registrations_.find(sock.handle());
+	if(it == registrations_.end())
+		throw SocketException(ENOENT, "Socket is not registered with the event loop");
+
+	memset(&event, 0, sizeof(event));
+	event.events = mask(events);
+	event.data.ptr = it->second.get();
+	if(::epoll_ctl(epoll_, EPOLL_CTL_MOD, it->first, &event) < 0)
+		throw SocketException(errno, std::string("Error modifying socket events: ") + strerror(errno));
+}
+
+/*!	@brief Stop watching a socket
+ *	@param sock The socket to remove
+ */
+void EventLoop::remove(const AbstractSocket& sock) {
+	auto it = registrations_.find(sock.handle());
+	if(it == registrations_.end())
+		return;
+
+	::epoll_ctl(epoll_, EPOLL_CTL_DEL, it->first, nullptr);
+
+	//Events already returned for it may still be waiting to be dispatched
+	it->second->handle = INVALID_SOCKET;
+	retired_.push_back(std::move(it->second));
+	registrations_.erase(it);
+}
+
+/*!	@brief Wait once for ready sockets and call their callbacks
+ *	@param timeout Milliseconds to wait
+ *	@return The number of callbacks called
+ */
+size_t EventLoop::poll(const int timeout) {
+	//Declare local
+	size_t dispatched = 0;
+
+	const int ready = ::epoll_wait(epoll_, events_.data(), events_.size(), timeout);
+	if(ready < 0) {
+		if(errno == EINTR)
+			return 0;
+		throw SocketException(errno, std::string("Error waiting for events: ") + strerror(errno));
+	}
+
+	try {
+		for(int i = 0; i < ready; i++) {
+			Registration* registration = (Registration*)events_[i].data.ptr;
+			if(registration == nullptr) {
+				drainWakeup();
+				continue;
+			}
+
+			//Skip sockets removed by an earlier callback in this batch
+			if(registration->handle == INVALID_SOCKET)
+				continue;
+			registration->callback(events_[i].events);
+			dispatched++;
+		}
+	}
+	catch(...) {
+		retired_.clear();
+		throw;
+	}
+
+	//Nothing refers to removed registrations once the batch is done
+	retired_.clear();
+	return dispatched;
+}
+
+/*!	@brief Dispatch events until stop() is called */
+void EventLoop::run() {
+	while(!stopped())
+		poll(-1);
+
+	//Ready for the next run
+	stopped_.store(false, std::memory_order_release);
+}
+
+/*!	@brief Make run() return after the current dispatch */
+void EventLoop::stop() {
+	//Declare local
+	const u_int64_t one = 1;
+
+	stopped_.store(true, std::memory_order_release);
+	if(::write(wakeup_, &one, sizeof(one)) < 0) {
+		//Counter already non-zero, the loop is woken regardless
+	}
+}
+
+/*!	@brief Watch a descriptor without checking or changing its mode
+ *	@param handle The descriptor to watch
+ *	@param events The events to watch for
+ *	@param callback Called with the events that occurred
+ */
+void EventLoop::watch(const socket_t handle, const u_int32_t events, Callback_t callback) {
+	//Declare local
+	struct epoll_event event;
+
+	if(registrations_.count(handle) > 0)
+		throw SocketException(EEXIST, "Socket is already registered with the event loop");
+
+	std::unique_ptr<Registration> registration(new Registration{ handle, std::move(callback) });
+	memset(&event, 0, sizeof(event));
+	event.events = mask(events);
+	event.data.ptr = registration.get();
+	if(::epoll_ctl(epoll_, EPOLL_CTL_ADD, handle, &event) < 0)
+		throw SocketException(errno, std::string("Error registering socket: ") + strerror(errno));
+
+	registrations_.emplace(handle, std::move(registration));
+}
+
+/*!	@brief Returns the epoll event mask for the requested events
+ *	@param events READ and/or WRITE
+ *	@return Edge-triggered epoll mask
+ */
+u_int32_t EventLoop::mask(const u_int32_t events) {
+	return (events & (READ | WRITE)) | EPOLLRDHUP | EPOLLET;
+}
+
+/*!	@brief Consume the wakeup written by stop() */
+void EventLoop::drainWakeup() {
+	//Declare local
+	u_int64_t count;
+
+	if(::read(wakeup_, &count, sizeof(count)) < 0) {
+		//Already drained
+	}
+}
+
+} //Inet namespace
@@ -0,0 +1,169 @@
+/*!
+ *
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//Include once
+#ifndef EVENTLOOP_H_INCLUDED
+#define EVENTLOOP_H_INCLUDED
+
+//System includes
+#include <sys/types.h>
+#include <sys/epoll.h>
+
+//Library includes
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+//Project includes
+#include "AbstractSocket.h"
+
+//Namespace container
+namespace Inet {
+
+/*!	@brief Reactor dispatching socket readiness to callbacks
+ *	Listeners and endpoints are registered with the events they are
+ *	interested in and a callback. A single thread calling run() or poll()
+ *	waits on every registered socket at once with epoll and calls the
+ *	callback of each socket that became ready, so one thread can serve tens
+ *	of thousands of connections.
+ *
+ *	Readiness is edge-triggered: a callback is only called again once new
+ *	data arrives or more buffer space frees up, so it must read, write or
+ *	accept until the socket reports it would block. Sockets must therefore
+ *	be put in non-blocking mode with setBlocking(false) before they are
+ *	registered, and the loop never changes their mode itself.
+ *
+ *	Apart from stop(), the loop is not thread safe and must only be used
+ *	from the thread running it. Callbacks may add, modify and remove any
+ *	registration, including their own, and may close the socket after
+ *	removing it.
+ */
+class EventLoop {
+	//The I/O engine watches sockets whose mode belongs to the caller
+	friend class EpollEngine;
+
+public:
+	///Readiness events, combined as a bit mask
+	static constexpr u_int32_t READ = EPOLLIN;							///< Data or a connection is waiting
+	static constexpr u_int32_t WRITE = EPOLLOUT;						///< Send buffer space is available
+	static constexpr u_int32_t HANGUP = EPOLLRDHUP | EPOLLHUP;	///< The peer closed its side
+	static constexpr u_int32_t ERROR = EPOLLERR;						///< The socket has a pending error
+
+	///Typedefs local to class
+	typedef std::function<void(u_int32_t events)>		Callback_t;
+
+	/*!	@brief Construct an empty loop
+	 *	@param maxEvents The largest number of ready sockets handled per wait
+	 *	@throw SocketException if the epoll instance cannot be created
+	 */
+	explicit EventLoop(const size_t maxEvents = 1024);
+
+	/*!	@brief Copy constructor, delete default */
+	EventLoop(const EventLoop& other) = delete;
+
+	/*!	@brief Assignment operator, delete default */
+	EventLoop& operator=(const EventLoop& other) = delete;
+
+	/*!	@brief Destructor, closes the epoll instance but not the sockets */
+	virtual ~EventLoop();
+
+	/*!	@brief Register a socket
+	 *	HANGUP and ERROR are always reported, whether requested or not.
+	 *	@param sock The socket to watch, which must outlive its registration
+	 *	@param events The events to watch for, READ and/or WRITE
+	 *	@param callback Called with the events that occurred
+	 *	@throw SocketException if the socket is blocking, already registered
+	 *		or invalid
+	 */
+	void add(const AbstractSocket& sock, const u_int32_t events, Callback_t callback);
+
+	/*!	@brief Change the events watched for on a registered socket
+	 *	@param sock The registered socket
+	 *	@param events The events to watch for, replacing the current ones
+	 *	@throw SocketException if the socket is not registered
+	 */
+	void modify(const AbstractSocket& sock, const u_int32_t events);
+
+	/*!	@brief Stop watching a socket
+	 *	Does nothing if the socket is not registered. Must be called before
+	 *	the socket is closed, since its descriptor may be reused.
+	 *	@param sock The socket to remove
+	 */
+	void remove(const AbstractSocket& sock);
+
+	/*!	@brief Wait once for ready sockets and call their callbacks
+	 *	@param timeout Milliseconds to wait, 0 to return immediately or -1
+	 *		to wait until a socket is ready or stop() is called
+	 *	@return The number of callbacks called
+	 *	@throw SocketException if the wait fails, or whatever a callback throws
+	 */
+	size_t poll(const int timeout = -1);
+
+	/*!	@brief Dispatch events until stop() is called */
+	void run();
+
+	/*!	@brief Make run() return after the current dispatch
+	 *	Safe to call from any thread, including from a callback. Calling it
+	 *	before run() starts makes run() return straight away.
+	 */
+	void stop();
+
+	/*!	@brief Returns true if stop() has been called and run() has not yet returned */
+	inline bool stopped() const { return stopped_.load(std::memory_order_acquire); }
+
+	/*!	@brief Returns the number of registered sockets */
+	inline size_t size() const { return registrations_.size(); }
+
+protected:
+	/*!	@brief Watched socket, at a stable address referenced by epoll */
+	struct Registration {
+		socket_t		handle;			///< Descriptor, INVALID_SOCKET once removed
+		Callback_t	callback;		///< Called with the ready events
+	};
+
+	/*!	@brief Watch a descriptor without checking or changing its mode
+	 *	Only for callbacks that never read or write the socket themselves.
+	 *	@param handle The descriptor to watch
+	 *	@param events The events to watch for, READ and/or WRITE
+	 *	@param callback Called with the events that occurred
+	 *	@throw SocketException if the descriptor is already registered or invalid
+	 */
+	void watch(const socket_t handle, const u_int32_t events, Callback_t callback);
+
+	/*!	@brief Returns the epoll event mask for the requested events */
+	static u_int32_t mask(const u_int32_t events);
+
+	/*!	@brief Consume the wakeup written by stop() */
+	void drainWakeup();
+
+private:
+	int															epoll_;				///< epoll instance
+	int															wakeup_;			///< eventfd written by stop()
+	std::atomic<bool>								stopped_;
+	std::vector<struct epoll_event>	events_;			///< Ready list filled by each wait
+	std::unordered_map<socket_t, std::unique_ptr<Registration>>		registrations_;
+	std::vector<std::unique_ptr<Registration>>									retired_;
+};
+
+} //Inet namespace
+
+#endif //EVENTLOOP_H_INCLUDED
@@ -0,0 +1,254 @@
+/*!
+ *
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//System includes
+#include <sys/types.h>
+
+//Library includes
+#include <utility>
+
+//Project includes
+#include "Executor.h"
+#include "Affinity.h"
+
+//Namespace container
+namespace Inet {
+
+/*!	@brief Pool and index of the worker running the current thread */
+struct CurrentWorker {
+	const Executor*		owner = nullptr;
+	size_t						index = Executor::ANY;
+};
+static thread_local CurrentWorker currentWorker;
+
+/*!	@brief Start the workers
+ *	@param workers Number of worker threads, 0 for one per allowed core
+ *	@param pin True to pin each worker thread to a core
+ */
+Executor::Executor(const size_t workers, const bool pin) :
+	queued_(0), unfinished_(0), next_(0), submitted_(0), executed_(0), stolen_(0),
+	stopping_(false)
+{
+	//Declare local
+	const std::vector<int> cores = pin ? AllowedCpus() : std::vector<int>();
+	const size_t count = workers > 0 ? workers : (pin ? cores.size() : AllowedCpus().size());
+
+	//Every deque exists before any worker starts looking for work to steal
+	for(size_t i = 0; i < count; i++)
+		workers_.emplace_back(new Worker());
+
+	for(size_t i = 0; i < workers_.size(); i++) {
+		Worker& worker = *workers_[i];
+		worker.thread = std::thread(&Executor::work, this, i);
+
+		//Left unpinned if the core can't be used, e.g. restricted by a cgroup
+		if(!cores.empty() && PinThread(worker.thread, cores[i % cores.size()]))
+			worker.cpu = cores[i % cores.size()];
+	}
+}
+
+/*!	@brief Destructor */
+Executor::~Executor() {
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stopping_ = true;
+	}
+	wakeup_.notify_all();
+
+	for(auto& worker : workers_)
+		worker->thread.join();
+}
+
+/*!	@brief Queue a task
+ *	@param task The task to run
+ *	@param affinity Worker to queue on, or ANY
+ */
+void Executor::submit(Task_t task, const size_t affinity) {
+	enqueue(Job{ std::move(task), nullptr, NetStream() }, affinity);
+}
+
+/*!	@brief Queue a decoded message for a handler
+ *	@param message The message to hand over
+ *	@param handler Called with the message on a worker thread
+ *	@param affinity Worker to queue on, or ANY
+ */
+void Executor::post(NetStream&& message, MessageHandler_t handler, const size_t affinity) {
+	enqueue(Job{ nullptr, std::move(handler), std::move(message) }, affinity);
+}
+
+/*!	@brief Queue a job on a worker's deque and wake a worker
+ *	@param job The job to queue
+ *	@param affinity Worker to queue on, or ANY
+ */
+void Executor::enqueue(Job&& job, const size_t affinity) {
+	//Declare local
+	size_t index = affinity;
+
+	if(index == ANY)
+		index = currentWorker.owner == this ? currentWorker.index : next_.fetch_add(1, std::memory_order_relaxed);
+	Worker& worker = *workers_[index % workers_.size()];
+
+	//Counted as unfinished before any worker can pick it up
+	unfinished_.fetch_add(1, std::memory_order_acq_rel);
+	submitted_.fetch_add(1, std::memory_order_relaxed);
+	{
+		std::lock_guard<std::mutex> lock(worker.mutex);
+		worker.tasks.push_back(std::move(job));
+	}
+	queued_.fetch_add(1, std::memory_order_release);
+
+	//Taking the lock orders this with a worker checking queued_ before it sleeps
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+	}
+	wakeup_.notify_one();
+}
+
+/*!	@brief Wait until every queued task has run */
+void Executor::wait() {
+	//Declare local
+	std::exception_ptr error;
+
+	{
+		std::unique_lock<std::mutex> lock(mutex_);
+		finished_.wait(lock, [this]() { return unfinished_.load(std::memory_order_acquire) == 0; });
+		std::swap(error, error_);
+	}
+
+	if(error)
+		std::rethrow_exception(error);
+}
+
+/*!	@brief Returns the worker running the calling thread */
+size_t Executor::current() const {
+	return currentWorker.owner == this ? currentWorker.index : ANY;
+}
+
+/*!	@brief Returns the core a worker is pinned to
+ *	@param worker Index of the worker
+ */
+int Executor::cpu(const size_t worker) const {
+	return worker < workers_.size() ? workers_[worker]->cpu : -1;
+}
+
+/*!	@brief Returns a snapshot of the executor counters */
+Executor::Stats Executor::stats() const {
+	//Declare local
+	Stats stats;
+
+	stats.submitted = submitted_.load(std::memory_order_relaxed);
+	stats.executed = executed_.load(std::memory_order_relaxed);
+	stats.stolen = stolen_.load(std::memory_order_relaxed);
+	return stats;
+}
+
+/*!	@brief Take the oldest job from a worker's own deque
+ *	@param index Index of the worker
+ *	@param job Receives the job
+ *	@return True if a job was taken
+ */
+bool Executor::popLocal(const size_t index, Job& job) {
+	//Declare local
+	Worker& worker = *workers_[index];
+	std::lock_guard<std::mutex> lock(worker.mutex);
+
+	if(worker.tasks.empty())
+		return false;
+
+	job = std::move(worker.tasks.front());
+	worker.tasks.pop_front();
+	queued_.fetch_sub(1, std::memory_order_relaxed);
+	return true;
+}
+
+/*!	@brief Take the newest job from another worker's deque
+ *	The owner works from the other end, so the two rarely want the same job.
+ *	@param index Index of the stealing worker
+ *	@param job Receives the job
+ *	@return True if a job was stolen
+ */
+bool Executor::steal(const size_t index, Job& job) {
+	//Start with the next worker along so thieves spread over their victims
+	for(size_t i = 1; i < workers_.size(); i++) {
+		Worker& victim = *workers_[(index + i) % workers_.size()];
+		std::lock_guard<std::mutex> lock(victim.mutex);
+
+		if(!victim.tasks.empty()) {
+			job = std::move(victim.tasks.back());
+			victim.tasks.pop_back();
+			queued_.fetch_sub(1, std::memory_order_relaxed);
+			stolen_.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*!	@brief Run a job and account for it
+ *	@param job The job to run
+ */
+void Executor::run(Job& job) {
+	try {
+		if(job.handler)
+			job.handler(job.message);
+		else
+			job.task();
+	}
+	catch(...) {
+		//Keep the first error for wait()
+		std::lock_guard<std::mutex> lock(mutex_);
+		if(!error_)
+			error_ = std::current_exception();
+	}
+
+	executed_.fetch_add(1, std::memory_order_relaxed);
+	if(unfinished_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		std::lock_guard<std::mutex> lock(mutex_);
+		finished_.notify_all();
+	}
+}
+
+/*!	@brief Worker thread body
+ *	@param index Index of the worker
+ */
+void Executor::work(const size_t index) {
+	currentWorker.owner = this;
+	currentWorker.index = index;
+
+	for(;;) {
+		Job job;
+
+		if(popLocal(index, job) || steal(index, job)) {
+			run(job);
+			continue;
+		}
+
+		//Nothing anywhere, sleep until a task is queued or the pool stops
+		std::unique_lock<std::mutex> lock(mutex_);
+		wakeup_.wait(lock, [this]() { return stopping_ || queued_.load(std::memory_order_acquire) > 0; });
+		if(stopping_ && queued_.load(std::memory_order_acquire) == 0)
+			break;
+	}
+
+	currentWorker.owner = nullptr;
+}
+
+} //Inet namespace
@@ -0,0 +1,181 @@
+/*!
+ *
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+//Include once
+#ifndef EXECUTOR_H_INCLUDED
+#define EXECUTOR_H_INCLUDED
+
+//System includes
+#include <sys/types.h>
+
+//Library includes
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+//Project includes
+#include "AbstractSocket.h"
+#include "NetStream.h"
+
+//Namespace container
+namespace Inet {
+
+/*!	@brief Work-stealing thread pool for connection handlers
+ *	Every worker has its own deque of tasks. A task submitted with an
+ *	affinity hint goes on that worker's deque, and a task submitted from a
+ *	worker without a hint goes on the submitting worker's own deque, so work
+ *	for one connection stays on one core and its data stays in that core's
+ *	cache. A worker runs the tasks on its own deque oldest first, so the
+ *	messages of a connection kept on one worker are handled in the order
+ *	they arrived. Once its deque is empty a worker steals the newest task
+ *	from another worker's, the one its owner would reach last, so one slow
+ *	handler only holds up its own worker while the rest of its queue moves
+ *	elsewhere.
+ *
+ *	A stolen task may run before or alongside older tasks left on its
+ *	original worker, so a handler that must never see one connection's
+ *	messages out of order should still serialise that connection's state.
+ *	All operations are safe to call from any thread, including from a task.
+ */
+class Executor {
+public:
+	///Typedefs local to class
+	typedef std::function<void()>										Task_t;
+	typedef std::function<void(NetStream& message)>	MessageHandler_t;
+
+	///Affinity hint for a task that may run on any worker
+	static constexpr size_t ANY = (size_t)-1;
+
+	/*!	@brief Executor counters */
+	struct Stats {
+		size_t		submitted = 0;	///< Tasks queued
+		size_t		executed = 0;		///< Tasks run to completion
+		size_t		stolen = 0;			///< Tasks run by a worker other than the one queued on
+	};
+
+	/*!	@brief Start the workers
+	 *	@param workers Number of worker threads, 0 for one per core the
+	 *		process may run on
+	 *	@param pin True to pin each worker thread to a core
+	 */
+	explicit Executor(const size_t workers = 0, const bool pin = true);
+
+	/*!	@brief Copy constructor, delete default */
+	Executor(const Executor& other) = delete;
+
+	/*!	@brief Assignment operator, delete default */
+	Executor& operator=(const Executor& other) = delete;
+
+	/*!	@brief Destructor, runs the tasks still queued then joins the workers */
+	virtual ~Executor();
+
+	/*!	@brief Queue a task
+	 *	@param task The task to run
+	 *	@param affinity Worker to queue on, taken modulo the worker count, or
+	 *		ANY for the calling worker or, outside the pool, the next in turn
+	 */
+	void submit(Task_t task, const size_t affinity = ANY);
+
+	/*!	@brief Queue a decoded message for a handler
+	 *	The message is moved straight into the worker's deque, so neither its
+	 *	buffer is copied nor a holder allocated for it.
+	 *	@param message The message to hand over
+	 *	@param handler Called with the message on a worker thread
+	 *	@param affinity As for submit(), e.g. affinity() of the connection
+	 */
+	void post(NetStream&& message, MessageHandler_t handler, const size_t affinity = ANY);
+
+	/*!	@brief Wait until every queued task has run
+	 *	Must not be called from a task.
+	 *	@throw The first exception thrown by a task since the last wait()
+	 */
+	void wait();
+
+	/*!	@brief Returns the affinity hint that keeps a connection on one worker */
+	inline size_t affinity(const AbstractSocket& sock) const { return (size_t)sock.handle() % workers_.size(); }
+
+	/*!	@brief Returns the number of workers */
+	inline size_t workers() const { return workers_.size(); }
+
+	/*!	@brief Returns the worker running the calling thread, or ANY outside this pool */
+	size_t current() const;
+
+	/*!	@brief Returns the core a worker is pinned to, or -1 if unpinned */
+	int cpu(const size_t worker) const;
+
+	/*!	@brief Returns a snapshot of the executor counters */
+	Stats stats() const;
+
+protected:
+	/*!	@brief Queued work, a task or a posted message with its handler */
+	struct Job {
+		Task_t							task;
+		MessageHandler_t		handler;				///< Set instead of task for posted messages
+		NetStream						message;				///< Message handed over by post()
+	};
+
+	/*!	@brief Task deque and thread of one worker */
+	struct Worker {
+		std::mutex						mutex;						///< Guards tasks
+		std::deque<Job>				tasks;
+		std::thread						thread;
+		int										cpu = -1;					///< Pinned core, -1 if unpinned
+	};
+
+	/*!	@brief Queue a job on a worker's deque and wake a worker */
+	void enqueue(Job&& job, const size_t affinity);
+
+	/*!	@brief Take the oldest job from a worker's own deque */
+	bool popLocal(const size_t index, Job& job);
+
+	/*!	@brief Take the newest job from another worker's deque */
+	bool steal(const size_t index, Job& job);
+
+	/*!	@brief Run a job and account for it */
+	void run(Job& job);
+
+	/*!	@brief Worker thread body, runs tasks until the executor is destroyed */
+	void work(const size_t index);
+
+private:
+	std::vector<std::unique_ptr<Worker>>	workers_;
+	std::mutex														mutex_;				///< Guards sleeping, finishing and error_
+	std::condition_variable								wakeup_;			///< Signalled when a task is queued
+	std::condition_variable								finished_;		///< Signalled when the last task finishes
+	std::atomic<size_t>										queued_;			///< Tasks sitting in a deque
+	std::atomic<size_t>										unfinished_;	///< Tasks queued or running
+	std::atomic<size_t>										next_;				///< Round robin for tasks from outside
+	std::atomic<size_t>										submitted_;
+	std::atomic<size_t>										executed_;
+	std::atomic<size_t>										stolen_;
+	std::exception_ptr										error_;
+	bool																	stopping_;
+};
+
+} //Inet namespace
+
+#endif //EXECUTOR_H_INCLUDED
@@ -0,0 +1,154 @@
+/*!
+ *
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed Addin the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//System includes
+#include <memory.h>
+
+//Library includes
+#include <algorithm>
+
+//Project includes
+#include "FrameParser.h"
+#include "StreamException.h"
+#include "ByteOrder.h"
+
+//Namespace container
+namespace Inet {
+
+/*!	@brief Construct a parser
+ *	@param order The decode order given to the frame views
+ *	@param maxFrameSize The largest frame payload accepted
+ */
+FrameParser::FrameParser(const NetStream::Order order, const u_int32_t maxFrameSize) :
+	order_(order), maxFrameSize_(maxFrameSize)
+{
+}
+
+/*!	@brief Destructor */
+FrameParser::~FrameParser() {}
+
+/*!	@brief Supply the bytes returned by the latest read
+ *	@param data Pointer to the bytes read
+ *	@param bytes The number of bytes read
+ */
+void FrameParser::feed(const char* data, const size_t bytes) {
+	//Keep whatever the caller did not drain from the previous buffer
+	if(inputBytes_ > 0) {
+		release();
+		take(inputBytes_);
+	}
+
+	input_ = data;
+	inputBytes_ = bytes;
+}
+
+/*!	@brief Extract the next complete frame
+ *	@param frame Receives a view of the frame payload
+ *	@return True if a frame was extracted, false if more data is needed
+ *	@throw StreamException if a frame exceeds the maximum frame size
+ */
+bool FrameParser::next(NetStreamView& frame) {
+	//Declare local
+	const size_t prefix = sizeof(u_int32_t);
+	u_int32_t length;
+
+	//Release the frame handed out by the previous call
+	release();
+
+	//Finish a frame split across feeds
+	if(!pending_.empty()) {
+		if(pending_.size() < prefix) {
+			take(prefix - pending_.size());
+			if(pending_.size() < prefix)
+				return false;
+		}
+
+		length = frameLength(pending_.data());
+		if(pending_.size() < prefix + length) {
+			take(prefix + length - pending_.size());
+			if(pending_.size() < prefix + length)
+				return false;
+		}
+
+		frame = NetStreamView(pending_.data() + prefix, length, order_);
+		emitted_ = prefix + length;
+		return true;
+	}
+
+	//Whole frame available in the fed buffer, hand it out in place
+	if(inputBytes_ >= prefix) {
+		length = frameLength(input_);
+		if(inputBytes_ - prefix >= length) {
+			frame = NetStreamView(input_ + prefix, length, order_);
+			input_ += prefix + length;
+			inputBytes_ -= prefix + length;
+			return true;
+		}
+		pending_.reserve(prefix + length);
+	}
+
+	//Hold on to the start of the next frame until the rest arrives
+	take(inputBytes_);
+	return false;
+}
+
+/*!	@brief Discard any partially received frame and unparsed input */
+void FrameParser::reset() {
+	pending_.clear();
+	input_ = nullptr;
+	inputBytes_ = 0;
+	emitted_ = 0;
+}
+
+/*!	@brief Drop the frame last handed out from pending storage */
+void FrameParser::release() {
+	if(emitted_ > 0) {
+		pending_.erase(pending_.begin(), pending_.begin() + emitted_);
+		emitted_ = 0;
+	}
+}
+
+/*!	@brief Move up to the given number of fed bytes into pending storage
+ *	@param bytes The number of bytes wanted
+ */
+void FrameParser::take(const size_t bytes) {
+	const size_t count = std::min(bytes, inputBytes_);
+	pending_.insert(pending_.end(), input_, input_ + count);
+	input_ += count;
+	inputBytes_ -= count;
+}
+
+/*!	@brief Decode and check a frame length prefix
+ *	@param p Pointer to the 4-byte prefix
+ *	@return The payload length
+ *	@throw StreamException if the length exceeds the maximum frame size
+ */
+u_int32_t FrameParser::frameLength(const char* p) const {
+	//Declare local
+	u_int32_t length;
+
+	memcpy(&length, p, sizeof(u_int32_t));
+	length = NetOrder(length);
+	if(length > maxFrameSize_)
+		throw StreamException(STREAM_ERR_FRAME_SIZE, STREAM_MSG_FRAME_SIZE);
+
+	return length;
+}
+} //Inet namespace end
@@ -0,0 +1,116 @@
+/*!
+ *
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed Addin the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef FRAMEPARSER_H_INCLUDED
+#define FRAMEPARSER_H_INCLUDED
+
+//System includes
+#include <sys/types.h>
+
+//Library includes
+#include <vector>
+
+//Project includes
+#include "NetStream.h"
+#include "NetStreamView.h"
+#include "ConnectionEndpoint.h"
+
+//Namespace container
+namespace Inet {
+
+/*!	@brief Incremental parser for length-prefixed NetStream frames
+ *	Reassembles the frames written by ConnectionEndpoint::sendStream() from
+ *	reads that split them at arbitrary points. The caller feeds each read's
+ *	bytes in turn, then calls next() until it returns false:
+ *		parser.feed(buf, bytes);
+ *		while(parser.next(frame))
+ *			handle(frame);
+ *	Frames lying wholly within the fed bytes are returned as views of the
+ *	caller's buffer without copying. Only a frame split across feeds is
+ *	copied, into storage kept by the parser until it is complete.
+ */
+class FrameParser {
+public:
+	///Typedefs local to class
+	typedef std::vector<char>						Buffer_t;
+
+public:
+	/*!	@brief Construct a parser
+	 *	@param order The decode order given to the frame views
+	 *	@param maxFrameSize The largest frame payload accepted
+	 */
+	explicit FrameParser(const NetStream::Order order = NetStream::Order::LIFO,
+		const u_int32_t maxFrameSize = DEFAULT_MAX_FRAME_SIZE);
+
+	/*!	@brief Destructor */
+	virtual ~FrameParser();
+
+	/*!	@brief Supply the bytes returned by the latest read
+	 *	The buffer must stay valid until next() returns false. Any bytes not
+	 *	yet parsed from the previous feed are buffered first.
+	 *	@param data Pointer to the bytes read
+	 *	@param bytes The number of bytes read
+	 */
+	void feed(const char* data, const size_t bytes);
+
+	/*!	@brief Extract the next complete frame
+	 *	The view refers to the fed buffer or the parser's own storage and is
+	 *	valid until the next call to next() or feed().
+	 *	@param frame Receives a view of the frame payload
+	 *	@return True if a frame was extracted, false if more data is needed
+	 *	@throw StreamException if a frame exceeds the maximum frame size, in
+	 *		which case the parser must be reset before further use
+	 */
+	bool next(NetStreamView& frame);
+
+	/*!	@brief Discard any partially received frame and unparsed input */
+	void reset();
+
+	/*!	@brief Returns the number of bytes held towards an incomplete frame */
+	inline size_t buffered() const { return pending_.size(); }
+
+	/*!	@brief Returns the largest frame payload accepted */
+	inline u_int32_t maxFrameSize() const { return maxFrameSize_; }
+
+private:
+	/*!	@brief Move up to the given number of fed bytes into pending storage
+	 *	@param bytes The number of bytes wanted
+	 */
+	void take(const size_t bytes);
+
+	/*!	@brief Drop the frame last handed out from pending storage */
+	void release();
+
+	/*!	@brief Decode and check a frame length prefix
+	 *	@param p Pointer to the 4-byte prefix
+	 *	@return The payload length
+	 */
+	u_int32_t frameLength(const char* p) const;
+
+private:
+	Buffer_t					pending_;
+	const char*				input_ = nullptr;
+	size_t						inputBytes_ = 0;
+	size_t						emitted_ = 0;
+	NetStream::Order	order_;
+	u_int32_t					maxFrameSize_;
+};
+} //Inet namespace
+
+#endif // FRAMEPARSER_H_INCLUDED
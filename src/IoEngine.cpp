@@ -0,0 +1,120 @@
+/*!
+ *
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//System includes
+#include <sys/types.h>
+
+//Library includes
+#include <utility>
+
+//Project includes
+#include "IoEngine.h"
+#include "EpollEngine.h"
+#include "UringEngine.h"
+#include "SocketException.h"
+
+//Namespace container
+namespace Inet {
+
+/*!	@brief Create the best engine available on this kernel
+ *	@param entries Submission queue depth
+ *	@param uring False to always use the epoll engine
+ *	@return The io_uring engine if available, otherwise the epoll engine
+ */
+std::unique_ptr<IoEngine> IoEngine::create(const unsigned entries, const bool uring) {
+	if(uring) {
+		try {
+			return std::unique_ptr<IoEngine>(new UringEngine(entries));
+		}
+		catch(const SocketException& se) {
+			//Kernel too old, or io_uring disabled, fall back to readiness
+		}
+	}
+	return std::unique_ptr<IoEngine>(new EpollEngine(entries));
+}
+
+/*!	@brief Constructor for derived engines */
+IoEngine::IoEngine() {
+}
+
+/*!	@brief Destructor */
+IoEngine::~IoEngine() {
+}
+
+/*!	@brief Register long-lived buffers for receive and send
+ *	@param buffers The buffers to register
+ */
+void IoEngine::registerBuffers(const std::vector<struct iovec>& buffers) {
+	buffers_ = buffers;
+}
+
+/*!	@brief Register sockets so operations skip the descriptor lookup
+ *	@param handles Descriptors of the sockets to register
+ */
+void IoEngine::registerFiles(const std::vector<socket_t>& handles) {
+	files_.clear();
+	for(size_t i = 0; i < handles.size(); i++)
+		files_[handles[i]] = (int)i;
+}
+
+/*!	@brief Release the registered buffers */
+void IoEngine::unregisterBuffers() {
+	buffers_.clear();
+}
+
+/*!	@brief Release the registered sockets */
+void IoEngine::unregisterFiles() {
+	files_.clear();
+}
+
+/*!	@brief Returns the registered buffer containing a range
+ *	@param buf First byte of the range
+ *	@param len Length of the range
+ *	@return Index of the registered buffer, or -1 if none contains it
+ */
+int IoEngine::bufferIndex(const char* buf, const size_t len) const {
+	for(size_t i = 0; i < buffers_.size(); i++) {
+		const char* base = (const char*)buffers_[i].iov_base;
+		if(buf >= base && buf + len <= base + buffers_[i].iov_len)
+			return (int)i;
+	}
+	return -1;
+}
+
+/*!	@brief Returns the registered slot of a socket
+ *	@param handle The socket descriptor
+ *	@return The slot, or -1 if the socket is not registered
+ */
+int IoEngine::fileIndex(const socket_t handle) const {
+	auto it = files_.find(handle);
+	return (it == files_.end()) ? -1 : it->second;
+}
+
+/*!	@brief Wrap an accepted descriptor as an endpoint
+ *	@param handle The accepted descriptor
+ *	@param address The peer address
+ *	@param addrLen Length of the peer address
+ *	@return Endpoint owning the descriptor
+ */
+ConnectionEndpoint IoEngine::endpoint(const socket_t handle, SockAddrIn_t& address, const int addrLen) {
+	return ConnectionEndpoint(handle, &address, addrLen);
+}
+
+} //Inet namespace
@@ -0,0 +1,171 @@
+/*!
+ *
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//Include once
+#ifndef IOENGINE_H_INCLUDED
+#define IOENGINE_H_INCLUDED
+
+//System includes
+#include <sys/types.h>
+#include <sys/uio.h>
+
+//Library includes
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+//Project includes
+#include "AbstractSocket.h"
+#include "ConnectionEndpoint.h"
+
+//Namespace container
+namespace Inet {
+
+/*!	@brief Asynchronous accept, receive and send with batched completions
+ *	Operations are queued with a callback and return straight away. poll()
+ *	submits everything queued since the last call together, waits for
+ *	results and calls the callback of each finished operation. Callbacks
+ *	run on the thread calling poll() and may queue further operations.
+ *
+ *	Results follow the kernel convention: the number of bytes transferred,
+ *	0 when the peer has closed the connection, or a negative errno value.
+ *	A send may complete with fewer bytes than requested, in which case the
+ *	caller queues the rest. Buffers must stay valid until the operation
+ *	completes.
+ *
+ *	Engines never change the mode of a socket, so blocking and non-blocking
+ *	sockets can both be used, and the socket's own calls behave afterwards
+ *	as they did before.
+ *
+ *	Use create() to get the io_uring engine where the kernel supports it,
+ *	or the epoll engine otherwise. Engines are not thread safe.
+ */
+class IoEngine {
+public:
+	///Typedefs local to class
+	typedef std::function<void(int result)>												Completion_t;
+	typedef std::function<void(int result, ConnectionEndpoint&& client)>	AcceptCompletion_t;
+
+	/*!	@brief Create the best engine available on this kernel
+	 *	@param entries Submission queue depth, the number of operations that
+	 *		can be queued between polls without an extra system call
+	 *	@param uring False to always use the epoll engine
+	 *	@return The io_uring engine, or the epoll engine if io_uring is
+	 *		unavailable or disabled
+	 *	@throw SocketException if neither engine can be created
+	 */
+	static std::unique_ptr<IoEngine> create(const unsigned entries = 256, const bool uring = true);
+
+	/*!	@brief Copy constructor, delete default */
+	IoEngine(const IoEngine& other) = delete;
+
+	/*!	@brief Assignment operator, delete default */
+	IoEngine& operator=(const IoEngine& other) = delete;
+
+	/*!	@brief Destructor, operations still pending are abandoned */
+	virtual ~IoEngine();
+
+	/*!	@brief Returns the name of the engine, "io_uring" or "epoll" */
+	virtual const char* name() const = 0;
+
+	/*!	@brief Queue an accept on a listening socket
+	 *	@param sock The listening socket
+	 *	@param done Called with 0 and the connected client, or a negative errno
+	 */
+	virtual void accept(const AbstractSocket& sock, AcceptCompletion_t done) = 0;
+
+	/*!	@brief Queue a receive
+	 *	@param sock The connected socket to read from
+	 *	@param buf Buffer to receive into
+	 *	@param len The largest number of bytes to receive
+	 *	@param done Called with the number of bytes received
+	 */
+	virtual void receive(const AbstractSocket& sock, char* buf, const size_t len, Completion_t done) = 0;
+
+	/*!	@brief Queue a send
+	 *	@param sock The connected socket to write to
+	 *	@param buf The data to send
+	 *	@param len The number of bytes to send
+	 *	@param done Called with the number of bytes sent
+	 */
+	virtual void send(const AbstractSocket& sock, const char* buf, const size_t len, Completion_t done) = 0;
+
+	/*!	@brief Cancel the pending operations of a socket and forget it
+	 *	Each one completes with -ECANCELED, or with its result if it finished
+	 *	first. Call before closing any socket the engine has been used with,
+	 *	since its descriptor may be reused.
+	 *	@param sock The socket whose operations are cancelled
+	 */
+	virtual void cancel(const AbstractSocket& sock) = 0;
+
+	/*!	@brief Submit queued operations and dispatch completions
+	 *	@param timeout Milliseconds to wait for a completion, 0 to only reap
+	 *		what has already finished or -1 to wait indefinitely
+	 *	@return The number of completion callbacks called
+	 *	@throw SocketException if waiting fails, or whatever a callback throws
+	 */
+	virtual size_t poll(const int timeout = -1) = 0;
+
+	/*!	@brief Returns the number of operations not yet completed */
+	virtual size_t pending() const = 0;
+
+	/*!	@brief Register long-lived buffers for receive and send
+	 *	Operations on memory lying wholly within a registered buffer skip the
+	 *	kernel's per-operation page mapping. Replaces any previous set.
+	 *	@param buffers The buffers, which must stay valid while registered
+	 *	@throw SocketException if the kernel rejects the buffers
+	 */
+	virtual void registerBuffers(const std::vector<struct iovec>& buffers);
+
+	/*!	@brief Register sockets so operations skip the descriptor lookup
+	 *	Replaces any previous set. Sockets must be unregistered before they
+	 *	are closed.
+	 *	@param handles Descriptors of the sockets to register
+	 *	@throw SocketException if the kernel rejects the descriptors
+	 */
+	virtual void registerFiles(const std::vector<socket_t>& handles);
+
+	/*!	@brief Release the registered buffers */
+	virtual void unregisterBuffers();
+
+	/*!	@brief Release the registered sockets */
+	virtual void unregisterFiles();
+
+protected:
+	/*!	@brief Constructor for derived engines */
+	IoEngine();
+
+	/*!	@brief Returns the registered buffer containing a range, or -1 */
+	int bufferIndex(const char* buf, const size_t len) const;
+
+	/*!	@brief Returns the registered slot of a socket, or -1 */
+	int fileIndex(const socket_t handle) const;
+
+	/*!	@brief Wrap an accepted descriptor as an endpoint */
+	static ConnectionEndpoint endpoint(const socket_t handle, SockAddrIn_t& address, const int addrLen);
+
+	std::vector<struct iovec>							buffers_;			///< Registered buffers
+	std::unordered_map<socket_t, int>			files_;				///< Registered socket slots
+};
+
+} //Inet namespace
+
+#endif //IOENGINE_H_INCLUDED
@@ -19,40 +19,140 @@
  */
 
 //System includes
-#include <netinet/in.h>
 #include <time.h>
 #include <stdio.h>
 #include <memory.h>
 
 //Library includes
 #include <memory>
+#include <type_traits>
 
 //Project includes
 #include "NetStream.h"
+#include "NetStreamView.h"
+#include "BufferPool.h"
+#include "Streamable.h"
 #include "StreamException.h"
+#include "ByteOrder.h"
 
 //Namespace container
 namespace Inet {
 
+//Module-local helpers
+namespace {
+
+/*!	@brief Map a signed value onto an unsigned one so small magnitudes stay small
+ *	@param val The signed value to encode
+ *	@return Zigzag encoded value: 0, -1, 1, -2... map to 0, 1, 2, 3...
+ */
+inline u_int64_t Zigzag(const int64_t val) {
+	return ((u_int64_t)val << 1) ^ (u_int64_t)(val >> 63);
+}
+
+/*!	@brief Maximum encoded length of a 64-bit varint */
+constexpr size_t VARINT_MAX_BYTES = 10;
+
+/*!	@brief Returns the number of bytes needed to encode a value as a varint
+ *	@param val The value to encode
+ *	@return Encoded length from the position of the highest set bit
+ */
+inline size_t VarintSize(const u_int64_t val) {
+	return (63 - __builtin_clzll(val | 1)) / 7 + 1;
+}
+
+/*!	@brief Write an LEB128 varint without type markers
+ *	Seven bits are stored per byte, least significant group first, with the
+ *	high bit set on every byte except the last.
+ *	@param p Destination with room for VarintSize(val) bytes
+ *	@param val The value to encode
+ *	@return Pointer to the byte following the varint
+ */
+inline char* PutVarint(char* p, u_int64_t val) {
+	while(val >= 0x80) {
+		*p++ = (char)(val | 0x80);
+		val >>= 7;
+	}
+	*p++ = (char)val;
+	return p;
+}
+
+/*!	@brief Map an integer array element onto the value written as its varint
+ *	@param val The element to encode
+ *	@return Zigzag mapped value for signed types, the value itself otherwise
+ */
+template<typename T>
+inline u_int64_t PackedValue(const T val) {
+	if constexpr(std::is_signed<T>::value)
+		return Zigzag(val);
+	else
+		return val;
+}
+
+/*!	@brief Read one array element from memory that need not be aligned
+ *	@param src Pointer to the element
+ *	@return The element value
+ */
+template<typename T>
+inline T LoadElement(const char* src) {
+	T val;
+	memcpy(&val, src, sizeof(T));
+	return val;
+}
+
+} //Module-local namespace
+
 /*!	@brief Default constructor */
 NetStream::NetStream() {}
 
 /*!	@brief Initialize the stream with raw data
  *	@param data Pointer to buffer containing stream data
  *	@param bytes the number of bytes to read from the data pointer
+ *	@param order The order in which values will be decoded
  */
-NetStream::NetStream(const char *data, const size_t bytes) :
-	buffer_(bytes)
+NetStream::NetStream(const char *data, const size_t bytes, const Order order) :
+	buffer_(bytes), order_(order)
 {
 	memcpy((void*)&buffer_[0], (void*)data, bytes);
 }
 
+/*!	@brief Construct an empty stream with storage taken from a pool
+ *	@param pool The pool to take storage from
+ *	@param order The order in which values will be decoded
+ */
+NetStream::NetStream(BufferPool& pool, const Order order) :
+	buffer_(pool.acquire()), order_(order), pool_(&pool)
+{
+}
+
+/*!	@brief Construct an empty stream whose storage starts in an arena
+ *	@param arena The inline storage to use until the stream outgrows it
+ *	@param order The order in which values will be decoded
+ */
+NetStream::NetStream(InlineArena& arena, const Order order) :
+	buffer_(Buffer_t::allocator_type(&arena)), order_(order)
+{
+	buffer_.reserve(arena.bytes);
+}
+
 /*!	@brief Move constructor
  *	@param other Object to move
  */
 NetStream::NetStream(NetStream&& other) {
 	if(this != &other) {
-		buffer_ = std::move(other.buffer_);
+		adopt(other.buffer_);
+		order_ = other.order_;
+		compact_ = other.compact_;
+		interning_ = other.interning_;
+		head_ = other.head_;
+		pool_ = other.pool_;
+		dictionary_ = std::move(other.dictionary_);
+		segments_ = std::move(other.segments_);
+		borrowed_ = other.borrowed_;
+		other.segments_.clear();
+		other.borrowed_ = 0;
+		other.head_ = 0;
+		other.pool_ = nullptr;
+		other.interning_ = false;
 	}
 }
 
@@ -63,13 +163,32 @@ NetStream::NetStream(NetStream&& other) {
 NetStream& NetStream::operator=(NetStream&& other) {
 	//Handle self-assignment
 	if(this != &other) {
-		buffer_ = std::move(other.buffer_);
+		//Hand our own storage back before taking over the other's
+		if(pool_)
+			pool_->release(std::move(buffer_));
+		adopt(other.buffer_);
+		order_ = other.order_;
+		compact_ = other.compact_;
+		interning_ = other.interning_;
+		head_ = other.head_;
+		pool_ = other.pool_;
+		dictionary_ = std::move(other.dictionary_);
+		segments_ = std::move(other.segments_);
+		borrowed_ = other.borrowed_;
+		other.segments_.clear();
+		other.borrowed_ = 0;
+		other.head_ = 0;
+		other.pool_ = nullptr;
+		other.interning_ = false;
 	}
 	return *this;
 }
 
-/*!	@brief Destructor */
-NetStream::~NetStream() {}
+/*!	@brief Destructor, returns pooled storage to its pool */
+NetStream::~NetStream() {
+	if(pool_)
+		pool_->release(std::move(buffer_));
+}
 
 /*!	@brief
  */
@@ -83,17 +202,86 @@ int32_t NetStream::setRaw(u_char* data, u_int32_t size) {
 
 	//Insert buffer into vector
 	memcpy(&(*(buffer_.begin())), data, size);
+
+	//Start reading from the beginning of the new data, with a fresh dictionary
+	head_ = 0;
+	segments_.clear();
+	borrowed_ = 0;
+	if(dictionary_)
+		dictionary_->clear();
 	return 0;
 }
 
+/*!	@brief Replace the contents with storage for raw data to be filled in
+ *	@param size The size of the raw data in bytes
+ *	@return Pointer to size bytes of storage for the caller to fill
+ */
+char* NetStream::prepareRaw(const u_int32_t size) {
+	//Clear first so a reallocation has nothing to copy. The storage stays
+	// the stream's own, so pooled capacity is reused and handed back.
+	buffer_.clear();
+	buffer_.resize(size);
+
+	//Start reading from the beginning of the new data, with a fresh dictionary
+	head_ = 0;
+	segments_.clear();
+	borrowed_ = 0;
+	if(dictionary_)
+		dictionary_->clear();
+	return buffer_.data();
+}
+
+/*!	@brief Write strings through a per-stream dictionary
+ *	@param interning True to intern strings, false to write them in full
+ *	@throw StreamException if interning is enabled on a LIFO stream
+ */
+void NetStream::setInterning(const bool interning) {
+	//References must follow the definition they refer to
+	if(interning && order_ != Order::FIFO)
+		throw StreamException(STREAM_ERR_INVALID_ORDER, STREAM_MSG_INVALID_ORDER);
+
+	if(interning && !dictionary_)
+		dictionary_.reset(new StringDictionary());
+	interning_ = interning;
+}
+
+/*!	@brief Move the FIFO read offset
+ *	@param offset Byte offset of the next value to decode
+ *	@throw StreamException if the stream is not FIFO, holds borrowed
+ *		payloads or the offset is past the end of the stream
+ */
+void NetStream::seek(const u_int32_t offset) {
+	//LIFO decode reads from the tail, a head offset would only clip it
+	if(order_ != Order::FIFO)
+		throw StreamException(STREAM_ERR_INVALID_ORDER, STREAM_MSG_INVALID_ORDER);
+
+	//Storage offsets past a borrowed payload don't match the encoded bytes
+	if(!segments_.empty())
+		throw StreamException(STREAM_ERR_BORROWED, STREAM_MSG_BORROWED);
+
+	if(offset > buffer_.size())
+		throw StreamException(STREAM_ERR_INVALID_OFFSET, STREAM_MSG_INVALID_OFFSET);
+	head_ = offset;
+}
+
+/*!	@brief Returns the type marker of the next value to be decoded
+ *	@return The marker of the next value, read from the read offset in a
+ *		FIFO stream or from the tail of a LIFO stream
+ *	@throw StreamException if no data remains in the stream
+ */
+NetStream::Type NetStream::peek() const {
+	if(remaining() == 0)
+		throw StreamException(STREAM_ERR_END_OF_STREAM, STREAM_MSG_END_OF_STREAM);
+
+	return (Type)(u_char)((order_ == Order::FIFO) ? buffer_[head_] : buffer_.back());
+}
+
 /*!	@brief Add char value to this data stream
  *	@param val Character value to append to the stream data
  *	@return Reference to this stream instance
  */
 NetStream& NetStream::operator<<(const char& val)	{
-	buffer_.push_back( Type::CHAR );
-	buffer_.push_back( val );
-	buffer_.push_back( Type::CHAR );
+	append(Type::CHAR, &val, sizeof(char));
 	return *this;
 }
 
@@ -102,9 +290,7 @@ NetStream& NetStream::operator<<(const char& val)	{
  *	@return Reference to this stream instance
  */
 NetStream& NetStream::operator<<(const u_char& val) {
-	buffer_.push_back( Type::UCHAR );
-	buffer_.push_back( val );
-	buffer_.push_back( Type::UCHAR );
+	append(Type::UCHAR, &val, sizeof(u_char));
 	return *this;
 }
 
@@ -113,20 +299,15 @@ NetStream& NetStream::operator<<(const u_char& val) {
  *	@return Reference to this stream instance
  */
 NetStream&	NetStream::operator<<(const int16_t& val) {
-	//Declare local
-	int16_t netval;
-
-	//Convert to Network Byte Order
-	netval = htons(val);
-	u_char* pIndex = (u_char*)&netval;
-
-	//Push the type indicator, integer bytes, and closing type indicator
-	buffer_.push_back( Type::INT16 );
-	for( u_int16_t count = 0; count < sizeof(int16_t); count++ ){
-		buffer_.push_back(*pIndex);
-		pIndex++;
+	//Compact streams write a zigzag varint in place of the fixed-width value
+	if(compact_) {
+		appendVarint(Type::ZIGZAG, Zigzag(val));
+		return *this;
 	}
-	buffer_.push_back( Type::INT16 );
+
+	//Convert to Network Byte Order and append with type indicators
+	int16_t netval = NetOrder(val);
+	append(Type::INT16, &netval, sizeof(int16_t));
 
 	//Return
 	return *this;
@@ -137,20 +318,15 @@ NetStream&	NetStream::operator<<(const int16_t& val) {
  *	@return A reference to this stream instance
  */
 NetStream&	NetStream::operator<<(const u_int16_t& val) {
-	//Declare local
-	u_int16_t  netval;
-
-	//Convert to Network Byte Order
-	netval = htons(val);
-	u_char* pIndex = (u_char*)&netval;
-
-	//Push the type indicator
-	buffer_.push_back( Type::UINT16 );
-	for(u_int16_t count = 0; count < sizeof(u_int16_t); count++) {
-		buffer_.push_back(*pIndex);
-		pIndex++;
+	//Compact streams write a varint in place of the fixed-width value
+	if(compact_) {
+		appendVarint(Type::VARINT, val);
+		return *this;
 	}
-	buffer_.push_back( Type::UINT16 );
+
+	//Convert to Network Byte Order and append with type indicators
+	u_int16_t netval = NetOrder(val);
+	append(Type::UINT16, &netval, sizeof(u_int16_t));
 
 	//Return
 	return *this;
@@ -161,20 +337,15 @@ NetStream&	NetStream::operator<<(const u_int16_t& val) {
  *	@return A reference to this stream instance
  */
 NetStream&	NetStream::operator<<(const int32_t& val) {
-	//Declare local
-	int32_t  netval;
-
-	//Convert to NetworkByte Order
-	netval = htonl(val);
-	u_char* pIndex = (u_char*)&netval;
-
-	//Push the type indicator
-	buffer_.push_back( Type::INT32 );
-	for(u_int16_t count = 0; count < sizeof(int32_t); count++) {
-		buffer_.push_back( *pIndex );
-		pIndex++;
+	//Compact streams write a zigzag varint in place of the fixed-width value
+	if(compact_) {
+		appendVarint(Type::ZIGZAG, Zigzag(val));
+		return *this;
 	}
-	buffer_.push_back( Type::INT32 );
+
+	//Convert to Network Byte Order and append with type indicators
+	int32_t netval = NetOrder(val);
+	append(Type::INT32, &netval, sizeof(int32_t));
 
 	//Return
 	return *this;
@@ -185,20 +356,15 @@ NetStream&	NetStream::operator<<(const int32_t& val) {
  *	@return A reference to this stream instance
  */
 NetStream& NetStream::operator<<(const u_int32_t& val) {
-	//Declare local
-	u_int32_t   netval;
-
-	//Convert to Network Byte Order
-	netval = htonl(val);
-	u_char* pIndex = (u_char*)&netval;
-
-	//Push the type indicator
-	buffer_.push_back( Type::UINT32 );
-	for(u_int16_t count = 0; count < sizeof(u_int32_t); count++) {
-		buffer_.push_back( *pIndex );
-		pIndex++;
+	//Compact streams write a varint in place of the fixed-width value
+	if(compact_) {
+		appendVarint(Type::VARINT, val);
+		return *this;
 	}
-	buffer_.push_back( Type::UINT32 );
+
+	//Convert to Network Byte Order and append with type indicators
+	u_int32_t netval = NetOrder(val);
+	append(Type::UINT32, &netval, sizeof(u_int32_t));
 
 	//Return
 	return *this;
@@ -209,20 +375,15 @@ NetStream& NetStream::operator<<(const u_int32_t& val) {
  *	@return A reference to this stream instance
  */
 NetStream& NetStream::operator<<(const int64_t& val) {
-	//Declare local
-	int64_t   netval;
-
-	//Convert to Network Byte Order
-	netval = htonll(val);
-	u_char* pIndex = (u_char*)&netval;
-
-	//Push the type indicator
-	buffer_.push_back( Type::INT64 );
-	for(u_int16_t count = 0; count < sizeof(int64_t); count++) {
-		buffer_.push_back( *pIndex );
-		pIndex++;
+	//Compact streams write a zigzag varint in place of the fixed-width value
+	if(compact_) {
+		appendVarint(Type::ZIGZAG, Zigzag(val));
+		return *this;
 	}
-	buffer_.push_back( Type::INT64 );
+
+	//Convert to Network Byte Order and append with type indicators
+	int64_t netval = NetOrder(val);
+	append(Type::INT64, &netval, sizeof(int64_t));
 
 	//Return
 	return *this;
@@ -233,20 +394,47 @@ NetStream& NetStream::operator<<(const int64_t& val) {
  *	@return A reference to this stream instance
  */
 NetStream& NetStream::operator<<(const u_int64_t& val) {
+	//Compact streams write a varint in place of the fixed-width value
+	if(compact_) {
+		appendVarint(Type::VARINT, val);
+		return *this;
+	}
+
+	//Convert to Network Byte Order and append with type indicators
+	u_int64_t netval = NetOrder(val);
+	append(Type::UINT64, &netval, sizeof(u_int64_t));
+
+	//Return
+	return *this;
+}
+
+/*!	@brief Append single precision floating-point value to stream data
+ *	@param val 32-bit floating-point value
+ *	@return A reference to this stream instance
+ */
+NetStream& NetStream::operator<<(const float& val) {
 	//Declare local
-	u_int64_t   netval;
+	char netval[sizeof(float)];
 
-	//Convert to Network Byte Order
-	netval = htonll(val);
-	u_char* pIndex = (u_char*)&netval;
+	//Convert to Network Byte Order and append with type indicators
+	NetOrderStore(netval, val);
+	append(Type::FLOAT32, netval, sizeof(float));
 
-	//Push the type indicator
-	buffer_.push_back( Type::UINT64 );
-	for(u_int16_t count = 0; count < sizeof(u_int64_t); count++) {
-		buffer_.push_back( *pIndex );
-		pIndex++;
-	}
-	buffer_.push_back( Type::UINT64 );
+	//Return
+	return *this;
+}
+
+/*!	@brief Append double precision floating-point value to stream data
+ *	@param val 64-bit floating-point value
+ *	@return A reference to this stream instance
+ */
+NetStream& NetStream::operator<<(const double& val) {
+	//Declare local
+	char netval[sizeof(double)];
+
+	//Convert to Network Byte Order and append with type indicators
+	NetOrderStore(netval, val);
+	append(Type::FLOAT64, netval, sizeof(double));
 
 	//Return
 	return *this;
@@ -257,413 +445,779 @@ NetStream& NetStream::operator<<(const u_int64_t& val) {
  *	@return Reference to this stream instance
  */
 NetStream& NetStream::operator<<(const std::string &val) {
-	//Declare local
-	size_t count;
-	u_int32_t length;
-	u_int32_t netlength;
+	if(interning_)
+		appendInterned(val);
+	else
+		appendSized(Type::STRING, val.data(), val.length());
 
-	//Get the length of the string
-	length = val.length();
+	//Return
+	return *this;
+}
 
-	//Push the type indicator (tail)
-	buffer_.push_back( Type::STRING );
+/*!	@brief Encode a user type implementing the Streamable interface
+ *	@param val The object to encode
+ *	@return Reference to this stream instance
+ *	@throw StreamException if the encoded object exceeds 32-bit length
+ */
+NetStream& NetStream::operator<<(const Streamable &val) {
+	//Declare local
+	const size_t overhead = sizeof(u_int32_t) + 2;
+
+	//Reserve for the whole object, nested values then fit without growing
+	buffer_.reserve(buffer_.size() + val.encodedSize() + overhead);
+
+	//Marker, plus room for the length ahead of the payload in FIFO streams.
+	// Offsets are used since encode() may still reallocate the buffer.
+	const size_t head = buffer_.size();
+	extend((order_ == Order::FIFO) ? 1 + sizeof(u_int32_t) : 1)[0] = (char)Type::STREAMABLE;
+	const size_t start = buffer_.size();
+	const size_t borrowed = borrowed_;
+
+	//Let the object append its own values
+	val.encode(*this);
+
+	//Length of whatever the object wrote, including any borrowed payloads
+	const size_t length = buffer_.size() - start + (borrowed_ - borrowed);
+	if(length > UINT32_MAX) {
+		buffer_.resize(head);
+		while(!segments_.empty() && segments_.back().offset > head) {
+			borrowed_ -= segments_.back().bytes;
+			segments_.pop_back();
+		}
+		throw StreamException(STREAM_ERR_LENGTH, STREAM_MSG_LENGTH);
+	}
+	const u_int32_t netlength = NetOrder((u_int32_t)length);
 
-	//Push the string into the vector first
-	for( count = 0; count < length; count++ ) {
-		buffer_.push_back(val[(size_t)count]);
+	if(order_ == Order::FIFO) {
+		memcpy(&buffer_[start - sizeof(u_int32_t)], &netlength, sizeof(u_int32_t));
+		extend(1)[0] = (char)Type::STREAMABLE;
+	}
+	else {
+		char* p = extend(overhead - 1);
+		memcpy(p, &netlength, sizeof(u_int32_t));
+		p[sizeof(u_int32_t)] = (char)Type::STREAMABLE;
 	}
 
-	//Create a byte ordered length
-	netlength = htonl(length);
-	u_char* pIndex = (u_char*)&netlength;
+	//Return
+	return *this;
+}
 
-	//Now push the length value into the vector
-	for( count = 0; count < sizeof(u_int32_t); count++ ) {
-		buffer_.push_back(*pIndex);
-		pIndex++;
+/*!	@brief Embed the unread contents of another stream as a single value
+ *	@param val The stream to embed, left unchanged
+ *	@return Reference to this stream instance
+ *	@throw StreamException if the sub-stream exceeds 32-bit length
+ */
+NetStream& NetStream::operator<<(const NetStream &val) {
+	//Copy out first, extending our own buffer would invalidate the source.
+	// Borrowed payloads are copied in along with the rest of the sub-stream.
+	if(this == &val || !val.segments_.empty()) {
+		NetStream copy(val.remaining());
+		copy.buffer_.resize(val.remaining());
+		val.copyTo(copy.buffer_.data(), val.head_);
+		return *this << copy;
 	}
 
-	//Push the type indicator (head)
-	buffer_.push_back( Type::STRING );
+	if(val.remaining() > UINT32_MAX)
+		throw StreamException(STREAM_ERR_LENGTH, STREAM_MSG_LENGTH);
 
-	//Return
+	appendSized(Type::STREAM, val.buffer_.data() + val.head_, val.remaining());
+	return *this;
+}
+
+/*!	@brief Encode a vector of integers as a single array value
+ *	@param val The values to encode
+ *	@return Reference to this stream instance
+ *	@throw StreamException if the array exceeds the 32-bit length limit
+ */
+template<typename T>
+NetStream& NetStream::operator<<(const std::vector<T>& val) {
+	appendArray<T>((const char*)val.data(), sizeof(T), val.size());
 	return *this;
 }
 
-/*!	@brief Write a buffer of char data to the stream
+/*!	@brief Append an array value gathered from equally spaced elements
+ *	@param base Pointer to the first element
+ *	@param stride The distance between elements in bytes
+ *	@param count The number of elements
+ *	@throw StreamException if the array exceeds the 32-bit length limit
+ */
+template<typename T>
+void NetStream::appendArray(const char* base, const size_t stride, const size_t count) {
+	//Compact streams pack integer elements as varints with no per-element markers
+	if constexpr(std::is_integral<T>::value && sizeof(T) > 1) {
+		if(compact_) {
+			size_t length = 1;
+			for(size_t i = 0; i < count; i++)
+				length += VarintSize(PackedValue(LoadElement<T>(base + i * stride)));
+			if(length > UINT32_MAX)
+				throw StreamException(STREAM_ERR_LENGTH, STREAM_MSG_LENGTH);
+
+			char* p = extendSized(Type::ARRAY, (u_int32_t)length);
+			*p++ = (char)(std::is_signed<T>::value ? Type::ZIGZAG : Type::VARINT);
+			for(size_t i = 0; i < count; i++)
+				p = PutVarint(p, PackedValue(LoadElement<T>(base + i * stride)));
+			return;
+		}
+	}
+
+	//Payload is the element type followed by the elements
+	const size_t length = count * sizeof(T) + 1;
+	if(length > UINT32_MAX)
+		throw StreamException(STREAM_ERR_LENGTH, STREAM_MSG_LENGTH);
+
+	char* p = extendSized(Type::ARRAY, (u_int32_t)length);
+	*p++ = (char)ArrayElement<T>::type;
+
+	//Contiguous elements are converted in bulk, others one at a time
+	if(stride == sizeof(T)) {
+		NetOrderCopy<T>(p, base, count);
+	}
+	else if constexpr(std::is_floating_point<T>::value) {
+		for(size_t i = 0; i < count; i++, p += sizeof(T))
+			NetOrderStore(p, LoadElement<T>(base + i * stride));
+	}
+	else {
+		for(size_t i = 0; i < count; i++, p += sizeof(T)) {
+			const T val = NetOrder(LoadElement<T>(base + i * stride));
+			memcpy(p, &val, sizeof(T));
+		}
+	}
+}
+
+/*!	@brief Write a buffer of char data to the stream as a binary blob
  *	@param buf A pointer to the data to write
  *	@param bytes The number of bytes to write from the pointer
  *	@return A reference to this stream
+ *	@throw StreamException if the blob exceeds the 32-bit length limit
  */
 NetStream& NetStream::write(const char* buf, const size_t bytes) {
-	//Size of size_t to push after buffer data
-	u_short byteslen = sizeof(bytes);
-	u_int64_t bufsize = buffer_.size()+bytes+byteslen+2;
-
-	//Reserve vector current length + buffer size + marker and length data
-	buffer_.reserve(bufsize);
-
-	//Push marker, copy buffer data for bytes size
-	buffer_.push_back(Type::UNKNOWN);
-
-	buffer_.assign(buf, buf+bytes);
-// 		Buffer_t::iterator i = buffer_.end();
-// 		buffer_.resize(bufsize);
-// 		memcpy(&(*i), buf, bytes);
-// 		i += bytes;
-
-	size_t encbytes = hton_t<size_t>(bytes);
-	u_short* p = (u_short*)&encbytes;
-	for(int count = 0; count < sizeof(encbytes); count++) {
-		buffer_.push_back(*p);
-		p++;
-	}
-	buffer_.push_back(Type::UNKNOWN);
+	//Blob length is encoded as an unsigned 32-bit value
+	if(bytes > UINT32_MAX)
+		throw StreamException(STREAM_ERR_LENGTH, STREAM_MSG_LENGTH);
+
+	appendSized(Type::BLOB, buf, (u_int32_t)bytes);
 	return *this;
 }
 
+/*!	@brief Write a binary blob that refers to the caller's buffer
+ *	@param buf A pointer to the data to reference
+ *	@param bytes The number of bytes to reference from the pointer
+ *	@return A reference to this stream
+ *	@throw StreamException if the stream would exceed the 32-bit length limit
+ */
+NetStream& NetStream::writeRef(const char* buf, const size_t bytes) {
+	appendBorrowed(Type::BLOB, buf, bytes);
+	return *this;
+}
 
-/*!	@brief Add char value to this data stream
- *	@param val Character value to append to the stream data
- *	@return Reference to this message stream
+/*!	@brief Write a string that refers to the caller's storage
+ *	@param val The string data to reference
+ *	@return A reference to this stream
+ *	@throw StreamException if the stream would exceed the 32-bit length limit
  */
-NetStream& NetStream::operator>>(char& val) {
-	//Declare local
-	Buffer_t::iterator  itr;
+NetStream& NetStream::stringRef(std::string_view val) {
+	appendBorrowed(Type::STRING, val.data(), val.length());
+	return *this;
+}
 
-	//point the iterator
-	itr = buffer_.end()-1;
+/*!	@brief Copy borrowed payloads into the stream's own storage */
+void NetStream::flatten() {
+	if(segments_.empty())
+		return;
 
-	//Validate the data
-	if( *itr != Type::CHAR || *(itr-(sizeof(char)+1)) != Type::CHAR ) {
-		throw StreamException( STREAM_ERR_INVALID_TYPE, STREAM_MSG_INVALID_TYPE);
+	//Declare local
+	size_t from = buffer_.size();
+	size_t to = totalSize();
+
+	//Grow the existing storage so pooled or inline capacity is kept, then
+	// open a gap for each payload working back from the end
+	buffer_.resize(to);
+	char* data = buffer_.data();
+	for(auto it = segments_.rbegin(); it != segments_.rend(); ++it) {
+		to -= from - it->offset;
+		memmove(data + to, data + it->offset, from - it->offset);
+		to -= it->bytes;
+		memcpy(data + to, it->data, it->bytes);
+		from = it->offset;
 	}
 
-	//Extract this value from the vector
-	itr--;                              //Move past the Type byte
-	val = (char)*itr;                   //Get the value after the Type
-	itr--;                              //Move to the end marker
-	buffer_.erase( itr, buffer_.end() );//Delete this value
+	segments_.clear();
+	borrowed_ = 0;
+}
+
+/*!	@brief Read a binary blob without copying it out of the stream
+ *	@param buf Receives a pointer to the first byte of blob data
+ *	@param bytes Receives the length of the blob in bytes
+ *	@return A reference to this stream
+ *	@throw StreamException if the stream order is not FIFO
+ */
+NetStream& NetStream::read(const char*& buf, size_t& bytes) {
+	//LIFO decode shrinks the buffer, the blob must stay in place
+	if(order_ != Order::FIFO)
+		throw StreamException(STREAM_ERR_INVALID_ORDER, STREAM_MSG_INVALID_ORDER);
+
+	NetStreamView reader(*this);
+	reader.read(buf, bytes);
+	commit(reader);
+	return *this;
+}
+
+/*!	@brief Read a binary blob into a caller-provided vector
+ *	@param buf Vector to receive the blob data, resized to the blob length
+ *	@return A reference to this stream
+ */
+NetStream& NetStream::read(std::vector<char>& buf) {
+	NetStreamView reader(*this);
+	reader.read(buf);
+	commit(reader);
+	return *this;
+}
+
+
+/*!	@brief Decode a user type implementing the Streamable interface
+ *	@param val The object to receive the decoded fields
+ *	@return Reference to this stream instance
+ *	@throw StreamException if the object's decode() does not consume
+ *		exactly the encoded length, or whatever decode() throws. The stream
+ *		is left unchanged either way.
+ */
+NetStream& NetStream::operator>>(Streamable &val) {
+	//Declare local
+	u_int32_t length;
+
+	//Validate both markers and the length before handing over to the object
+	const size_t start =
+		NetStreamView(*this).nextSized(Type::STREAMABLE, length) - buffer_.data();
+
+	if(order_ == Order::FIFO) {
+		//Read forward from the payload, then step over the closing marker.
+		// Forward reads leave the buffer intact, so only the offset is restored.
+		const u_int32_t head = head_;
+		head_ = start;
+		try {
+			val.decode(*this);
+			if(head_ != start + length)
+				throw StreamException(STREAM_ERR_INVALID_LENGTH, STREAM_MSG_INVALID_LENGTH);
+		}
+		catch(...) {
+			head_ = head;
+			throw;
+		}
+		head_++;
+	}
+	else {
+		//Read back through a copy of the payload, since LIFO reads shrink the
+		// buffer and the stream must be left untouched if decode() throws
+		NetStream payload(buffer_.data() + start, length, order_);
+		payload.setCompact(compact_);
+		val.decode(payload);
+		if(payload.remaining() != 0)
+			throw StreamException(STREAM_ERR_INVALID_LENGTH, STREAM_MSG_INVALID_LENGTH);
+		buffer_.resize(start - 1);
+	}
 
 	//Return reference to ourselves
 	return *this;
 }
 
-/*!	@brief Read and remove unsigned character value from this data stream
- *	@param val Unsigned character value to read from stream data
- *	@return Reference to this message stream
+/*!	@brief Decode an embedded sub-stream into another stream
+ *	@param val The stream to receive the sub-stream
+ *	@return Reference to this stream instance
  */
-NetStream& NetStream::operator>>(u_char& val)	{
+NetStream& NetStream::operator>>(NetStream &val) {
 	//Declare local
-	Buffer_t::iterator  itr;
+	NetStreamView reader(*this);
+	const char* p;
+	size_t length;
 
-	//point the iterator
-	itr = buffer_.end()-1;
+	reader.readStream(p, length);
 
-	//Validate the data
-	if( *itr != Type::UCHAR || *(itr-(sizeof(u_char)+1)) != Type::UCHAR ) {
-		throw StreamException( STREAM_ERR_INVALID_TYPE, STREAM_MSG_INVALID_TYPE);
+	//Replacing our own contents, copy the sub-stream out first
+	if(this == &val) {
+		Buffer_t sub(p, p + length);
+		setRaw((u_char*)sub.data(), length);
+		return *this;
 	}
 
-	//Extract this value from the vector
-	itr--;                              //Move past the Type byte
-	val = (u_char)*itr;                 //Get the value after the Type
-	itr--;                              //Move to the end marker
-	buffer_.erase( itr, buffer_.end() );//Delete this value
+	val.setRaw((u_char*)p, length);
+	commit(reader);
 
 	//Return reference to ourselves
 	return *this;
 }
 
-/*!	@brief Remove a 16-bit signed integer value from the data stream
- *	@param Signed 16-bit integer reference to receive the stream data
- *	@return A reference to this data stream
+/*!	@brief Read an embedded sub-stream without copying it
+ *	@param buf Receives a pointer to the first byte of the sub-stream
+ *	@param bytes Receives the length of the sub-stream in bytes
+ *	@return Reference to this stream instance
+ *	@throw StreamException if the stream order is not FIFO
  */
-NetStream& NetStream::operator>>(int16_t& val) {
-	//Declare local
-	u_char*							pIndex = (u_char*)&val;
-	Buffer_t::iterator	itr;
+NetStream& NetStream::readStream(const char*& buf, size_t& bytes) {
+	//LIFO decode shrinks the buffer, the sub-stream must stay in place
+	if(order_ != Order::FIFO)
+		throw StreamException(STREAM_ERR_INVALID_ORDER, STREAM_MSG_INVALID_ORDER);
+
+	NetStreamView reader(*this);
+	reader.readStream(buf, bytes);
+	commit(reader);
+	return *this;
+}
 
-	//point the iterator
-	itr = buffer_.end()-1;
+/*!	@brief Discard the next value without decoding it
+ *	@return Reference to this stream instance
+ *	@throw StreamException if the next value is not a recognised type
+ */
+NetStream& NetStream::skip() {
+	prepareDictionary();
+	NetStreamView reader(*this);
+	reader.skip();
+	commit(reader);
 
-	//Validate the data
-	if(*itr != Type::INT16 || *(itr-(sizeof(int16_t)+1)) != Type::INT16) {
-		throw StreamException(STREAM_ERR_INVALID_TYPE, STREAM_MSG_INVALID_TYPE);
-	}
+	//Return reference to ourselves
+	return *this;
+}
 
-	//Remove low byte first then remove high byte
-	itr--;                              //Move past the Type byte
-	pIndex++;                           //Move to the second byte in the int
- *pIndex = *itr; pIndex--; itr--;    //Get the high byte
- *pIndex = *itr;                     //Get the low byte
-	itr--;                              //Move to the end marker
-	buffer_.erase( itr, buffer_.end() );//Delete this value
+/*!	@brief Returns the encoded size of a Streamable, including its markers
+ *	@param val The object to measure
+ *	@return The object's encodedSize() plus the STREAMABLE value overhead
+ */
+u_int32_t NetStream::encodedSize(const Streamable& val) {
+	return val.encodedSize() + sizeof(u_int32_t) + 2;
+}
 
-	//Byte order the value
-	val = ntohs(val);
+/*!	@brief Decode an array value into a vector of integers
+ *	@param val Vector to receive the elements, resized to the element count
+ *	@return Reference to this stream instance
+ *	@throw StreamException if the element type does not match
+ */
+template<typename T>
+NetStream& NetStream::operator>>(std::vector<T>& val) {
+	NetStreamView reader(*this);
+	reader >> val;
+	commit(reader);
 
 	//Return reference to ourselves
 	return *this;
 }
 
-/*!	@brief Remove a 16-bit unsigned integer value from the data stream
- *	@param Unsigned 16-bit integer reference to receive the stream data
- *	@return A reference to this data stream
+/*!	@brief Decode an array value into a caller-provided buffer
+ *	@param buf Buffer to receive the elements
+ *	@param count On input the capacity of the buffer in elements, on
+ *		output the number of elements decoded
+ *	@return Reference to this stream instance
+ *	@throw StreamException if the element type does not match or the
+ *		buffer is too small, in which case nothing is consumed
  */
-NetStream& NetStream::operator>>(u_int16_t& val) {
-	//Declare local
-	u_char*							pIndex = (u_char*)&val;
-	Buffer_t::iterator	itr;
+template<typename T>
+NetStream& NetStream::read(T* buf, size_t& count) {
+	NetStreamView reader(*this);
+	reader.read(buf, count);
+	commit(reader);
 
-	//point the iterator
-	itr = buffer_.end()-1;
+	//Return reference to ourselves
+	return *this;
+}
 
-	//Validate the data
-	if(*itr != Type::UINT16 || *(itr-(sizeof(u_int16_t)+1)) != Type::UINT16) {
-		throw StreamException(STREAM_ERR_INVALID_TYPE, STREAM_MSG_INVALID_TYPE);
-	}
+/*!	@brief Read a char value from this data stream
+ *	@param val Character value to read from the stream data
+ *	@return Reference to this message stream
+ */
+NetStream& NetStream::operator>>(char& val) {
+	NetStreamView reader(*this);
+	reader >> val;
+	commit(reader);
 
-	//Remove low byte first then remove high byte
-	itr--;                              //Move past the Type byte
-	pIndex++;                           //Move to the second byte in the int
- *pIndex = *itr; pIndex--; itr--;    //Get the high byte
- *pIndex = *itr;                     //Get the low byte
-	itr--;                              //Move to the end marker
-	buffer_.erase( itr, buffer_.end() );//Delete this value
+	//Return reference to ourselves
+	return *this;
+}
 
-	//Byte order the value
-	val = ntohs(val);
+/*!	@brief Read unsigned character value from this data stream
+ *	@param val Unsigned character value to read from stream data
+ *	@return Reference to this message stream
+ */
+NetStream& NetStream::operator>>(u_char& val)	{
+	NetStreamView reader(*this);
+	reader >> val;
+	commit(reader);
 
 	//Return reference to ourselves
 	return *this;
 }
 
-/*!	@brief Remove a 32-bit signed integer value from the data stream
- *	@param Signed 32-bit integer reference to receive the stream data
+/*!	@brief Read a 16-bit signed integer value from the data stream
+ *	@param Signed 16-bit integer reference to receive the stream data
  *	@return A reference to this data stream
  */
-NetStream& NetStream::operator>>(int32_t& val) {
-	//Declare local
-	u_char*							pIndex = (u_char*)&val;
-	Buffer_t::iterator	itr;
+NetStream& NetStream::operator>>(int16_t& val) {
+	NetStreamView reader(*this);
+	reader >> val;
+	commit(reader);
 
-	//point the iterator
-	itr = buffer_.end()-1;
+	//Return reference to ourselves
+	return *this;
+}
 
-	//Validate the data
-	if(*itr != Type::INT32 || *(itr-(sizeof(int32_t)+1)) != Type::INT32) {
-		throw StreamException(STREAM_ERR_INVALID_TYPE, STREAM_MSG_INVALID_TYPE);
-	}
+/*!	@brief Read a 16-bit unsigned integer value from the data stream
+ *	@param Unsigned 16-bit integer reference to receive the stream data
+ *	@return A reference to this data stream
+ */
+NetStream& NetStream::operator>>(u_int16_t& val) {
+	NetStreamView reader(*this);
+	reader >> val;
+	commit(reader);
 
-	//Remove low byte first then remove high byte
-	itr--;                              //Move past the Type byte
-	pIndex+=3;                          //Move to the fourth byte in the long
-	for(u_int16_t count = 0; count < sizeof(int32_t); count++ ) {
-		(*pIndex) = (*itr); itr--; pIndex--;
-	}
-	buffer_.erase( itr, buffer_.end() );//Delete this value
+	//Return reference to ourselves
+	return *this;
+}
 
-	//Byte order the value
-	val = ntohl(val);
+/*!	@brief Read a 32-bit signed integer value from the data stream
+ *	@param Signed 32-bit integer reference to receive the stream data
+ *	@return A reference to this data stream
+ */
+NetStream& NetStream::operator>>(int32_t& val) {
+	NetStreamView reader(*this);
+	reader >> val;
+	commit(reader);
 
 	//Return reference to ourselves
 	return *this;
 }
 
-/*!	@brief Remove a 32-bit unsigned integer value from the data stream
+/*!	@brief Read a 32-bit unsigned integer value from the data stream
  *	@param Unsigned 32-bit integer reference to receive the stream data
  *	@return A reference to this data stream
  */
 NetStream& NetStream::operator>>(u_int32_t& val) {
-	//Declare local
-	u_char*							pIndex = (u_char*)&val;
-	Buffer_t::iterator	itr;
-
-	//point the iterator
-	itr = buffer_.end()-1;
-
-	//Validate the data
-	if(*itr != Type::UINT32 || *(itr-(sizeof(u_int32_t)+1)) != Type::UINT32) {
-		throw StreamException(STREAM_ERR_INVALID_TYPE, STREAM_MSG_INVALID_TYPE);
-	}
-
-	//Remove low byte first then remove high byte
-	itr--;                              //Move past the Type byte
-	pIndex+=3;                          //Move to the fourth byte in the long
-	for(u_int16_t count = 0; count < sizeof(u_int32_t); count++ ) {
-		(*pIndex) = (*itr); itr--; pIndex--;
-	}
-	buffer_.erase( itr, buffer_.end() );//Delete this value
-
-	//Byte order the value
-	val = ntohl(val);
+	NetStreamView reader(*this);
+	reader >> val;
+	commit(reader);
 
 	//Return reference to ourselves
 	return *this;
 }
 
-/*!	@brief Remove a 64-bit signed integer value from the data stream
+/*!	@brief Read a 64-bit signed integer value from the data stream
  *	@param Signed 64-bit integer reference to receive the stream data
  *	@return A reference to this data stream
  */
 NetStream& NetStream::operator>>(int64_t& val) {
-	//Declare local
-	u_char*							pIndex = (u_char*)&val;
-	Buffer_t::iterator	itr;
-
-	//point the iterator
-	itr = buffer_.end()-1;
-
-	//Validate the data
-	if(*itr != Type::INT64 || *(itr-(sizeof(int64_t)+1)) != Type::INT64) {
-		throw StreamException(STREAM_ERR_INVALID_TYPE, STREAM_MSG_INVALID_TYPE);
-	}
-
-	//Remove low byte first then remove high byte
-	itr--;                              //Move past the Type byte
-	pIndex+=7;                          //Move to the fourth byte in the long
-	for(u_int16_t count = 0; count < sizeof(int64_t); count++ ) {
-		(*pIndex) = (*itr); itr--; pIndex--;
-	}
-	buffer_.erase( itr, buffer_.end() );//Delete this value
-
-	//Byte order the value
-	val = ntohll(val);
+	NetStreamView reader(*this);
+	reader >> val;
+	commit(reader);
 
 	//Return reference to ourselves
 	return *this;
 }
 
-/*!	@brief Remove a 64-bit unsigned integer value from the data stream
+/*!	@brief Read a 64-bit unsigned integer value from the data stream
  *	@param Unsigned 64-bit integer reference to receive the stream data
  *	@return A reference to this data stream
  */
 NetStream& NetStream::operator>>(u_int64_t& val) {
-	//Declare local
-	u_char*							pIndex = (u_char*)&val;
-	Buffer_t::iterator	itr;
+	NetStreamView reader(*this);
+	reader >> val;
+	commit(reader);
 
-	//point the iterator
-	itr = buffer_.end()-1;
+	//Return reference to ourselves
+	return *this;
+}
 
-	//Validate the data
-	if(*itr != Type::UINT64 || *(itr-(sizeof(u_int64_t)+1)) != Type::UINT64) {
-		throw StreamException(STREAM_ERR_INVALID_TYPE, STREAM_MSG_INVALID_TYPE);
-	}
+/*!	@brief Read a single precision floating-point value from the data stream
+ *	@param 32-bit floating-point reference to receive the stream data
+ *	@return A reference to this data stream
+ */
+NetStream& NetStream::operator>>(float& val) {
+	NetStreamView reader(*this);
+	reader >> val;
+	commit(reader);
 
-	//Remove low byte first then remove high byte
-	itr--;                              //Move past the Type byte
-	pIndex+=7;                          //Move to the fourth byte in the long
-	for(u_int16_t count = 0; count < sizeof(u_int64_t); count++ ) {
-		(*pIndex) = (*itr); itr--; pIndex--;
-	}
-	buffer_.erase( itr, buffer_.end() );//Delete this value
+	//Return reference to ourselves
+	return *this;
+}
 
-	//Byte order the value
-	val = ntohll(val);
-	//val = hton_t<u_int64_t>(val);
+/*!	@brief Read a double precision floating-point value from the data stream
+ *	@param 64-bit floating-point reference to receive the stream data
+ *	@return A reference to this data stream
+ */
+NetStream& NetStream::operator>>(double& val) {
+	NetStreamView reader(*this);
+	reader >> val;
+	commit(reader);
 
 	//Return reference to ourselves
 	return *this;
 }
 
-/*!	@brief
+/*!	@brief Decode a std::string from stream data
+ *	@param val A reference to std:string to hold decoded string data
+ *	@return Reference to this stream instance
  */
 NetStream& NetStream::operator>>(std::string &val) {
-	//Declare local
-	Buffer_t::iterator itr;
-	u_int32_t count;
-	u_int32_t length;
-	u_int8_t* pIndex = (u_int8_t*)&length;
+	prepareDictionary();
+	NetStreamView reader(*this);
+	reader >> val;
+	commit(reader);
 
-	//point the iterator
-	itr = buffer_.end()-1;
+	//Return reference to ourselves
+	return *this;
+}
 
-	//Validate the data
-	if( *itr != Type::STRING )
-		throw StreamException( STREAM_ERR_INVALID_TYPE, STREAM_MSG_INVALID_TYPE);
+/*!	@brief Decode a string without copying it out of the stream
+ *	@param val Receives a view of the string data
+ *	@return Reference to this stream instance
+ *	@throw StreamException if the stream order is not FIFO
+ */
+NetStream& NetStream::operator>>(std::string_view &val) {
+	//LIFO decode shrinks the buffer, the string must stay in place
+	if(order_ != Order::FIFO)
+		throw StreamException(STREAM_ERR_INVALID_ORDER, STREAM_MSG_INVALID_ORDER);
 
-	//Move past the Type
-	itr--;
+	prepareDictionary();
+	NetStreamView reader(*this);
+	reader >> val;
+	commit(reader);
 
-	//Get the length value from the vector and fix byte-ordering
-	pIndex += 3;
-	for(count = 0; count < sizeof(u_int32_t); count++) {
-		*pIndex = (u_int8_t)(*itr);
-		itr--; pIndex--;
-	}
-	length = ntohl(length);
+	//Return reference to ourselves
+	return *this;
+}
 
-	//Check the size against the pointer and check for type at the end
-	if( *(itr-length) != Type::STRING )
-		throw StreamException( STREAM_ERR_INVALID_TYPE,STREAM_MSG_INVALID_TYPE);
+/*!	@brief Grow the buffer for a value of known encoded size
+ *	@param bytes The number of bytes to add to the end of the stream
+ *	@return Pointer to the first of the added bytes
+ */
+char* NetStream::extend(const size_t bytes) {
+	//Single resize, growth is amortized by the vector
+	const size_t offset = buffer_.size();
+	buffer_.resize(offset + bytes);
+	return buffer_.data() + offset;
+}
+
+/*!	@brief Append a fixed-width value wrapped in type markers
+ *	@param type The type marker to write on either side of the payload
+ *	@param payload Pointer to payload bytes, already in network byte order
+ *	@param bytes The width of the payload in bytes
+ */
+void NetStream::append(const Type type, const void* payload, const size_t bytes) {
+	char* p = extend(bytes + 2);
+	p[0] = (char)type;
+	memcpy(p + 1, payload, bytes);
+	p[bytes + 1] = (char)type;
+}
+
+/*!	@brief Append a length-prefixed value wrapped in type markers
+ *	The length is placed ahead of the payload in FIFO streams and after it in
+ *	LIFO streams, matching the layout expected by nextSized().
+ *	@param type The type marker to write on either side of the value
+ *	@param payload Pointer to the payload bytes
+ *	@param length The length of the payload in bytes
+ */
+void NetStream::appendSized(const Type type, const void* payload, const u_int32_t length) {
+	memcpy(extendSized(type, length), payload, length);
+}
+
+/*!	@brief Append the markers and length of a length-prefixed value
+ *	@param type The type marker to write on either side of the value
+ *	@param length The length of the payload in bytes
+ *	@return Pointer to the payload bytes, to be filled in by the caller
+ */
+char* NetStream::extendSized(const Type type, const u_int32_t length) {
+	//Declare local
+	const u_int32_t netlength = NetOrder(length);
+	char* p = extend(length + sizeof(u_int32_t) + 2);
+	char* payload;
 
-	//Allocate buffer for string
-	std::unique_ptr<u_char[]> pBuffer(new u_char[length+1]);
-	memset(pBuffer.get(), 0x00, length + 1);
+	//Push the type indicators (head and tail)
+	p[0] = (char)type;
+	p[length + sizeof(u_int32_t) + 1] = (char)type;
 
-	//Get the string from the vector
-	for(count = length; count > 0; count--) {
-		*(pBuffer.get() + count - 1) = (*itr);
-		itr--;
+	if(order_ == Order::FIFO) {
+		memcpy(p + 1, &netlength, sizeof(u_int32_t));
+		payload = p + 1 + sizeof(u_int32_t);
+	}
+	else {
+		memcpy(p + 1 + length, &netlength, sizeof(u_int32_t));
+		payload = p + 1;
 	}
 
-	//Erase the vector contents
-	buffer_.erase( itr, buffer_.end() );//Delete this value
+	return payload;
+}
 
-	//Assign value
-	val = std::string((char*)pBuffer.get());
+/*!	@brief Append an unsigned value as an LEB128 varint wrapped in type markers
+ *	Seven bits are stored per byte, least significant group first, with the
+ *	high bit set on every byte except the last.
+ *	@param type The type marker to write on either side of the varint
+ *	@param val The value to encode
+ */
+void NetStream::appendVarint(const Type type, u_int64_t val) {
+	char* p = extend(VarintSize(val) + 2);
 
-	//Return reference to ourselves
-	return *this;
+	*p++ = (char)type;
+	p = PutVarint(p, val);
+	*p = (char)type;
 }
 
-/*!	@brief Generic parameterized byte-ordering function
- *	@type input T& value to be converted to network byte order
- *	@return Input value converted to network byte order
- * TODO: Not currently being used
+/*!	@brief Append a length-prefixed value whose payload is borrowed
+ *	The markers and length are written to our storage as usual, and the
+ *	payload is recorded as a segment spliced in at the point it belongs.
+ *	@param type The type marker to write on either side of the value
+ *	@param payload Pointer to the payload bytes
+ *	@param length The length of the payload in bytes
+ *	@throw StreamException if the stream would exceed the 32-bit length limit
  */
-template<typename T>
-T NetStream::hton_t(const T& input) {
-	T output(0);
-	const std::size_t size = sizeof(input);
-	uint8_t *data = reinterpret_cast<uint8_t *>(&output);
+void NetStream::appendBorrowed(const Type type, const char* payload, const size_t length) {
+	//Declare local
+	char* p;
+	u_int32_t offset;
 
-	for (std::size_t i = 0; i < size; i++) {
-		data[i] = input >> ((size - i - 1) * 8);
+	//Short payloads are cheaper to copy than to gather
+	if(length < MIN_BORROWED_BYTES) {
+		appendSized(type, payload, length);
+		return;
 	}
 
-	return output;
+	if((size_t)totalSize() + length + sizeof(u_int32_t) + 2 > UINT32_MAX)
+		throw StreamException(STREAM_ERR_LENGTH, STREAM_MSG_LENGTH);
+	const u_int32_t netlength = NetOrder((u_int32_t)length);
+
+	if(order_ == Order::FIFO) {
+		//[type][length] <payload> [type]
+		p = extend(1 + sizeof(u_int32_t));
+		p[0] = (char)type;
+		memcpy(p + 1, &netlength, sizeof(u_int32_t));
+		offset = buffer_.size();
+		extend(1)[0] = (char)type;
+	}
+	else {
+		//[type] <payload> [length][type]
+		extend(1)[0] = (char)type;
+		offset = buffer_.size();
+		p = extend(sizeof(u_int32_t) + 1);
+		memcpy(p, &netlength, sizeof(u_int32_t));
+		p[sizeof(u_int32_t)] = (char)type;
+	}
+
+	segments_.push_back({ offset, payload, (u_int32_t)length });
+	borrowed_ += length;
 }
 
-/*!	@brief Convert 64-bit value to network byte order
- *	@param val 64-bit value to be converted
- *	@return The value provided, converted to network byte order
+/*!	@brief Copy the encoded stream, with borrowed payloads spliced in
+ *	@param dst Destination with room for the bytes from offset onward
+ *	@param offset Storage offset of the first byte to copy
  */
-uint64_t NetStream::htonll(uint64_t value) {
-	static const int num = 42;
-	if (*reinterpret_cast<const char*>(&num) != num)
-		return value;
+void NetStream::copyTo(char* dst, const u_int32_t offset) const {
+	//Declare local
+	u_int32_t from = offset;
+
+	for(const Segment& segment : segments_) {
+		if(segment.offset < from)
+			continue;
+		memcpy(dst, buffer_.data() + from, segment.offset - from);
+		dst += segment.offset - from;
+		memcpy(dst, segment.data, segment.bytes);
+		dst += segment.bytes;
+		from = segment.offset;
+	}
+	memcpy(dst, buffer_.data() + from, buffer_.size() - from);
+}
+
+/*!	@brief Append a string through the string dictionary
+ *	A string already in the dictionary is written as an INTERN_REF varint
+ *	holding its index. A new string is added and written as an INTERNED
+ *	value whose payload is its index, as a varint, followed by the bytes.
+ *	@param val The string to encode
+ *	@throw StreamException if the stream order is not FIFO
+ */
+void NetStream::appendInterned(const std::string& val) {
+	//Declare local
+	bool added;
 
-	const uint32_t high_part = htonl(static_cast<uint32_t>(value >> 32));
-	const uint32_t low_part = htonl(static_cast<uint32_t>(value & 0xFFFFFFFFLL));
+	if(order_ != Order::FIFO)
+		throw StreamException(STREAM_ERR_INVALID_ORDER, STREAM_MSG_INVALID_ORDER);
+	if(val.length() > UINT32_MAX - VARINT_MAX_BYTES)
+		throw StreamException(STREAM_ERR_LENGTH, STREAM_MSG_LENGTH);
 
-	return (static_cast<uint64_t>(low_part) << 32) | high_part;
+	const u_int32_t index = dictionary_->add(val, added);
+	if(!added) {
+		appendVarint(Type::INTERN_REF, index);
+		return;
+	}
+
+	char* p = extendSized(Type::INTERNED, VarintSize(index) + val.length());
+	p = PutVarint(p, index);
+	memcpy(p, val.data(), val.length());
 }
 
-/*!	@brief Convert 64-bit value from network to host byte order
- *	@param val 64-bit value to be converted
- *	@return The value provided, converted to host byte order
+/*!	@brief Create the string dictionary if the next value defines an interned string
+ *	Lets a stream decode interned strings without interning being enabled.
  */
-uint64_t NetStream::ntohll(uint64_t value) {
-	static const int num = 42;
-	if (*reinterpret_cast<const char*>(&num) != num)
-		return value;
+void NetStream::prepareDictionary() {
+	if(!dictionary_ && remaining() > 0 && peek() == Type::INTERNED)
+		dictionary_.reset(new StringDictionary());
+}
 
-	const uint32_t high_part = ntohl(static_cast<uint32_t>(value >> 32));
-	const uint32_t low_part = ntohl(static_cast<uint32_t>(value & 0xFFFFFFFFLL));
+/*!	@brief Take over the contents of another stream's buffer
+ *	@param other The buffer to take over, left empty
+ */
+void NetStream::adopt(Buffer_t& other) {
+	if(other.get_allocator().owns(other.data())) {
+		buffer_.assign(other.begin(), other.end());
+		other.clear();
+	}
+	else {
+		//Allocators compare equal, so the heap storage is moved as-is
+		buffer_ = std::move(other);
+	}
+}
 
-	return (static_cast<uint64_t>(low_part) << 32) | high_part;
+/*!	@brief Consume the values decoded by a view of this stream
+ *	@param reader A view constructed from this stream
+ */
+void NetStream::commit(const NetStreamView& reader) {
+	if(order_ == Order::FIFO)
+		head_ = reader.head_ - buffer_.data();
+	else
+		buffer_.resize(reader.tail_ - buffer_.data());
 }
+
+//Array encode/decode for the supported element types
+template NetStream& NetStream::operator<<(const std::vector<char>& val);
+template NetStream& NetStream::operator<<(const std::vector<u_char>& val);
+template NetStream& NetStream::operator<<(const std::vector<int16_t>& val);
+template NetStream& NetStream::operator<<(const std::vector<u_int16_t>& val);
+template NetStream& NetStream::operator<<(const std::vector<int32_t>& val);
+template NetStream& NetStream::operator<<(const std::vector<u_int32_t>& val);
+template NetStream& NetStream::operator<<(const std::vector<int64_t>& val);
+template NetStream& NetStream::operator<<(const std::vector<u_int64_t>& val);
+template NetStream& NetStream::operator<<(const std::vector<float>& val);
+template NetStream& NetStream::operator<<(const std::vector<double>& val);
+template void NetStream::appendArray<char>(const char*, const size_t, const size_t);
+template void NetStream::appendArray<u_char>(const char*, const size_t, const size_t);
+template void NetStream::appendArray<int16_t>(const char*, const size_t, const size_t);
+template void NetStream::appendArray<u_int16_t>(const char*, const size_t, const size_t);
+template void NetStream::appendArray<int32_t>(const char*, const size_t, const size_t);
+template void NetStream::appendArray<u_int32_t>(const char*, const size_t, const size_t);
+template void NetStream::appendArray<int64_t>(const char*, const size_t, const size_t);
+template void NetStream::appendArray<u_int64_t>(const char*, const size_t, const size_t);
+template void NetStream::appendArray<float>(const char*, const size_t, const size_t);
+template void NetStream::appendArray<double>(const char*, const size_t, const size_t);
+template NetStream& NetStream::operator>>(std::vector<char>& val);
+template NetStream& NetStream::operator>>(std::vector<u_char>& val);
+template NetStream& NetStream::operator>>(std::vector<int16_t>& val);
+template NetStream& NetStream::operator>>(std::vector<u_int16_t>& val);
+template NetStream& NetStream::operator>>(std::vector<int32_t>& val);
+template NetStream& NetStream::operator>>(std::vector<u_int32_t>& val);
+template NetStream& NetStream::operator>>(std::vector<int64_t>& val);
+template NetStream& NetStream::operator>>(std::vector<u_int64_t>& val);
+template NetStream& NetStream::operator>>(std::vector<float>& val);
+template NetStream& NetStream::operator>>(std::vector<double>& val);
+template NetStream& NetStream::read(char* buf, size_t& count);
+template NetStream& NetStream::read(u_char* buf, size_t& count);
+template NetStream& NetStream::read(int16_t* buf, size_t& count);
+template NetStream& NetStream::read(u_int16_t* buf, size_t& count);
+template NetStream& NetStream::read(int32_t* buf, size_t& count);
+template NetStream& NetStream::read(u_int32_t* buf, size_t& count);
+template NetStream& NetStream::read(int64_t* buf, size_t& count);
+template NetStream& NetStream::read(u_int64_t* buf, size_t& count);
+template NetStream& NetStream::read(float* buf, size_t& count);
+template NetStream& NetStream::read(double* buf, size_t& count);
 } //Inet namespace end
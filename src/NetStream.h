@@ -26,15 +26,36 @@
 //Library includes
 #include <vector>
 #include <string>
+#include <string_view>
+#include <memory>
 
 //Project includes
+#include "StreamAllocator.h"
+#include "StringDictionary.h"
 
 //Namespace container
 namespace Inet {
 
+//Required for schema friend relationship
+template<typename Message, typename... Fields> class Schema;
+template<typename Message, typename... Fields> class ColumnBatch;
+
+//User type serialization interface, see Streamable.h
+class Streamable;
+
+//Read-only decoder, see NetStreamView.h
+class NetStreamView;
+
+//Reusable buffer storage, see BufferPool.h
+class BufferPool;
+
 /*!	@brief Message class for sending data over network sockets
  */
 class NetStream {
+	template<typename Message, typename... Fields> friend class Schema;
+	template<typename Message, typename... Fields> friend class ColumnBatch;
+	friend class NetStreamView;
+
 public:
 	/*! @brief Encoded data type markers for built-ins and primatives */
 	enum Type : u_short {
@@ -46,14 +67,47 @@ public:
 		UINT32			= 'L',
 		INT64				= 'w',
 		UINT64			= 'W',
+		FLOAT32			= 'f',
+		FLOAT64			= 'd',
+		VARINT			= 'v',
+		ZIGZAG			= 'z',
 		STRING			= 's',
+		INTERNED		= 'n',
+		INTERN_REF	= 'N',
+		BLOB				= 'B',
+		ARRAY				= 'A',
 		STREAM			= 'S',
 		STREAMABLE	= 'M',
 		UNKNOWN			= 'X'
 	};
 
+	/*!	@brief Order in which encoded values are read back from the stream
+	 *	LIFO streams decode from the tail, consuming the most recently written
+	 *	value first. FIFO streams decode from a read offset in the order the
+	 *	values were written, leaving the buffer intact.
+	 */
+	enum class Order : u_short {
+		LIFO,
+		FIFO
+	};
+
 	///Typedefs local to class
-	typedef std::vector<char>						Buffer_t;
+	typedef std::vector<char, StreamAllocator<char>>	Buffer_t;
+
+	/*!	@brief Borrowed payload spliced into the stream's own storage
+	 *	The borrowed bytes belong in the encoded stream immediately before
+	 *	the byte at offset in the stream's storage.
+	 */
+	struct Segment {
+		u_int32_t			offset;		///< Storage offset the payload is spliced in at
+		const char*		data;			///< First byte of the borrowed payload
+		u_int32_t			bytes;		///< Length of the borrowed payload
+	};
+
+	/*!	@brief Payloads shorter than this are copied rather than borrowed,
+	 *	since a separate gather entry costs more than copying them
+	 */
+	static constexpr size_t MIN_BORROWED_BYTES = 4096;
 
 public:
 	/*!	@brief Class constructor */
@@ -62,8 +116,20 @@ public:
 	/*!	@brief Construct with pre-allocated storage */
 	explicit NetStream(const size_t bytes) { buffer_.reserve(bytes); }
 
+	/*!	@brief Construct an empty stream using the specified decode order */
+	explicit NetStream(const Order order) : order_(order) {}
+
+	/*!	@brief Construct an empty stream with storage taken from a pool
+	 *	The storage is returned to the pool when the stream is destroyed, so
+	 *	the pool must outlive the stream.
+	 *	@param pool The pool to take storage from
+	 *	@param order The order in which values will be decoded
+	 */
+	explicit NetStream(BufferPool& pool, const Order order = Order::LIFO);
+
 	/*!	@brief Initialize the stream with raw data */
-	explicit NetStream(const char *data, const size_t bytes);
+	explicit NetStream(const char *data, const size_t bytes,
+		const Order order = Order::LIFO);
 
 	/*!	@brief Copy constructor, delete default */
 	NetStream(const NetStream& other) = delete;
@@ -80,12 +146,83 @@ public:
 	/*!	@brief Destructor */
 	virtual ~NetStream();
 
-	/*!	@brief Returns the size of the storage vector in bytes */
+	/*!	@brief Returns the size of the storage vector in bytes
+	 *	Borrowed payloads are not included, see totalSize().
+	 */
 	inline u_int32_t size() const { return buffer_.size(); }
 
+	/*!	@brief Returns the encoded size in bytes, including borrowed payloads */
+	inline u_int32_t totalSize() const { return buffer_.size() + borrowed_; }
+
+	/*!	@brief Returns the borrowed payloads, in stream order */
+	inline const std::vector<Segment>& segments() const { return segments_; }
+
+	/*!	@brief Pre-allocate storage for at least the given number of bytes */
+	inline void reserve(const size_t bytes) { buffer_.reserve(bytes); }
+
 	/*!	@brief Returns a const reference to the internal data vector */
 	inline const Buffer_t& data() const { return buffer_; }
 
+	/*!	@brief Returns the order in which values are decoded from this stream */
+	inline Order order() const { return order_; }
+
+	/*!	@brief Set the decode order for this stream
+	 *	The order also determines the layout of variable length values, so it
+	 *	should be set before any values are encoded and match the peer's order.
+	 *	@param order The new stream order
+	 */
+	inline void setOrder(const Order order) { order_ = order; }
+
+	/*!	@brief Returns true if integers are written using the compact encoding */
+	inline bool compact() const { return compact_; }
+
+	/*!	@brief Select compact encoding for integer values written to the stream
+	 *	Compact streams write 16, 32 and 64-bit integers as LEB128 varints
+	 *	(VARINT), zigzag mapped first when signed (ZIGZAG). Decoding accepts
+	 *	either form regardless of this setting, so both can be mixed.
+	 *	@param compact True to write compact integers, false for fixed-width
+	 */
+	inline void setCompact(const bool compact) { compact_ = compact; }
+
+	/*!	@brief Returns true if strings are written through the string dictionary */
+	inline bool interning() const { return interning_; }
+
+	/*!	@brief Write strings through a per-stream dictionary
+	 *	The first occurrence of each string is written in full as an INTERNED
+	 *	value and numbered, later occurrences as an INTERN_REF value holding
+	 *	only the number as a varint. Decoding accepts interned strings
+	 *	regardless of this setting. The dictionary lasts until the stream's
+	 *	contents are replaced with setRaw() or prepareRaw().
+	 *	Only available to FIFO streams, since a reader must see each string's
+	 *	first occurrence before any reference to it.
+	 *	@param interning True to intern strings, false to write them in full
+	 *	@throw StreamException if interning is enabled on a LIFO stream
+	 */
+	void setInterning(const bool interning);
+
+	/*!	@brief Returns the offset of the next value to be read in a FIFO stream */
+	inline u_int32_t offset() const { return head_; }
+
+	/*!	@brief Returns the number of bytes not yet consumed by decoding,
+	 *	including borrowed payloads
+	 */
+	inline u_int32_t remaining() const { return buffer_.size() + borrowed_ - head_; }
+
+	/*!	@brief Move the FIFO read offset
+	 *	Offsets below offset() rewind to values already decoded. A stream
+	 *	holding borrowed payloads must be flattened first.
+	 *	@param offset Byte offset of the next value to decode
+	 *	@throw StreamException if the stream is not FIFO, holds borrowed
+	 *		payloads or the offset is past the end of the stream
+	 */
+	void seek(const u_int32_t offset);
+
+	/*!	@brief Returns the type marker of the next value to be decoded
+	 *	@return The marker of the next value
+	 *	@throw StreamException if no data remains in the stream
+	 */
+	Type peek() const;
+
 	/*!	@brief Set raw data in the internal vector
 	 *	@param data Pointer to data buffer to encode
 	 *	@param	size The size of the data buffer
@@ -93,6 +230,14 @@ public:
 	 */
 	int32_t setRaw( u_char* data, u_int32_t size );
 
+	/*!	@brief Replace the contents with storage for raw data to be filled in
+	 *	Lets a caller such as a socket read a frame straight into the stream
+	 *	without an intermediate buffer. Decoding starts from the beginning.
+	 *	@param size The size of the raw data in bytes
+	 *	@return Pointer to size bytes of storage for the caller to fill
+	 */
+	char* prepareRaw(const u_int32_t size);
+
 	/*!	@brief Add char value to this data stream
 	 *	@param val Character value to append to the stream data
 	 *	@return Reference to this message stream
@@ -141,19 +286,134 @@ public:
 	 */
 	virtual NetStream& operator<<(const u_int64_t& val);
 
+	/*!	@brief Append single precision floating-point value to stream data
+	 *	The IEEE-754 bit pattern is written in network byte order, so the
+	 *	value, including NaN payloads and signed zero, is carried exactly.
+	 *	@param val 32-bit floating-point value
+	 *	@return A reference to this stream instance
+	 */
+	virtual NetStream& operator<<(const float& val);
+
+	/*!	@brief Append double precision floating-point value to stream data
+	 *	@param val 64-bit floating-point value
+	 *	@return A reference to this stream instance
+	 */
+	virtual NetStream& operator<<(const double& val);
+
 	/*!	@brief Encode a std::string to stream data
 	 *	@param val A const reference to std:string to encode
 	 *	@return Reference to this stream instance
 	 */
 	virtual NetStream& operator<<(const std::string &val);
 
-	/*!	@brief Write a buffer of char data to the stream
+	/*!	@brief Encode a user type implementing the Streamable interface
+	 *	The object's fields are wrapped in a single length-prefixed STREAMABLE
+	 *	value. Storage for the whole object is reserved up front from its
+	 *	encodedSize(), so nested values do not grow the buffer repeatedly.
+	 *	@param val The object to encode
+	 *	@return Reference to this stream instance
+	 *	@throw StreamException if the encoded object exceeds 32-bit length
+	 */
+	virtual NetStream& operator<<(const Streamable &val);
+
+	/*!	@brief Embed the unread contents of another stream as a single value
+	 *	The bytes are copied as one length-prefixed STREAM value, so a reader
+	 *	can skip the whole sub-stream in constant time or hand it on intact.
+	 *	@param val The stream to embed, left unchanged
+	 *	@return Reference to this stream instance
+	 *	@throw StreamException if the sub-stream exceeds 32-bit length
+	 */
+	virtual NetStream& operator<<(const NetStream &val);
+
+	/*!	@brief Write a buffer of char data to the stream as a binary blob
 	 *	@param buf A pointer to the data to write
 	 *	@param bytes The number of bytes to write from the pointer
 	 *	@return A reference to this stream
+	 *	@throw StreamException if the blob exceeds the 32-bit length limit
 	 */
 	virtual NetStream& write(const char* buf, const size_t bytes);
 
+	/*!	@brief Read a binary blob without copying it out of the stream
+	 *	The pointer refers to the stream's own storage and remains valid until
+	 *	the stream is next modified. Only available to FIFO streams, since a
+	 *	LIFO read releases the blob's storage as it is decoded.
+	 *	@param buf Receives a pointer to the first byte of blob data
+	 *	@param bytes Receives the length of the blob in bytes
+	 *	@return A reference to this stream
+	 *	@throw StreamException if the stream order is not FIFO
+	 */
+	virtual NetStream& read(const char*& buf, size_t& bytes);
+
+	/*!	@brief Read a binary blob into a caller-provided vector
+	 *	@param buf Vector to receive the blob data, resized to the blob length
+	 *	@return A reference to this stream
+	 */
+	virtual NetStream& read(std::vector<char>& buf);
+
+	/*!	@brief Write a binary blob that refers to the caller's buffer
+	 *	Only the blob's markers and length are stored in the stream. The
+	 *	payload stays in the caller's buffer and is sent from there by
+	 *	ConnectionEndpoint::sendStream() with a single gather write, so it is
+	 *	never copied in user space. The encoded blob is identical to one
+	 *	written with write(), so the receiver decodes it as usual.
+	 *
+	 *	The buffer must stay valid and unchanged until the stream has been
+	 *	sent, flattened, cleared with setRaw() or prepareRaw(), or destroyed.
+	 *	A stream holding borrowed payloads cannot be decoded until flatten()
+	 *	copies them in. Payloads shorter than MIN_BORROWED_BYTES are copied
+	 *	straight away, and carry no lifetime requirement.
+	 *	@param buf A pointer to the data to reference
+	 *	@param bytes The number of bytes to reference from the pointer
+	 *	@return A reference to this stream
+	 *	@throw StreamException if the stream would exceed the 32-bit length limit
+	 */
+	NetStream& writeRef(const char* buf, const size_t bytes);
+
+	/*!	@brief Write a string that refers to the caller's storage
+	 *	Encoded as an ordinary STRING value, never interned, with the same
+	 *	lifetime requirement as writeRef().
+	 *	@param val The string data to reference
+	 *	@return A reference to this stream
+	 *	@throw StreamException if the stream would exceed the 32-bit length limit
+	 */
+	NetStream& stringRef(std::string_view val);
+
+	/*!	@brief Copy borrowed payloads into the stream's own storage
+	 *	Afterwards the stream no longer refers to any caller's buffer and can
+	 *	be decoded. Does nothing if no payloads are borrowed.
+	 */
+	void flatten();
+
+	/*!	@brief Decode an array value into a vector of integers or floats
+	 *	@param val Vector to receive the elements, resized to the element count
+	 *	@return Reference to this stream instance
+	 *	@throw StreamException if the element type does not match
+	 */
+	template<typename T> NetStream& operator>>(std::vector<T>& val);
+
+	/*!	@brief Decode an array value into a caller-provided buffer
+	 *	@param buf Buffer to receive the elements
+	 *	@param count On input the capacity of the buffer in elements, on
+	 *		output the number of elements decoded
+	 *	@return Reference to this stream instance
+	 *	@throw StreamException if the element type does not match or the
+	 *		buffer is too small, in which case nothing is consumed
+	 */
+	template<typename T> NetStream& read(T* buf, size_t& count);
+
+	/*!	@brief Encode a vector of integers or floats as a single array value
+	 *	Supported element types are char, unsigned char, the signed and
+	 *	unsigned 16, 32 and 64-bit integers, float and double. The array is
+	 *	written as one ARRAY record holding the element type followed by the
+	 *	elements in network byte order, the element count being implied by the
+	 *	record length. Compact streams pack 16, 32 and 64-bit integer elements
+	 *	as varints instead, marked with an element type of VARINT or ZIGZAG.
+	 *	@param val The values to encode
+	 *	@return Reference to this stream instance
+	 *	@throw StreamException if the array exceeds the 32-bit length limit
+	 */
+	template<typename T> NetStream& operator<<(const std::vector<T>& val);
+
 	/*!	@brief Add char value to this data stream
 	 *	@param val Character value to append to the stream data
 	 *	@return Reference to this message stream
@@ -202,34 +462,246 @@ public:
 	 */
 	virtual NetStream& operator>>(u_int64_t& val);
 
+	/*!	@brief Read and remove single precision floating-point value from this data stream
+	 *	@param val Reference to 32-bit floating-point value to read from stream data
+	 *	@return Reference to this message stream
+	 */
+	virtual NetStream& operator>>(float& val);
+
+	/*!	@brief Read and remove double precision floating-point value from this data stream
+	 *	@param val Reference to 64-bit floating-point value to read from stream data
+	 *	@return Reference to this message stream
+	 */
+	virtual NetStream& operator>>(double& val);
+
 	/*!	@brief Decode a std::string from stream data
+	 *	The bytes are assigned into val, reusing its capacity, and may include
+	 *	embedded NUL characters.
 	 *	@param val A const reference to std:string to hold decoded string data
 	 *	@return Reference to this stream instance
 	 */
 	virtual NetStream& operator>>(std::string &val);
 
+	/*!	@brief Decode a string without copying it out of the stream
+	 *	The view refers to the stream's own storage and remains valid until
+	 *	the stream is next modified. Only available to FIFO streams, since a
+	 *	LIFO read releases the string's storage as it is decoded. Interned
+	 *	strings are viewed in the stream's dictionary instead, and remain
+	 *	valid until the stream's contents are replaced.
+	 *	@param val Receives a view of the string data
+	 *	@return Reference to this stream instance
+	 *	@throw StreamException if the stream order is not FIFO
+	 */
+	virtual NetStream& operator>>(std::string_view &val);
+
+	/*!	@brief Decode a user type implementing the Streamable interface
+	 *	@param val The object to receive the decoded fields
+	 *	@return Reference to this stream instance
+	 *	@throw StreamException if the object's decode() does not consume
+	 *		exactly the encoded length, or whatever decode() throws, leaving
+	 *		the stream unchanged
+	 */
+	virtual NetStream& operator>>(Streamable &val);
+
+	/*!	@brief Decode an embedded sub-stream into another stream
+	 *	The sub-stream's bytes replace the contents of val, which keeps its
+	 *	own order setting and is read from the beginning.
+	 *	@param val The stream to receive the sub-stream
+	 *	@return Reference to this stream instance
+	 */
+	virtual NetStream& operator>>(NetStream &val);
+
+	/*!	@brief Read an embedded sub-stream without copying it
+	 *	The pointer refers to this stream's storage and remains valid until the
+	 *	stream is next modified. Only available to FIFO streams.
+	 *	@param buf Receives a pointer to the first byte of the sub-stream
+	 *	@param bytes Receives the length of the sub-stream in bytes
+	 *	@return Reference to this stream instance
+	 *	@throw StreamException if the stream order is not FIFO
+	 */
+	virtual NetStream& readStream(const char*& buf, size_t& bytes);
+
+	/*!	@brief Discard the next value without decoding it
+	 *	Length-prefixed values (strings, blobs, arrays, sub-streams and
+	 *	streamables) are skipped in constant time using their length.
+	 *	@return Reference to this stream instance
+	 *	@throw StreamException if the next value is not a recognised type
+	 */
+	NetStream& skip();
+
+	/*!	@name Encoded size calculation
+	 *	Return the number of bytes the value occupies when encoded, including
+	 *	type markers, for use by Streamable::encodedSize() implementations.
+	 *	Compact integers may be shorter, or up to two bytes longer for 64-bit
+	 *	values, so the total is a reservation hint rather than a hard limit.
+	 */
+	///@{
+	static constexpr u_int32_t encodedSize(const char&) { return sizeof(char) + 2; }
+	static constexpr u_int32_t encodedSize(const u_char&) { return sizeof(u_char) + 2; }
+	static constexpr u_int32_t encodedSize(const int16_t&) { return sizeof(int16_t) + 2; }
+	static constexpr u_int32_t encodedSize(const u_int16_t&) { return sizeof(u_int16_t) + 2; }
+	static constexpr u_int32_t encodedSize(const int32_t&) { return sizeof(int32_t) + 2; }
+	static constexpr u_int32_t encodedSize(const u_int32_t&) { return sizeof(u_int32_t) + 2; }
+	static constexpr u_int32_t encodedSize(const int64_t&) { return sizeof(int64_t) + 2; }
+	static constexpr u_int32_t encodedSize(const u_int64_t&) { return sizeof(u_int64_t) + 2; }
+	static constexpr u_int32_t encodedSize(const float&) { return sizeof(float) + 2; }
+	static constexpr u_int32_t encodedSize(const double&) { return sizeof(double) + 2; }
+	static u_int32_t encodedSize(const std::string& val) {
+		return val.length() + sizeof(u_int32_t) + 2;
+	}
+	template<typename T> static u_int32_t encodedSize(const std::vector<T>& val) {
+		return val.size() * sizeof(T) + 1 + sizeof(u_int32_t) + 2;
+	}
+	static u_int32_t encodedSize(const Streamable& val);
+	static u_int32_t encodedSize(const NetStream& val) {
+		return val.remaining() + sizeof(u_int32_t) + 2;
+	}
+	///@}
+
+protected:
+	/*!	@brief Construct an empty stream whose storage starts in an arena
+	 *	Used by SmallNetStream to keep short messages inside the object. The
+	 *	arena must be initialized before this constructor runs.
+	 *	@param arena The inline storage to use until the stream outgrows it
+	 *	@param order The order in which values will be decoded
+	 */
+	NetStream(InlineArena& arena, const Order order);
+
 private:
-	/*!	@brief Generic parameterized byte-ordering function
-	 *	@type input T& value to be converted to network byte order
-	 *	@return Input value converted to network byte order
-	 * TODO: Not currently being used
+	/*!	@brief Grow the buffer for a value of known encoded size
+	 *	@param bytes The number of bytes to add to the end of the stream
+	 *	@return Pointer to the first of the added bytes
+	 */
+	char* extend(const size_t bytes);
+
+	/*!	@brief Append a fixed-width value wrapped in type markers
+	 *	@param type The type marker to write on either side of the payload
+	 *	@param payload Pointer to payload bytes, already in network byte order
+	 *	@param bytes The width of the payload in bytes
+	 */
+	void append(const Type type, const void* payload, const size_t bytes);
+
+	/*!	@brief Append a length-prefixed value wrapped in type markers
+	 *	@param type The type marker to write on either side of the value
+	 *	@param payload Pointer to the payload bytes
+	 *	@param length The length of the payload in bytes
+	 */
+	void appendSized(const Type type, const void* payload, const u_int32_t length);
+
+	/*!	@brief Append the markers and length of a length-prefixed value
+	 *	@param type The type marker to write on either side of the value
+	 *	@param length The length of the payload in bytes
+	 *	@return Pointer to the payload bytes, to be filled in by the caller
+	 */
+	char* extendSized(const Type type, const u_int32_t length);
+
+	/*!	@brief Append an unsigned value as an LEB128 varint wrapped in type markers
+	 *	@param type The type marker to write on either side of the varint
+	 *	@param val The value to encode
+	 */
+	void appendVarint(const Type type, u_int64_t val);
+
+	/*!	@brief Append an array value gathered from equally spaced elements
+	 *	Encoded exactly as operator<<(const std::vector<T>&), with element i
+	 *	read from base + i * stride, so a field can be written straight from
+	 *	an array of records.
+	 *	@param base Pointer to the first element, need not be aligned
+	 *	@param stride The distance between elements in bytes
+	 *	@param count The number of elements
+	 *	@throw StreamException if the array exceeds the 32-bit length limit
+	 */
+	template<typename T>
+	void appendArray(const char* base, const size_t stride, const size_t count);
+
+	/*!	@brief Take over the contents of another stream's buffer
+	 *	Heap storage is moved, inline storage is copied since it belongs to
+	 *	the other stream's object.
+	 *	@param other The buffer to take over, left empty
+	 */
+	void adopt(Buffer_t& other);
+
+	/*!	@brief Append a string through the string dictionary
+	 *	@param val The string to encode
+	 *	@throw StreamException if the stream order is not FIFO
 	 */
-	template <typename T> static T hton_t(const T &input);
+	void appendInterned(const std::string& val);
 
-	/*!	@brief Convert 64-bit value to network byte order
-	 *	@param val 64-bit value to be converted
-	 *	@return The value provided, converted to network byte order
+	/*!	@brief Create the string dictionary if the next value defines an interned string */
+	void prepareDictionary();
+
+	/*!	@brief Append a length-prefixed value whose payload is borrowed
+	 *	@param type The type marker to write on either side of the value
+	 *	@param payload Pointer to the payload bytes
+	 *	@param length The length of the payload in bytes
+	 */
+	void appendBorrowed(const Type type, const char* payload, const size_t length);
+
+	/*!	@brief Copy the encoded stream, with borrowed payloads spliced in
+	 *	@param dst Destination with room for the bytes from offset onward
+	 *	@param offset Storage offset of the first byte to copy
 	 */
-	u_int64_t htonll(u_int64_t val);
+	void copyTo(char* dst, const u_int32_t offset) const;
 
-	/*!	@brief Convert 64-bit value from network to host byte order
-	 *	@param val 64-bit value to be converted
-	 *	@return The value provided, converted to host byte order
+	/*!	@brief Consume the values decoded by a view of this stream
+	 *	Advances the read offset in a FIFO stream, or removes the decoded
+	 *	values from the tail of a LIFO stream.
+	 *	@param reader A view constructed from this stream
 	 */
-	u_int64_t ntohll(u_int64_t val);
+	void commit(const NetStreamView& reader);
 
 private:
 	Buffer_t		buffer_;
+	Order				order_ = Order::LIFO;
+	bool				compact_ = false;
+	bool				interning_ = false;
+	u_int32_t		head_ = 0;
+	BufferPool*	pool_ = nullptr;
+	std::unique_ptr<StringDictionary>	dictionary_;
+	std::vector<Segment>	segments_;
+	u_int32_t		borrowed_ = 0;
+};
+
+/*!	@brief Element type marker written for each supported array element type */
+template<typename T> struct ArrayElement;
+
+template<> struct ArrayElement<char> {
+	static constexpr NetStream::Type type = NetStream::Type::CHAR;
+};
+
+template<> struct ArrayElement<u_char> {
+	static constexpr NetStream::Type type = NetStream::Type::UCHAR;
+};
+
+template<> struct ArrayElement<int16_t> {
+	static constexpr NetStream::Type type = NetStream::Type::INT16;
+};
+
+template<> struct ArrayElement<u_int16_t> {
+	static constexpr NetStream::Type type = NetStream::Type::UINT16;
+};
+
+template<> struct ArrayElement<int32_t> {
+	static constexpr NetStream::Type type = NetStream::Type::INT32;
+};
+
+template<> struct ArrayElement<u_int32_t> {
+	static constexpr NetStream::Type type = NetStream::Type::UINT32;
+};
+
+template<> struct ArrayElement<int64_t> {
+	static constexpr NetStream::Type type = NetStream::Type::INT64;
+};
+
+template<> struct ArrayElement<u_int64_t> {
+	static constexpr NetStream::Type type = NetStream::Type::UINT64;
+};
+
+template<> struct ArrayElement<float> {
+	static constexpr NetStream::Type type = NetStream::Type::FLOAT32;
+};
+
+template<> struct ArrayElement<double> {
+	static constexpr NetStream::Type type = NetStream::Type::FLOAT64;
 };
 } //Namespace
 
@@ -0,0 +1,861 @@
+/*!
+ *
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed Addin the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//System includes
+#include <memory.h>
+#include <stdint.h>
+
+//Library includes
+#include <limits>
+#include <type_traits>
+
+//Project includes
+#include "NetStreamView.h"
+#include "StreamException.h"
+#include "ByteOrder.h"
+
+//Namespace container
+namespace Inet {
+
+//Module-local helpers
+namespace {
+
+/*!	@brief Reverse the zigzag mapping
+ *	@param val The zigzag encoded value
+ *	@return The original signed value
+ */
+inline int64_t Unzigzag(const u_int64_t val) {
+	return (int64_t)(val >> 1) ^ -(int64_t)(val & 1);
+}
+
+/*!	@brief Maximum encoded length of a 64-bit varint */
+constexpr size_t VARINT_MAX_BYTES = 10;
+
+/*!	@brief Overhead of a length-prefixed value: two markers and the length */
+constexpr size_t SIZED_OVERHEAD = sizeof(u_int32_t) + 2;
+
+/*!	@brief Element type of a packed varint array of T, UNKNOWN if T is never packed */
+template<typename T>
+constexpr NetStream::Type PackedElement() {
+	if constexpr(!std::is_integral<T>::value || sizeof(T) == 1)
+		return NetStream::Type::UNKNOWN;
+	else if constexpr(std::is_signed<T>::value)
+		return NetStream::Type::ZIGZAG;
+	else
+		return NetStream::Type::VARINT;
+}
+
+/*!	@brief Decode packed varint array elements
+ *	@param p Pointer to the first element, already checked by nextPacked()
+ *	@param count The number of elements to decode
+ *	@param out Buffer to receive the elements
+ *	@throw StreamException if an element is out of range for T or 64 bits
+ */
+template<typename T>
+void Unpack(const char* p, const size_t count, T* out) {
+	for(size_t i = 0; i < count; i++) {
+		//Declare local
+		u_int64_t val = 0;
+		u_int32_t shift = 0;
+		u_char byte;
+
+		do {
+			byte = (u_char)*p++;
+			//Only the lowest bit of a tenth byte still fits in 64 bits
+			if(shift == 63 && byte > 1)
+				throw StreamException(STREAM_ERR_RANGE, STREAM_MSG_RANGE);
+			val |= (u_int64_t)(byte & 0x7f) << shift;
+			shift += 7;
+		} while(byte & 0x80);
+
+		if constexpr(std::is_signed<T>::value) {
+			const int64_t sval = Unzigzag(val);
+			if(sval < std::numeric_limits<T>::min() || sval > std::numeric_limits<T>::max())
+				throw StreamException(STREAM_ERR_RANGE, STREAM_MSG_RANGE);
+			out[i] = (T)sval;
+		}
+		else {
+			if(val > std::numeric_limits<T>::max())
+				throw StreamException(STREAM_ERR_RANGE, STREAM_MSG_RANGE);
+			out[i] = (T)val;
+		}
+	}
+}
+
+} //Module-local namespace
+
+/*!	@brief Returns the type marker of the next value to be decoded
+ *	@return The marker of the next value, read from the head of a FIFO view
+ *		or from the tail of a LIFO view
+ *	@throw StreamException if no data remains in the view
+ */
+NetStreamView::Type NetStreamView::peek() const {
+	if(head_ == tail_)
+		throw StreamException(STREAM_ERR_END_OF_STREAM, STREAM_MSG_END_OF_STREAM);
+
+	return (Type)(u_char)((order_ == Order::FIFO) ? head_[0] : tail_[-1]);
+}
+
+/*!	@brief Read a char value from the view
+ *	@param val Character value to receive the data
+ *	@return Reference to this view
+ */
+NetStreamView& NetStreamView::operator>>(char& val) {
+	val = *next(Type::CHAR, sizeof(char));
+	consume(sizeof(char) + 2);
+
+	//Return reference to ourselves
+	return *this;
+}
+
+/*!	@brief Read an unsigned char value from the view
+ *	@param val Unsigned character value to receive the data
+ *	@return Reference to this view
+ */
+NetStreamView& NetStreamView::operator>>(u_char& val) {
+	val = (u_char)*next(Type::UCHAR, sizeof(u_char));
+	consume(sizeof(u_char) + 2);
+
+	//Return reference to ourselves
+	return *this;
+}
+
+/*!	@brief Read a signed 16-bit value, fixed-width or compact
+ *	@param val Signed 16-bit value to receive the data
+ *	@return Reference to this view
+ */
+NetStreamView& NetStreamView::operator>>(int16_t& val) {
+	//Accept the compact form of the value as well as the fixed-width form
+	if(peek() == Type::ZIGZAG) {
+		val = (int16_t)readZigzag(INT16_MIN, INT16_MAX);
+		return *this;
+	}
+
+	memcpy(&val, next(Type::INT16, sizeof(int16_t)), sizeof(int16_t));
+	consume(sizeof(int16_t) + 2);
+
+	//Byte order the value
+	val = NetOrder(val);
+
+	//Return reference to ourselves
+	return *this;
+}
+
+/*!	@brief Read an unsigned 16-bit value, fixed-width or compact
+ *	@param val Unsigned 16-bit value to receive the data
+ *	@return Reference to this view
+ */
+NetStreamView& NetStreamView::operator>>(u_int16_t& val) {
+	//Accept the compact form of the value as well as the fixed-width form
+	if(peek() == Type::VARINT) {
+		val = (u_int16_t)readVarint(UINT16_MAX);
+		return *this;
+	}
+
+	memcpy(&val, next(Type::UINT16, sizeof(u_int16_t)), sizeof(u_int16_t));
+	consume(sizeof(u_int16_t) + 2);
+
+	//Byte order the value
+	val = NetOrder(val);
+
+	//Return reference to ourselves
+	return *this;
+}
+
+/*!	@brief Read a signed 32-bit value, fixed-width or compact
+ *	@param val Signed 32-bit value to receive the data
+ *	@return Reference to this view
+ */
+NetStreamView& NetStreamView::operator>>(int32_t& val) {
+	//Accept the compact form of the value as well as the fixed-width form
+	if(peek() == Type::ZIGZAG) {
+		val = (int32_t)readZigzag(INT32_MIN, INT32_MAX);
+		return *this;
+	}
+
+	memcpy(&val, next(Type::INT32, sizeof(int32_t)), sizeof(int32_t));
+	consume(sizeof(int32_t) + 2);
+
+	//Byte order the value
+	val = NetOrder(val);
+
+	//Return reference to ourselves
+	return *this;
+}
+
+/*!	@brief Read an unsigned 32-bit value, fixed-width or compact
+ *	@param val Unsigned 32-bit value to receive the data
+ *	@return Reference to this view
+ */
+NetStreamView& NetStreamView::operator>>(u_int32_t& val) {
+	//Accept the compact form of the value as well as the fixed-width form
+	if(peek() == Type::VARINT) {
+		val = (u_int32_t)readVarint(UINT32_MAX);
+		return *this;
+	}
+
+	memcpy(&val, next(Type::UINT32, sizeof(u_int32_t)), sizeof(u_int32_t));
+	consume(sizeof(u_int32_t) + 2);
+
+	//Byte order the value
+	val = NetOrder(val);
+
+	//Return reference to ourselves
+	return *this;
+}
+
+/*!	@brief Read a signed 64-bit value, fixed-width or compact
+ *	@param val Signed 64-bit value to receive the data
+ *	@return Reference to this view
+ */
+NetStreamView& NetStreamView::operator>>(int64_t& val) {
+	//Accept the compact form of the value as well as the fixed-width form
+	if(peek() == Type::ZIGZAG) {
+		val = (int64_t)readZigzag(INT64_MIN, INT64_MAX);
+		return *this;
+	}
+
+	memcpy(&val, next(Type::INT64, sizeof(int64_t)), sizeof(int64_t));
+	consume(sizeof(int64_t) + 2);
+
+	//Byte order the value
+	val = NetOrder(val);
+
+	//Return reference to ourselves
+	return *this;
+}
+
+/*!	@brief Read an unsigned 64-bit value, fixed-width or compact
+ *	@param val Unsigned 64-bit value to receive the data
+ *	@return Reference to this view
+ */
+NetStreamView& NetStreamView::operator>>(u_int64_t& val) {
+	//Accept the compact form of the value as well as the fixed-width form
+	if(peek() == Type::VARINT) {
+		val = (u_int64_t)readVarint(UINT64_MAX);
+		return *this;
+	}
+
+	memcpy(&val, next(Type::UINT64, sizeof(u_int64_t)), sizeof(u_int64_t));
+	consume(sizeof(u_int64_t) + 2);
+
+	//Byte order the value
+	val = NetOrder(val);
+
+	//Return reference to ourselves
+	return *this;
+}
+
+/*!	@brief Read a single precision floating-point value
+ *	@param val 32-bit floating-point value to receive the data
+ *	@return Reference to this view
+ */
+NetStreamView& NetStreamView::operator>>(float& val) {
+	val = NetOrderLoad<float>(next(Type::FLOAT32, sizeof(float)));
+	consume(sizeof(float) + 2);
+
+	//Return reference to ourselves
+	return *this;
+}
+
+/*!	@brief Read a double precision floating-point value
+ *	@param val 64-bit floating-point value to receive the data
+ *	@return Reference to this view
+ */
+NetStreamView& NetStreamView::operator>>(double& val) {
+	val = NetOrderLoad<double>(next(Type::FLOAT64, sizeof(double)));
+	consume(sizeof(double) + 2);
+
+	//Return reference to ourselves
+	return *this;
+}
+
+/*!	@brief Decode a string value into a std::string
+ *	@param val String to receive a copy of the data
+ *	@return Reference to this view
+ */
+NetStreamView& NetStreamView::operator>>(std::string& val) {
+	//Declare local
+	u_int32_t length;
+
+	if(peek() != Type::STRING) {
+		val = readInterned();
+		return *this;
+	}
+
+	const char* p = nextSized(Type::STRING, length);
+	val.assign(p, length);
+	consume(length + SIZED_OVERHEAD);
+
+	//Return reference to ourselves
+	return *this;
+}
+
+/*!	@brief Decode a string value without copying it
+ *	@param val Receives a view of the string data in the underlying memory
+ *	@return Reference to this view
+ */
+NetStreamView& NetStreamView::operator>>(std::string_view& val) {
+	//Declare local
+	u_int32_t length;
+
+	if(peek() != Type::STRING) {
+		val = readInterned();
+		return *this;
+	}
+
+	const char* p = nextSized(Type::STRING, length);
+	val = std::string_view(p, length);
+	consume(length + SIZED_OVERHEAD);
+
+	//Return reference to ourselves
+	return *this;
+}
+
+/*!	@brief Decode an embedded sub-stream as a view of its own
+ *	@param val Receives the sub-stream, keeping its own order setting
+ *	@return Reference to this view
+ */
+NetStreamView& NetStreamView::operator>>(NetStreamView& val) {
+	//Declare local
+	u_int32_t length;
+
+	const char* p = nextSized(Type::STREAM, length);
+	consume(length + SIZED_OVERHEAD);
+	val.head_ = p;
+	val.tail_ = p + length;
+
+	//Return reference to ourselves
+	return *this;
+}
+
+/*!	@brief Decode an array value into a vector of integers or floats
+ *	@param val Vector to receive the elements, resized to the element count
+ *	@return Reference to this view
+ *	@throw StreamException if the element type does not match
+ */
+template<typename T>
+NetStreamView& NetStreamView::operator>>(std::vector<T>& val) {
+	//Declare local
+	size_t count;
+
+	//Integer arrays from compact streams are packed as varints
+	if constexpr(PackedElement<T>() != Type::UNKNOWN) {
+		u_int32_t length;
+		if(const char* p = nextPacked(PackedElement<T>(), length, count)) {
+			val.resize(count);
+			Unpack(p, count, val.data());
+			consume(length + SIZED_OVERHEAD);
+			return *this;
+		}
+	}
+
+	const char* p = nextArray(ArrayElement<T>::type, sizeof(T), count);
+	val.resize(count);
+	NetOrderCopy<T>(val.data(), p, count);
+	consume(count * sizeof(T) + 1 + SIZED_OVERHEAD);
+
+	//Return reference to ourselves
+	return *this;
+}
+
+/*!	@brief Decode an array value into a caller-provided buffer
+ *	@param buf Buffer to receive the elements
+ *	@param count On input the capacity of the buffer in elements, on
+ *		output the number of elements decoded
+ *	@return Reference to this view
+ *	@throw StreamException if the element type does not match or the
+ *		buffer is too small, in which case nothing is consumed
+ */
+template<typename T>
+NetStreamView& NetStreamView::read(T* buf, size_t& count) {
+	//Declare local
+	size_t elements;
+
+	//Integer arrays from compact streams are packed as varints
+	if constexpr(PackedElement<T>() != Type::UNKNOWN) {
+		u_int32_t length;
+		if(const char* p = nextPacked(PackedElement<T>(), length, elements)) {
+			if(elements > count)
+				throw StreamException(STREAM_ERR_BUFFER_SIZE, STREAM_MSG_BUFFER_SIZE);
+			Unpack(p, elements, buf);
+			consume(length + SIZED_OVERHEAD);
+			count = elements;
+			return *this;
+		}
+	}
+
+	const char* p = nextArray(ArrayElement<T>::type, sizeof(T), elements);
+	if(elements > count)
+		throw StreamException(STREAM_ERR_BUFFER_SIZE, STREAM_MSG_BUFFER_SIZE);
+
+	NetOrderCopy<T>(buf, p, elements);
+	consume(elements * sizeof(T) + 1 + SIZED_OVERHEAD);
+	count = elements;
+
+	//Return reference to ourselves
+	return *this;
+}
+
+/*!	@brief Read a binary blob without copying it
+ *	@param buf Receives a pointer to the blob data in the underlying memory
+ *	@param bytes Receives the length of the blob in bytes
+ *	@return Reference to this view
+ */
+NetStreamView& NetStreamView::read(const char*& buf, size_t& bytes) {
+	//Declare local
+	u_int32_t length;
+
+	buf = nextSized(Type::BLOB, length);
+	bytes = length;
+	consume(length + SIZED_OVERHEAD);
+
+	//Return reference to ourselves
+	return *this;
+}
+
+/*!	@brief Read a binary blob into a caller-provided vector
+ *	@param buf Vector to receive the blob data, resized to the blob length
+ *	@return Reference to this view
+ */
+NetStreamView& NetStreamView::read(std::vector<char>& buf) {
+	//Declare local
+	u_int32_t length;
+
+	const char* p = nextSized(Type::BLOB, length);
+	buf.assign(p, p + length);
+	consume(length + SIZED_OVERHEAD);
+
+	//Return reference to ourselves
+	return *this;
+}
+
+/*!	@brief Read an embedded sub-stream without copying it
+ *	@param buf Receives a pointer to the sub-stream in the underlying memory
+ *	@param bytes Receives the length of the sub-stream in bytes
+ *	@return Reference to this view
+ */
+NetStreamView& NetStreamView::readStream(const char*& buf, size_t& bytes) {
+	//Declare local
+	u_int32_t length;
+
+	buf = nextSized(Type::STREAM, length);
+	bytes = length;
+	consume(length + SIZED_OVERHEAD);
+
+	//Return reference to ourselves
+	return *this;
+}
+
+/*!	@brief Discard the next value without decoding it
+ *	Length-prefixed values are skipped in constant time using their length.
+ *	@return Reference to this view
+ *	@throw StreamException if the next value is not a recognised type
+ */
+NetStreamView& NetStreamView::skip() {
+	//Declare local
+	u_int32_t length;
+	size_t encoded;
+
+	const Type type = peek();
+	switch(type) {
+		case Type::CHAR:
+		case Type::UCHAR:
+			next(type, sizeof(char));
+			consume(sizeof(char) + 2);
+			break;
+
+		case Type::INT16:
+		case Type::UINT16:
+			next(type, sizeof(int16_t));
+			consume(sizeof(int16_t) + 2);
+			break;
+
+		case Type::INT32:
+		case Type::UINT32:
+		case Type::FLOAT32:
+			next(type, sizeof(int32_t));
+			consume(sizeof(int32_t) + 2);
+			break;
+
+		case Type::INT64:
+		case Type::UINT64:
+		case Type::FLOAT64:
+			next(type, sizeof(int64_t));
+			consume(sizeof(int64_t) + 2);
+			break;
+
+		case Type::VARINT:
+		case Type::ZIGZAG:
+		case Type::INTERN_REF:
+			nextVarint(type, encoded);
+			consume(encoded);
+			break;
+
+		//Later references need the definition, record it if possible
+		case Type::INTERNED:
+			if(dictionary_) {
+				readInterned();
+				break;
+			}
+			nextSized(type, length);
+			consume(length + SIZED_OVERHEAD);
+			break;
+
+		case Type::STRING:
+		case Type::BLOB:
+		case Type::ARRAY:
+		case Type::STREAM:
+		case Type::STREAMABLE:
+			nextSized(type, length);
+			consume(length + SIZED_OVERHEAD);
+			break;
+
+		default:
+			throw StreamException(STREAM_ERR_INVALID_TYPE, STREAM_MSG_INVALID_TYPE);
+	}
+
+	//Return reference to ourselves
+	return *this;
+}
+
+/*!	@brief Locate the next block of unmarked bytes to decode
+ *	@param bytes The size of the block
+ *	@return Pointer to the first byte of the block
+ *	@throw StreamException if fewer bytes remain in the view
+ */
+const char* NetStreamView::nextRaw(const size_t bytes) const {
+	if(remaining() < bytes)
+		throw StreamException(STREAM_ERR_END_OF_STREAM, STREAM_MSG_END_OF_STREAM);
+
+	return (order_ == Order::FIFO) ? head_ : tail_ - bytes;
+}
+
+/*!	@brief Locate the payload of the next fixed-width value to decode
+ *	@param type The type marker expected on either side of the payload
+ *	@param bytes The width of the payload in bytes
+ *	@return Pointer to the first payload byte
+ *	@throw StreamException if the markers do not match or data is short
+ */
+const char* NetStreamView::next(const Type type, const size_t bytes) const {
+	//Fixed-width values have the same layout in either order, only the start
+	// differs: the head for FIFO views, the tail for LIFO views
+	const size_t encoded = bytes + 2;
+	const char* p = nextRaw(encoded);
+
+	//Validate the data
+	if(p[0] != (char)type || p[encoded-1] != (char)type)
+		throw StreamException(STREAM_ERR_INVALID_TYPE, STREAM_MSG_INVALID_TYPE);
+
+	return p + 1;
+}
+
+/*!	@brief Locate the payload of the next length-prefixed value to decode
+ *	FIFO streams encode [type][length][payload][type] so the length can be
+ *	read first, LIFO streams encode [type][payload][length][type].
+ *	@param type The type marker expected on either side of the value
+ *	@param length Receives the payload length in bytes
+ *	@return Pointer to the first payload byte
+ *	@throw StreamException if the markers do not match or data is short
+ */
+const char* NetStreamView::nextSized(const Type type, u_int32_t& length) const {
+	//Declare local
+	const char* payload;
+
+	if(remaining() < SIZED_OVERHEAD)
+		throw StreamException(STREAM_ERR_END_OF_STREAM, STREAM_MSG_END_OF_STREAM);
+
+	if(order_ == Order::FIFO) {
+		//Marker and length lead the payload
+		if(head_[0] != (char)type)
+			throw StreamException(STREAM_ERR_INVALID_TYPE, STREAM_MSG_INVALID_TYPE);
+		memcpy(&length, head_ + 1, sizeof(u_int32_t));
+	}
+	else {
+		//Length and marker trail the payload
+		if(tail_[-1] != (char)type)
+			throw StreamException(STREAM_ERR_INVALID_TYPE, STREAM_MSG_INVALID_TYPE);
+		memcpy(&length, tail_ - SIZED_OVERHEAD + 1, sizeof(u_int32_t));
+	}
+	length = NetOrder(length);
+
+	//Check the size against the remaining data
+	if(remaining() - SIZED_OVERHEAD < length)
+		throw StreamException(STREAM_ERR_END_OF_STREAM, STREAM_MSG_END_OF_STREAM);
+
+	//Validate the opposite marker now that the extent is known
+	if(order_ == Order::FIFO) {
+		payload = head_ + 1 + sizeof(u_int32_t);
+		if(payload[length] != (char)type)
+			throw StreamException(STREAM_ERR_INVALID_TYPE, STREAM_MSG_INVALID_TYPE);
+	}
+	else {
+		payload = tail_ - SIZED_OVERHEAD + 1 - length;
+		if(payload[-1] != (char)type)
+			throw StreamException(STREAM_ERR_INVALID_TYPE, STREAM_MSG_INVALID_TYPE);
+	}
+
+	return payload;
+}
+
+/*!	@brief Locate the elements of the next array value to decode
+ *	@param type The expected element type
+ *	@param width The width of each element in bytes
+ *	@param count Receives the number of elements in the array
+ *	@return Pointer to the first element
+ *	@throw StreamException if the array or element type does not match
+ */
+const char* NetStreamView::nextArray(const Type type, const size_t width, size_t& count) const {
+	//Declare local
+	u_int32_t length;
+
+	//Payload must hold the element type and a whole number of elements
+	const char* p = nextSized(Type::ARRAY, length);
+	if(length < 1 || p[0] != (char)type || (length - 1) % width != 0)
+		throw StreamException(STREAM_ERR_INVALID_TYPE, STREAM_MSG_INVALID_TYPE);
+
+	count = (length - 1) / width;
+	return p + 1;
+}
+
+/*!	@brief Locate the elements of the next array value if packed as varints
+ *	Every element ends at a byte with the high bit clear, so the elements
+ *	are counted, and checked for termination, in one pass over the payload.
+ *	@param type The expected element type, VARINT or ZIGZAG
+ *	@param length Receives the payload length in bytes
+ *	@param count Receives the number of elements in the array
+ *	@return Pointer to the first packed element, or nullptr if the array's
+ *		element type is not the expected one
+ *	@throw StreamException if the next value is not an array or an
+ *		element is malformed
+ */
+const char* NetStreamView::nextPacked(const Type type, u_int32_t& length, size_t& count) const {
+	//Declare local
+	size_t run = 0;
+
+	const char* p = nextSized(Type::ARRAY, length);
+	if(length < 1 || p[0] != (char)type)
+		return nullptr;
+
+	count = 0;
+	for(const char* q = p + 1; q < p + length; q++) {
+		if(++run > VARINT_MAX_BYTES)
+			throw StreamException(STREAM_ERR_INVALID_TYPE, STREAM_MSG_INVALID_TYPE);
+		if(!(*q & 0x80)) {
+			count++;
+			run = 0;
+		}
+	}
+
+	//Last element must be complete
+	if(run != 0)
+		throw StreamException(STREAM_ERR_INVALID_TYPE, STREAM_MSG_INVALID_TYPE);
+
+	return p + 1;
+}
+
+/*!	@brief Decode the next varint value without consuming it
+ *	Varint bytes other than the last have the high bit set, while type
+ *	markers never do, so a LIFO reader finds the start of the value by
+ *	scanning back from the tail to the first byte with a clear high bit.
+ *	@param type The type marker expected on either side of the varint
+ *	@param encoded Receives the encoded size including type markers
+ *	@return The decoded value
+ *	@throw StreamException if the markers do not match, data is short or
+ *		the value does not fit in 64 bits
+ */
+u_int64_t NetStreamView::nextVarint(const Type type, size_t& encoded) const {
+	//Declare local
+	const char* begin = head_;
+	const char* end = tail_;
+	const char* p;
+
+	if(remaining() < 3)
+		throw StreamException(STREAM_ERR_END_OF_STREAM, STREAM_MSG_END_OF_STREAM);
+
+	if(order_ == Order::FIFO) {
+		if(begin[0] != (char)type)
+			throw StreamException(STREAM_ERR_INVALID_TYPE, STREAM_MSG_INVALID_TYPE);
+		p = begin + 1;
+	}
+	else {
+		//Walk back over the last varint byte and any continuation bytes
+		if(end[-1] != (char)type || (end[-2] & 0x80))
+			throw StreamException(STREAM_ERR_INVALID_TYPE, STREAM_MSG_INVALID_TYPE);
+		p = end - 2;
+		while(p > begin && (p[-1] & 0x80) && end - p < (ptrdiff_t)VARINT_MAX_BYTES + 1)
+			p--;
+		if(p == begin || p[-1] != (char)type)
+			throw StreamException(STREAM_ERR_INVALID_TYPE, STREAM_MSG_INVALID_TYPE);
+	}
+
+	//Fast path, gather up to eight groups from a single load without branching
+	// on each byte. Needs eight varint bytes plus the closing marker readable
+	// and a little-endian host.
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	if(end - p > 8) {
+		u_int64_t word;
+		memcpy(&word, p, sizeof(word));
+		const u_int64_t stops = ~word & 0x8080808080808080ULL;
+		if(stops != 0) {
+			const size_t bytes = __builtin_ctzll(stops) / 8 + 1;
+			if(bytes < 8)
+				word &= (1ULL << (bytes * 8)) - 1;
+			const u_int64_t val =
+				((word & 0x000000000000007fULL)) |
+				((word & 0x0000000000007f00ULL) >> 1) |
+				((word & 0x00000000007f0000ULL) >> 2) |
+				((word & 0x000000007f000000ULL) >> 3) |
+				((word & 0x0000007f00000000ULL) >> 4) |
+				((word & 0x00007f0000000000ULL) >> 5) |
+				((word & 0x007f000000000000ULL) >> 6) |
+				((word & 0x7f00000000000000ULL) >> 7);
+			if(p[bytes] != (char)type)
+				throw StreamException(STREAM_ERR_INVALID_TYPE, STREAM_MSG_INVALID_TYPE);
+			encoded = bytes + 2;
+			return val;
+		}
+	}
+#endif
+
+	//Byte at a time for long values and the end of the buffer
+	u_int64_t val = 0;
+	size_t bytes = 0;
+	for(;;) {
+		if(p + bytes >= end - 1 || bytes == VARINT_MAX_BYTES)
+			throw StreamException(STREAM_ERR_INVALID_TYPE, STREAM_MSG_INVALID_TYPE);
+		const u_char byte = (u_char)p[bytes];
+		//Only the lowest bit of a tenth byte still fits in 64 bits
+		if(bytes == VARINT_MAX_BYTES - 1 && byte > 1)
+			throw StreamException(STREAM_ERR_RANGE, STREAM_MSG_RANGE);
+		val |= (u_int64_t)(byte & 0x7f) << (7 * bytes);
+		bytes++;
+		if(!(byte & 0x80))
+			break;
+	}
+	if(p[bytes] != (char)type)
+		throw StreamException(STREAM_ERR_INVALID_TYPE, STREAM_MSG_INVALID_TYPE);
+
+	encoded = bytes + 2;
+	return val;
+}
+
+/*!	@brief Decode and consume the next interned string value
+ *	@return Reference to the dictionary's copy of the string
+ *	@throw StreamException if there is no dictionary or the value does
+ *		not match it
+ */
+const std::string& NetStreamView::readInterned() {
+	//Declare local
+	u_int32_t length;
+	size_t encoded;
+	u_int64_t index = 0;
+	size_t bytes = 0;
+
+	//Reports a plain type mismatch for anything that is not a string
+	const Type type = peek();
+	if(type != Type::INTERNED && type != Type::INTERN_REF)
+		throw StreamException(STREAM_ERR_INVALID_TYPE, STREAM_MSG_INVALID_TYPE);
+	if(!dictionary_)
+		throw StreamException(STREAM_ERR_DICTIONARY, STREAM_MSG_DICTIONARY);
+
+	//Reference holds just the index
+	if(type == Type::INTERN_REF) {
+		index = nextVarint(Type::INTERN_REF, encoded);
+		const std::string& val = dictionary_->at(index);
+		consume(encoded);
+		return val;
+	}
+
+	//Definition holds the index followed by the string
+	const char* p = nextSized(Type::INTERNED, length);
+	for(;;) {
+		if(bytes == length || bytes == VARINT_MAX_BYTES)
+			throw StreamException(STREAM_ERR_INVALID_TYPE, STREAM_MSG_INVALID_TYPE);
+		const u_char byte = (u_char)p[bytes];
+		index |= (u_int64_t)(byte & 0x7f) << (7 * bytes);
+		bytes++;
+		if(!(byte & 0x80))
+			break;
+	}
+
+	const std::string& val =
+		dictionary_->define(index, std::string_view(p + bytes, length - bytes));
+	consume(length + SIZED_OVERHEAD);
+	return val;
+}
+
+/*!	@brief Decode and consume the next unsigned varint value
+ *	@param max The largest value representable by the destination type
+ *	@return The decoded value
+ *	@throw StreamException if the value exceeds max, nothing is consumed
+ */
+u_int64_t NetStreamView::readVarint(const u_int64_t max) {
+	//Declare local
+	size_t encoded;
+
+	const u_int64_t val = nextVarint(Type::VARINT, encoded);
+	if(val > max)
+		throw StreamException(STREAM_ERR_RANGE, STREAM_MSG_RANGE);
+
+	consume(encoded);
+	return val;
+}
+
+/*!	@brief Decode and consume the next zigzag varint value
+ *	@param min The smallest value representable by the destination type
+ *	@param max The largest value representable by the destination type
+ *	@return The decoded value
+ *	@throw StreamException if the value is out of range, nothing is consumed
+ */
+int64_t NetStreamView::readZigzag(const int64_t min, const int64_t max) {
+	//Declare local
+	size_t encoded;
+
+	const int64_t val = Unzigzag(nextVarint(Type::ZIGZAG, encoded));
+	if(val < min || val > max)
+		throw StreamException(STREAM_ERR_RANGE, STREAM_MSG_RANGE);
+
+	consume(encoded);
+	return val;
+}
+
+//Array decode for the supported element types
+template NetStreamView& NetStreamView::operator>>(std::vector<char>& val);
+template NetStreamView& NetStreamView::operator>>(std::vector<u_char>& val);
+template NetStreamView& NetStreamView::operator>>(std::vector<int16_t>& val);
+template NetStreamView& NetStreamView::operator>>(std::vector<u_int16_t>& val);
+template NetStreamView& NetStreamView::operator>>(std::vector<int32_t>& val);
+template NetStreamView& NetStreamView::operator>>(std::vector<u_int32_t>& val);
+template NetStreamView& NetStreamView::operator>>(std::vector<int64_t>& val);
+template NetStreamView& NetStreamView::operator>>(std::vector<u_int64_t>& val);
+template NetStreamView& NetStreamView::operator>>(std::vector<float>& val);
+template NetStreamView& NetStreamView::operator>>(std::vector<double>& val);
+template NetStreamView& NetStreamView::read(char* buf, size_t& count);
+template NetStreamView& NetStreamView::read(u_char* buf, size_t& count);
+template NetStreamView& NetStreamView::read(int16_t* buf, size_t& count);
+template NetStreamView& NetStreamView::read(u_int16_t* buf, size_t& count);
+template NetStreamView& NetStreamView::read(int32_t* buf, size_t& count);
+template NetStreamView& NetStreamView::read(u_int32_t* buf, size_t& count);
+template NetStreamView& NetStreamView::read(int64_t* buf, size_t& count);
+template NetStreamView& NetStreamView::read(u_int64_t* buf, size_t& count);
+template NetStreamView& NetStreamView::read(float* buf, size_t& count);
+template NetStreamView& NetStreamView::read(double* buf, size_t& count);
+} //Inet namespace end
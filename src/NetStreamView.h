@@ -0,0 +1,322 @@
+/*!
+ *
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed Addin the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef NETSTREAMVIEW_H_INCLUDED
+#define NETSTREAMVIEW_H_INCLUDED
+
+//System includes
+#include <sys/types.h>
+
+//Library includes
+#include <vector>
+#include <string>
+#include <string_view>
+
+//Project includes
+#include "NetStream.h"
+#include "StreamException.h"
+
+//Namespace container
+namespace Inet {
+
+/*!	@brief Read-only decoder over encoded stream data held elsewhere
+ *	The view decodes the NetStream wire format directly from memory it does
+ *	not own, such as a receive buffer or a mapped file, without copying it
+ *	into a stream first. Decoding only moves the view's own bounds, in either
+ *	order, so the memory is never modified and must outlive the view and any
+ *	pointers or string views read from it.
+ */
+class NetStreamView {
+	friend class NetStream;
+	template<typename Message, typename... Fields> friend class Schema;
+
+public:
+	///Typedefs local to class
+	typedef NetStream::Type						Type;
+	typedef NetStream::Order					Order;
+
+public:
+	/*!	@brief Construct a view over encoded data
+	 *	@param data Pointer to the first byte of encoded data
+	 *	@param bytes The number of bytes of encoded data
+	 *	@param order The order in which the values will be decoded
+	 */
+	NetStreamView(const char* data, const size_t bytes,
+		const Order order = Order::LIFO) :
+		head_(data), tail_(data + bytes), order_(order) {}
+
+	/*!	@brief Construct a view over the unread contents of a stream
+	 *	The view is invalidated by any change to the stream.
+	 *	@param stream The stream to view, in its own decode order
+	 *	@throw StreamException if the stream holds borrowed payloads
+	 */
+	explicit NetStreamView(const NetStream& stream) :
+		head_(stream.buffer_.data() + stream.head_),
+		tail_(stream.buffer_.data() + stream.buffer_.size()),
+		order_(stream.order_), dictionary_(stream.dictionary_.get())
+	{
+		if(!stream.segments_.empty())
+			throw StreamException(STREAM_ERR_BORROWED, STREAM_MSG_BORROWED);
+	}
+
+	/*!	@brief Returns the order in which values are decoded from this view */
+	inline Order order() const { return order_; }
+
+	/*!	@brief Returns a pointer to the first byte not yet consumed */
+	inline const char* data() const { return head_; }
+
+	/*!	@brief Returns the number of bytes not yet consumed by decoding */
+	inline u_int32_t remaining() const { return tail_ - head_; }
+
+	/*!	@brief Returns the dictionary used to decode interned strings */
+	inline StringDictionary* dictionary() const { return dictionary_; }
+
+	/*!	@brief Set the dictionary used to decode interned strings
+	 *	A view of a stream uses the stream's dictionary. A view of other memory
+	 *	needs one set before it can decode interned strings, and the same one
+	 *	should be used for every view of the same encoded stream.
+	 *	@param dictionary The dictionary, which must outlive the view
+	 */
+	inline void setDictionary(StringDictionary* dictionary) { dictionary_ = dictionary; }
+
+	/*!	@brief Returns the type marker of the next value to be decoded
+	 *	@return The marker of the next value
+	 *	@throw StreamException if no data remains in the view
+	 */
+	Type peek() const;
+
+	/*!	@brief Read a char value from the view
+	 *	@param val Character value to receive the data
+	 *	@return Reference to this view
+	 */
+	NetStreamView& operator>>(char& val);
+
+	/*!	@brief Read an unsigned char value from the view
+	 *	@param val Unsigned character value to receive the data
+	 *	@return Reference to this view
+	 */
+	NetStreamView& operator>>(u_char& val);
+
+	/*!	@brief Read a signed 16-bit value, fixed-width or compact
+	 *	@param val Signed 16-bit value to receive the data
+	 *	@return Reference to this view
+	 */
+	NetStreamView& operator>>(int16_t& val);
+
+	/*!	@brief Read an unsigned 16-bit value, fixed-width or compact
+	 *	@param val Unsigned 16-bit value to receive the data
+	 *	@return Reference to this view
+	 */
+	NetStreamView& operator>>(u_int16_t& val);
+
+	/*!	@brief Read a signed 32-bit value, fixed-width or compact
+	 *	@param val Signed 32-bit value to receive the data
+	 *	@return Reference to this view
+	 */
+	NetStreamView& operator>>(int32_t& val);
+
+	/*!	@brief Read an unsigned 32-bit value, fixed-width or compact
+	 *	@param val Unsigned 32-bit value to receive the data
+	 *	@return Reference to this view
+	 */
+	NetStreamView& operator>>(u_int32_t& val);
+
+	/*!	@brief Read a signed 64-bit value, fixed-width or compact
+	 *	@param val Signed 64-bit value to receive the data
+	 *	@return Reference to this view
+	 */
+	NetStreamView& operator>>(int64_t& val);
+
+	/*!	@brief Read an unsigned 64-bit value, fixed-width or compact
+	 *	@param val Unsigned 64-bit value to receive the data
+	 *	@return Reference to this view
+	 */
+	NetStreamView& operator>>(u_int64_t& val);
+
+	/*!	@brief Read a single precision floating-point value
+	 *	@param val 32-bit floating-point value to receive the data
+	 *	@return Reference to this view
+	 */
+	NetStreamView& operator>>(float& val);
+
+	/*!	@brief Read a double precision floating-point value
+	 *	@param val 64-bit floating-point value to receive the data
+	 *	@return Reference to this view
+	 */
+	NetStreamView& operator>>(double& val);
+
+	/*!	@brief Decode a string value into a std::string
+	 *	Interned strings are copied from the dictionary, reusing val's capacity.
+	 *	@param val String to receive a copy of the data
+	 *	@return Reference to this view
+	 *	@throw StreamException if an interned string cannot be resolved
+	 */
+	NetStreamView& operator>>(std::string& val);
+
+	/*!	@brief Decode a string value without copying it
+	 *	Interned strings are viewed in the dictionary rather than the
+	 *	underlying memory, and remain valid until the dictionary is cleared.
+	 *	@param val Receives a view of the string data in the underlying memory
+	 *	@return Reference to this view
+	 *	@throw StreamException if an interned string cannot be resolved
+	 */
+	NetStreamView& operator>>(std::string_view& val);
+
+	/*!	@brief Decode an embedded sub-stream as a view of its own
+	 *	@param val Receives the sub-stream, keeping its own order setting
+	 *	@return Reference to this view
+	 */
+	NetStreamView& operator>>(NetStreamView& val);
+
+	/*!	@brief Decode an array value into a vector of integers or floats
+	 *	@param val Vector to receive the elements, resized to the element count
+	 *	@return Reference to this view
+	 *	@throw StreamException if the element type does not match
+	 */
+	template<typename T> NetStreamView& operator>>(std::vector<T>& val);
+
+	/*!	@brief Decode an array value into a caller-provided buffer
+	 *	@param buf Buffer to receive the elements
+	 *	@param count On input the capacity of the buffer in elements, on
+	 *		output the number of elements decoded
+	 *	@return Reference to this view
+	 *	@throw StreamException if the element type does not match or the
+	 *		buffer is too small, in which case nothing is consumed
+	 */
+	template<typename T> NetStreamView& read(T* buf, size_t& count);
+
+	/*!	@brief Read a binary blob without copying it
+	 *	@param buf Receives a pointer to the blob data in the underlying memory
+	 *	@param bytes Receives the length of the blob in bytes
+	 *	@return Reference to this view
+	 */
+	NetStreamView& read(const char*& buf, size_t& bytes);
+
+	/*!	@brief Read a binary blob into a caller-provided vector
+	 *	@param buf Vector to receive the blob data, resized to the blob length
+	 *	@return Reference to this view
+	 */
+	NetStreamView& read(std::vector<char>& buf);
+
+	/*!	@brief Read an embedded sub-stream without copying it
+	 *	@param buf Receives a pointer to the sub-stream in the underlying memory
+	 *	@param bytes Receives the length of the sub-stream in bytes
+	 *	@return Reference to this view
+	 */
+	NetStreamView& readStream(const char*& buf, size_t& bytes);
+
+	/*!	@brief Discard the next value without decoding it
+	 *	@return Reference to this view
+	 *	@throw StreamException if the next value is not a recognised type
+	 */
+	NetStreamView& skip();
+
+private:
+	/*!	@brief Locate the next block of unmarked bytes to decode
+	 *	@param bytes The size of the block
+	 *	@return Pointer to the first byte of the block
+	 *	@throw StreamException if fewer bytes remain in the view
+	 */
+	const char* nextRaw(const size_t bytes) const;
+
+	/*!	@brief Locate the payload of the next fixed-width value to decode
+	 *	@param type The type marker expected on either side of the payload
+	 *	@param bytes The width of the payload in bytes
+	 *	@return Pointer to the first payload byte
+	 *	@throw StreamException if the markers do not match or data is short
+	 */
+	const char* next(const Type type, const size_t bytes) const;
+
+	/*!	@brief Locate the payload of the next length-prefixed value to decode
+	 *	@param type The type marker expected on either side of the value
+	 *	@param length Receives the payload length in bytes
+	 *	@return Pointer to the first payload byte
+	 *	@throw StreamException if the markers do not match or data is short
+	 */
+	const char* nextSized(const Type type, u_int32_t& length) const;
+
+	/*!	@brief Locate the elements of the next array value to decode
+	 *	@param type The expected element type
+	 *	@param width The width of each element in bytes
+	 *	@param count Receives the number of elements in the array
+	 *	@return Pointer to the first element
+	 *	@throw StreamException if the array or element type does not match
+	 */
+	const char* nextArray(const Type type, const size_t width, size_t& count) const;
+
+	/*!	@brief Locate the elements of the next array value if packed as varints
+	 *	@param type The expected element type, VARINT or ZIGZAG
+	 *	@param length Receives the payload length in bytes
+	 *	@param count Receives the number of elements in the array
+	 *	@return Pointer to the first packed element, or nullptr if the array's
+	 *		element type is not the expected one
+	 *	@throw StreamException if the next value is not an array or an
+	 *		element is malformed
+	 */
+	const char* nextPacked(const Type type, u_int32_t& length, size_t& count) const;
+
+	/*!	@brief Decode the next varint value without consuming it
+	 *	@param type The type marker expected on either side of the varint
+	 *	@param encoded Receives the encoded size including type markers
+	 *	@return The decoded value
+	 *	@throw StreamException if the markers do not match or data is short
+	 */
+	u_int64_t nextVarint(const Type type, size_t& encoded) const;
+
+	/*!	@brief Decode and consume the next interned string value
+	 *	A definition is added to the dictionary, a reference looked up in it.
+	 *	@return Reference to the dictionary's copy of the string
+	 *	@throw StreamException if there is no dictionary or the value does
+	 *		not match it
+	 */
+	const std::string& readInterned();
+
+	/*!	@brief Decode and consume the next unsigned varint value
+	 *	@param max The largest value representable by the destination type
+	 *	@return The decoded value
+	 */
+	u_int64_t readVarint(const u_int64_t max);
+
+	/*!	@brief Decode and consume the next zigzag varint value
+	 *	@param min The smallest value representable by the destination type
+	 *	@param max The largest value representable by the destination type
+	 *	@return The decoded value
+	 */
+	int64_t readZigzag(const int64_t min, const int64_t max);
+
+	/*!	@brief Consume an encoded value once it has been decoded
+	 *	Advances the head of a FIFO view, or retreats the tail of a LIFO view.
+	 *	@param bytes The encoded size of the value, including type markers
+	 */
+	inline void consume(const size_t bytes) {
+		if(order_ == Order::FIFO)
+			head_ += bytes;
+		else
+			tail_ -= bytes;
+	}
+
+private:
+	const char*					head_;
+	const char*					tail_;
+	Order								order_;
+	StringDictionary*		dictionary_ = nullptr;
+};
+} //Inet namespace
+
+#endif // NETSTREAMVIEW_H_INCLUDED
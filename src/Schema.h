@@ -0,0 +1,200 @@
+/*!
+ *
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//Include once
+#ifndef SCHEMA_H_INCLUDED
+#define SCHEMA_H_INCLUDED
+
+//System includes
+#include <sys/types.h>
+#include <memory.h>
+
+//Library includes
+#include <cstddef>
+#include <type_traits>
+
+//Project includes
+#include "NetStream.h"
+#include "NetStreamView.h"
+#include "ByteOrder.h"
+
+//Namespace container
+namespace Inet {
+
+/*!	@brief Encoding of a single fixed-width field value
+ *	Integers, floats and enumerations are stored in network byte order,
+ *	arrays of them element by element.
+ */
+template<typename T, typename Enable = void>
+struct FieldCodec {
+	static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value,
+		"Schema fields must be integers, floats, enumerations or arrays of them");
+};
+
+/*!	@brief Integer field encoding */
+template<typename T>
+struct FieldCodec<T, typename std::enable_if<std::is_integral<T>::value>::type> {
+	static constexpr size_t size = sizeof(T);
+
+	static void store(char* p, const T& val) {
+		const T netval = NetOrder(val);
+		memcpy(p, &netval, sizeof(T));
+	}
+
+	static void load(const char* p, T& val) {
+		memcpy(&val, p, sizeof(T));
+		val = NetOrder(val);
+	}
+};
+
+/*!	@brief Floating-point field encoding, as the IEEE-754 bit pattern */
+template<typename T>
+struct FieldCodec<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+	static constexpr size_t size = sizeof(T);
+
+	static void store(char* p, const T& val) {
+		NetOrderStore(p, val);
+	}
+
+	static void load(const char* p, T& val) {
+		val = NetOrderLoad<T>(p);
+	}
+};
+
+/*!	@brief Enumeration field encoding, as the underlying integer */
+template<typename T>
+struct FieldCodec<T, typename std::enable_if<std::is_enum<T>::value>::type> {
+	typedef typename std::underlying_type<T>::type Underlying_t;
+	static constexpr size_t size = sizeof(Underlying_t);
+
+	static void store(char* p, const T& val) {
+		FieldCodec<Underlying_t>::store(p, (Underlying_t)val);
+	}
+
+	static void load(const char* p, T& val) {
+		Underlying_t raw;
+		FieldCodec<Underlying_t>::load(p, raw);
+		val = (T)raw;
+	}
+};
+
+/*!	@brief Fixed-length array field encoding */
+template<typename T, size_t N>
+struct FieldCodec<T[N], void> {
+	static constexpr size_t size = FieldCodec<T>::size * N;
+
+	static void store(char* p, const T (&val)[N]) {
+		for(size_t i = 0; i < N; i++)
+			FieldCodec<T>::store(p + i * FieldCodec<T>::size, val[i]);
+	}
+
+	static void load(const char* p, T (&val)[N]) {
+		for(size_t i = 0; i < N; i++)
+			FieldCodec<T>::load(p + i * FieldCodec<T>::size, val[i]);
+	}
+};
+
+/*!	@brief Names one data member of a message as a schema field
+ *	Used as Field<&Message::member> in a Schema field list.
+ */
+template<auto Member> struct Field;
+
+/*!	@brief Field specialization for pointers to data members */
+template<typename Message, typename T, T Message::*Member>
+struct Field<Member> {
+	typedef FieldCodec<T>		Codec_t;
+	typedef Message					Message_t;
+	typedef T								Value_t;
+	static constexpr size_t size = Codec_t::size;
+	static constexpr T Message::*member = Member;
+
+	static void store(char* p, const Message& msg) { Codec_t::store(p, msg.*Member); }
+	static void load(const char* p, Message& msg) { Codec_t::load(p, msg.*Member); }
+};
+
+/*!	@brief Compile-time message layout encoded without per-field type markers
+ *	Both peers declare the same field list, for example
+ *		typedef Schema<Quote, Field<&Quote::id>, Field<&Quote::price>> QuoteSchema_t;
+ *	and the fields are written back to back in declaration order, in network
+ *	byte order, as one block of Schema::size bytes. The block is read from
+ *	the read offset of a FIFO stream or the tail of a LIFO stream, so schema
+ *	messages can be mixed with tagged NetStream values in either order.
+ */
+template<typename Message, typename... Fields>
+class Schema {
+public:
+	/*!	@brief Encoded size of one message in bytes */
+	static constexpr size_t size = (Fields::size + ... + 0);
+
+	/*!	@brief Append one message to the stream
+	 *	@param stream The stream to write to
+	 *	@param msg The message to encode
+	 */
+	static void encode(NetStream& stream, const Message& msg) {
+		store(stream.extend(size), msg);
+	}
+
+	/*!	@brief Append a run of messages to the stream with a single allocation
+	 *	@param stream The stream to write to
+	 *	@param msgs Pointer to the first message to encode
+	 *	@param count The number of messages to encode
+	 */
+	static void encode(NetStream& stream, const Message* msgs, const size_t count) {
+		char* p = stream.extend(size * count);
+		for(size_t i = 0; i < count; i++, p += size)
+			store(p, msgs[i]);
+	}
+
+	/*!	@brief Decode the next message from the stream
+	 *	@param stream The stream to read from
+	 *	@param msg The message to receive the decoded fields
+	 *	@throw StreamException if the stream holds fewer than size bytes
+	 */
+	static void decode(NetStream& stream, Message& msg) {
+		NetStreamView reader(stream);
+		decode(reader, msg);
+		stream.commit(reader);
+	}
+
+	/*!	@brief Decode the next message from a view without copying the stream
+	 *	@param view The view to read from
+	 *	@param msg The message to receive the decoded fields
+	 *	@throw StreamException if the view holds fewer than size bytes
+	 */
+	static void decode(NetStreamView& view, Message& msg) {
+		load(view.nextRaw(size), msg);
+		view.consume(size);
+	}
+
+private:
+	/*!	@brief Write each field in declaration order */
+	static void store(char* p, const Message& msg) {
+		((Fields::store(p, msg), p += Fields::size), ...);
+	}
+
+	/*!	@brief Read each field in declaration order */
+	static void load(const char* p, Message& msg) {
+		((Fields::load(p, msg), p += Fields::size), ...);
+	}
+};
+
+} //Inet namespace
+
+#endif //SCHEMA_H_INCLUDED
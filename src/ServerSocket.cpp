@@ -24,6 +24,7 @@
 #include <sys/un.h>
 #include <unistd.h>
 #include <errno.h>
+#include <string.h>
 
 //Library includes
 #include <utility>
@@ -113,18 +114,41 @@ void ServerSocket::listen(const int backlog) {
  *	@param
  */
 ConnectionEndpoint ServerSocket::accept() {
+	//Declare local
+	ConnectionEndpoint client;
+
+	if(!accept(client))
+		throw SocketException(EWOULDBLOCK, std::string("No connection waiting on non-blocking server socket"));
+
+	return client;
+}
+
+/*!	@brief Accept a connection if one is waiting
+ *	@param client Receives the connected endpoint
+ *	@param blocking Mode for the accepted endpoint
+ *	@return True if a connection was accepted, false if none was waiting
+ */
+bool ServerSocket::accept(ConnectionEndpoint& client, const bool blocking) {
 	//Declare local
 	SockAddrIn_t address;
 	int addrLen = sizeof(SockAddr_t);
-	socket_t client = INVALID_SOCKET;
+	socket_t sock = INVALID_SOCKET;
+
+	do {
+		sock = ::accept4(socket_, (SockAddrPtr_t)&address, (SockLenPtr_t)&addrLen,
+			blocking ? 0 : SOCK_NONBLOCK);
+	} while(sock < 0 && errno == EINTR);
 
-	client = ::accept(socket_, (SockAddrPtr_t)&address, (SockLenPtr_t)&addrLen);
-	if(client < 0) {
+	if(sock < 0) {
+		if(errno == EAGAIN || errno == EWOULDBLOCK)
+			return false;
 		throw SocketException(errno, std::string("Accept failed for server socket"));
 	}
 
 	//Create endpoint from client socket and address
-	return ConnectionEndpoint(client, &address, addrLen);
+	client = ConnectionEndpoint(sock, &address, addrLen);
+	client.blocking_ = blocking;
+	return true;
 }
 
 /*!	@brief Close the server socket
@@ -146,19 +170,24 @@ void ServerSocket::createSocket() {
 	destroySocket();
 
 	//Create socket
-	socket_ = ::socket(AF_INET, SOCK_STREAM, 0);
-	if(socket_ == INVALID_SOCKET) {
-		throw SocketException(socket_, "Error creating socket");
+	socket_ = ::socket(AF_INET, SOCK_STREAM | (blocking_ ? 0 : SOCK_NONBLOCK), 0);
+	if(socket_ < 0) {
+		socket_ = INVALID_SOCKET;
+		throw SocketException(errno, std::string("Error creating socket: ") + strerror(errno));
 	}
 
-	//Set socket options
+	//Set socket options, each one needs its own call since option names are
+	// not bit flags. SO_REUSEPORT lets a ShardedServer bind one listener per
+	// worker to the same port.
 	//TODO Get socket options from new method or constructor
-	retcode = ::setsockopt(socket_, SOL_SOCKET, SO_REUSEADDR | SO_REUSEPORT,
-		&opt, sizeof(opt));
-	if(retcode < 0) {
-		//Clean up socket and throw error
-		destroySocket();
-		throw SocketException(socket_, "Error setting socket options");
+	for(const int option : { SO_REUSEADDR, SO_REUSEPORT }) {
+		retcode = ::setsockopt(socket_, SOL_SOCKET, option, &opt, sizeof(opt));
+		if(retcode < 0) {
+			//Clean up socket and throw error
+			const int error = errno;
+			destroySocket();
+			throw SocketException(error, std::string("Error setting socket options: ") + strerror(error));
+		}
 	}
 }
 
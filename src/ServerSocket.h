@@ -77,6 +77,17 @@ public:
 	 */
 	ConnectionEndpoint accept();
 
+	/*!	@brief Accept a connection if one is waiting
+	 *	On a blocking server socket this waits for a connection. On a
+	 *	non-blocking one it returns false straight away if none is waiting.
+	 *	@param client Receives the connected endpoint
+	 *	@param blocking Mode for the accepted endpoint, applied atomically
+	 *		with accept4()
+	 *	@return True if a connection was accepted
+	 *	@throw SocketException if the accept fails
+	 */
+	bool accept(ConnectionEndpoint& client, const bool blocking = true);
+
 	/*!	@brief Close the server socket
 	 */
 	void close();
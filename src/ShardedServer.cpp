@@ -0,0 +1,184 @@
+/*!
+ *
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//System includes
+#include <sys/types.h>
+#include <errno.h>
+
+//Library includes
+#include <string>
+#include <utility>
+
+//Project includes
+#include "ShardedServer.h"
+#include "Affinity.h"
+#include "SocketException.h"
+
+//Namespace container
+namespace Inet {
+
+/*!	@brief Construct a stopped server
+ *	@param shards Number of listeners, 0 for one per allowed core
+ *	@param pin True to pin each worker thread to a core
+ */
+ShardedServer::ShardedServer(const size_t shards, const bool pin) :
+	count_(shards > 0 ? shards : AllowedCpus().size()), pin_(pin)
+{
+}
+
+/*!	@brief Destructor */
+ShardedServer::~ShardedServer() {
+	//Errors can't be thrown from here, stop() reports them
+	shutdown();
+}
+
+/*!	@brief Bind every listener to a port and start the workers
+ *	@param port Port shared by the listeners
+ *	@param backlog Listen backlog of each listener
+ *	@param handler Called on the shard's thread for each connection
+ */
+void ShardedServer::start(const uint16_t port, const int backlog, Handler_t handler) {
+	//Declare local
+	const std::vector<int> cores = pin_ ? AllowedCpus() : std::vector<int>();
+
+	if(running())
+		throw SocketException(EALREADY, std::string("Sharded server is already running"));
+
+	handler_ = std::move(handler);
+
+	//Set up every listener before starting any worker, failures close them all
+	try {
+		for(size_t i = 0; i < count_; i++) {
+			std::unique_ptr<Shard> shard(new Shard());
+			shard->listener.setBlocking(false);
+			shard->listener.bind(port);
+			shard->listener.listen(backlog);
+			shard->loop.add(shard->listener, EventLoop::READ, [this, s = shard.get(), i](u_int32_t) {
+				acceptAll(*s, i);
+			});
+			shards_.push_back(std::move(shard));
+		}
+	}
+	catch(...) {
+		for(auto& shard : shards_)
+			shard->listener.close();
+		shards_.clear();
+		throw;
+	}
+
+	//Start the workers, pinning each to the next allowed core
+	for(size_t i = 0; i < shards_.size(); i++) {
+		Shard& shard = *shards_[i];
+		shard.thread = std::thread(&ShardedServer::work, this, std::ref(shard));
+
+		//Left unpinned if the core can't be used, e.g. restricted by a cgroup
+		if(!cores.empty() && PinThread(shard.thread, cores[i % cores.size()]))
+			shard.cpu = cores[i % cores.size()];
+	}
+}
+
+/*!	@brief Stop the workers and close the listeners */
+void ShardedServer::stop() {
+	//Declare local
+	std::exception_ptr error = shutdown();
+
+	if(error)
+		std::rethrow_exception(error);
+}
+
+/*!	@brief Returns the number of connections a running shard has accepted
+ *	@param shard Index of the shard
+ */
+size_t ShardedServer::accepted(const size_t shard) const {
+	return shard < shards_.size() ? shards_[shard]->accepted.load(std::memory_order_relaxed) : 0;
+}
+
+/*!	@brief Returns the core a running shard is pinned to
+ *	@param shard Index of the shard
+ */
+int ShardedServer::cpu(const size_t shard) const {
+	return shard < shards_.size() ? shards_[shard]->cpu : -1;
+}
+
+/*!	@brief Accept every waiting connection on a shard's listener
+ *	@param shard The shard whose listener is ready
+ *	@param index Index of the shard, passed to the handler
+ */
+void ShardedServer::acceptAll(Shard& shard, const size_t index) {
+	//Edge-triggered, so accept until nothing more is waiting
+	for(;;) {
+		ConnectionEndpoint client;
+
+		try {
+			if(!shard.listener.accept(client, false))
+				return;
+		}
+		catch(const SocketException& se) {
+			//Connection reset while queued, skip it
+			if(se.code() == ECONNABORTED)
+				continue;
+			throw;
+		}
+
+		shard.accepted.fetch_add(1, std::memory_order_relaxed);
+		handler_(std::move(client), shard.loop, index);
+	}
+}
+
+/*!	@brief Worker thread body
+ *	@param shard The shard to run
+ */
+void ShardedServer::work(Shard& shard) {
+	try {
+		shard.loop.run();
+	}
+	catch(...) {
+		shard.error = std::current_exception();
+	}
+
+	//Close the listener straight away so the kernel stops routing
+	// connections to a worker that has given up
+	shard.loop.remove(shard.listener);
+	shard.listener.close();
+}
+
+/*!	@brief Stop and join the workers
+ *	@return The first error that stopped a worker early, if any
+ */
+std::exception_ptr ShardedServer::shutdown() {
+	//Declare local
+	std::exception_ptr error;
+
+	for(auto& shard : shards_)
+		shard->loop.stop();
+
+	for(auto& shard : shards_) {
+		if(shard->thread.joinable())
+			shard->thread.join();
+		if(shard->error && !error)
+			error = shard->error;
+	}
+
+	shards_.clear();
+	handler_ = nullptr;
+	return error;
+}
+
+} //Inet namespace
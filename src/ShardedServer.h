@@ -0,0 +1,136 @@
+/*!
+ *
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//Include once
+#ifndef SHARDEDSERVER_H_INCLUDED
+#define SHARDEDSERVER_H_INCLUDED
+
+//System includes
+#include <sys/types.h>
+
+//Library includes
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+//Project includes
+#include "ServerSocket.h"
+#include "ConnectionEndpoint.h"
+#include "EventLoop.h"
+
+//Namespace container
+namespace Inet {
+
+/*!	@brief Multi-threaded acceptor with one listening socket per worker
+ *	Every shard owns a listening socket bound to the same port with
+ *	SO_REUSEPORT, an EventLoop and a worker thread pinned to its own core.
+ *	The kernel spreads incoming connections across the listeners, so
+ *	accepts run in parallel rather than behind a single accept thread, and
+ *	each connection stays on the core that accepted it.
+ *
+ *	Accepted endpoints are non-blocking and handed to the handler on the
+ *	shard's thread, together with the shard's loop so the handler can
+ *	register the connection there. The handler takes ownership of the
+ *	endpoint and must keep it alive while it is registered.
+ */
+class ShardedServer {
+public:
+	///Typedefs local to class
+	typedef std::function<void(ConnectionEndpoint&& client, EventLoop& loop, const size_t shard)>	Handler_t;
+
+	/*!	@brief Construct a stopped server
+	 *	@param shards Number of listeners and worker threads, 0 for one per
+	 *		core the process may run on
+	 *	@param pin True to pin each worker thread to a core
+	 */
+	explicit ShardedServer(const size_t shards = 0, const bool pin = true);
+
+	/*!	@brief Copy constructor, delete default */
+	ShardedServer(const ShardedServer& other) = delete;
+
+	/*!	@brief Assignment operator, delete default */
+	ShardedServer& operator=(const ShardedServer& other) = delete;
+
+	/*!	@brief Destructor, stops the server */
+	virtual ~ShardedServer();
+
+	/*!	@brief Bind every listener to a port and start the workers
+	 *	The listeners are all bound before any worker starts, so a port that
+	 *	is taken is reported here rather than on a worker thread.
+	 *	@param port Port shared by the listeners
+	 *	@param backlog Listen backlog of each listener
+	 *	@param handler Called on the shard's thread for each connection
+	 *	@throw SocketException if a listener cannot be set up or the server
+	 *		is already running
+	 */
+	void start(const uint16_t port, const int backlog, Handler_t handler);
+
+	/*!	@brief Stop the workers and close the listeners
+	 *	Connections already handed to the handler are left open. Does nothing
+	 *	if the server is not running.
+	 *	@throw Whatever first stopped a worker early, once all have stopped
+	 */
+	void stop();
+
+	/*!	@brief Returns true between start() and stop() */
+	inline bool running() const { return !shards_.empty(); }
+
+	/*!	@brief Returns the number of shards */
+	inline size_t shards() const { return count_; }
+
+	/*!	@brief Returns the number of connections a running shard has accepted */
+	size_t accepted(const size_t shard) const;
+
+	/*!	@brief Returns the core a running shard is pinned to, or -1 if unpinned */
+	int cpu(const size_t shard) const;
+
+protected:
+	/*!	@brief Listener, loop and worker thread for one shard */
+	struct Shard {
+		ServerSocket					listener;
+		EventLoop							loop;
+		std::thread						thread;
+		std::atomic<size_t>		accepted{0};			///< Connections handed to the handler
+		std::exception_ptr		error;						///< What stopped the worker early
+		int										cpu = -1;					///< Pinned core, -1 if unpinned
+	};
+
+	/*!	@brief Accept every waiting connection on a shard's listener */
+	void acceptAll(Shard& shard, const size_t index);
+
+	/*!	@brief Worker thread body, runs the shard's loop until stopped */
+	void work(Shard& shard);
+
+	/*!	@brief Stop and join the workers, returning the first error */
+	std::exception_ptr shutdown();
+
+private:
+	size_t														count_;
+	bool															pin_;
+	Handler_t													handler_;
+	std::vector<std::unique_ptr<Shard>>	shards_;
+};
+
+} //Inet namespace
+
+#endif //SHARDEDSERVER_H_INCLUDED
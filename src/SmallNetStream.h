@@ -0,0 +1,81 @@
+/*!
+ *
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed Addin the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef SMALLNETSTREAM_H_INCLUDED
+#define SMALLNETSTREAM_H_INCLUDED
+
+//System includes
+#include <sys/types.h>
+
+//Library includes
+#include <cstddef>
+#include <utility>
+
+//Project includes
+#include "NetStream.h"
+#include "StreamAllocator.h"
+
+//Namespace container
+namespace Inet {
+
+/*!	@brief Inline storage block, a base class so it is built before NetStream */
+template<size_t N>
+class InlineStorage {
+protected:
+	alignas(std::max_align_t) char	storage_[N];
+	InlineArena											arena_ = { storage_, N, false };
+};
+
+/*!	@brief NetStream keeping messages of up to N bytes inside the object
+ *	Short messages are encoded without a heap allocation. A message that
+ *	grows past N bytes moves to the heap like any other NetStream and stays
+ *	there. Moving a stream copies at most N bytes while its data is inline,
+ *	and moves the heap storage pointer once it has outgrown it.
+ */
+template<size_t N>
+class SmallNetStream : private InlineStorage<N>, public NetStream {
+	static_assert(N > 0, "SmallNetStream requires inline storage");
+
+public:
+	/*!	@brief Construct an empty stream using the specified decode order */
+	explicit SmallNetStream(const Order order = Order::LIFO) :
+		NetStream(this->arena_, order) {}
+
+	/*!	@brief Move constructor */
+	SmallNetStream(SmallNetStream&& other) :
+		NetStream(this->arena_, other.order())
+	{
+		NetStream::operator=(std::move(other));
+	}
+
+	/*!	@brief Move assignment operator */
+	SmallNetStream& operator=(SmallNetStream&& other) {
+		NetStream::operator=(std::move(other));
+		return *this;
+	}
+
+	/*!	@brief Returns true while the stream's data is held inside the object */
+	inline bool isInline() const { return data().get_allocator().owns(data().data()); }
+
+	/*!	@brief Returns the inline capacity in bytes */
+	static constexpr size_t inlineCapacity() { return N; }
+};
+} //Inet namespace
+
+#endif // SMALLNETSTREAM_H_INCLUDED
@@ -0,0 +1,121 @@
+/*!
+ *
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed Addin the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef STREAMALLOCATOR_H_INCLUDED
+#define STREAMALLOCATOR_H_INCLUDED
+
+//System includes
+#include <sys/types.h>
+
+//Library includes
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+//Project includes
+
+//Namespace container
+namespace Inet {
+
+/*!	@brief Fixed block of storage held inside a stream object */
+struct InlineArena {
+	char*		data;		///< First byte of the block
+	size_t	bytes;	///< Size of the block
+	bool		busy;		///< True while the block holds the stream's data
+};
+
+/*!	@brief Stream buffer allocator that prefers an inline arena to the heap
+ *	An allocation that fits the arena is served from it while the arena is
+ *	free, anything else comes from the heap. Allocators without an arena
+ *	always use the heap.
+ *
+ *	All instances compare equal and are never propagated, so a vector keeps
+ *	its own allocator when another's heap storage is moved into it and can
+ *	free that storage itself. Arena storage must never be moved between
+ *	vectors this way; NetStream copies inline data instead.
+ */
+template<typename T>
+class StreamAllocator {
+public:
+	///Allocator traits
+	typedef T												value_type;
+	typedef std::false_type					propagate_on_container_copy_assignment;
+	typedef std::false_type					propagate_on_container_move_assignment;
+	typedef std::false_type					propagate_on_container_swap;
+
+public:
+	/*!	@brief Construct a heap-only allocator */
+	StreamAllocator() = default;
+
+	/*!	@brief Construct an allocator serving small requests from an arena */
+	explicit StreamAllocator(InlineArena* arena) : arena_(arena) {}
+
+	/*!	@brief Rebinding copy constructor */
+	template<typename U>
+	StreamAllocator(const StreamAllocator<U>& other) : arena_(other.arena()) {}
+
+	/*!	@brief Copies made for a new container use the heap */
+	StreamAllocator select_on_container_copy_construction() const {
+		return StreamAllocator();
+	}
+
+	/*!	@brief Allocate storage for n objects
+	 *	@param n The number of objects
+	 *	@return The arena if it is free and large enough, otherwise heap storage
+	 */
+	T* allocate(const size_t n) {
+		if(arena_ && !arena_->busy && n * sizeof(T) <= arena_->bytes) {
+			arena_->busy = true;
+			return reinterpret_cast<T*>(arena_->data);
+		}
+		return static_cast<T*>(::operator new(n * sizeof(T)));
+	}
+
+	/*!	@brief Release storage returned by allocate()
+	 *	@param p The storage to release
+	 */
+	void deallocate(T* p, const size_t) {
+		if(owns(p))
+			arena_->busy = false;
+		else
+			::operator delete(p);
+	}
+
+	/*!	@brief Returns true if the pointer refers to this allocator's arena */
+	inline bool owns(const T* p) const {
+		return arena_ && reinterpret_cast<const char*>(p) == arena_->data;
+	}
+
+	/*!	@brief Returns the arena used by this allocator, or nullptr */
+	inline InlineArena* arena() const { return arena_; }
+
+private:
+	InlineArena*	arena_ = nullptr;
+};
+
+/*!	@brief Allocators are interchangeable for heap storage */
+template<typename T, typename U>
+inline bool operator==(const StreamAllocator<T>&, const StreamAllocator<U>&) { return true; }
+
+template<typename T, typename U>
+inline bool operator!=(const StreamAllocator<T>&, const StreamAllocator<U>&) { return false; }
+
+} //Inet namespace
+
+#endif // STREAMALLOCATOR_H_INCLUDED
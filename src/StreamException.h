@@ -36,6 +36,26 @@ namespace Inet {
 ///Stream error messages and codes
 const int		STREAM_ERR_INVALID_TYPE                = 1;
 const char	STREAM_MSG_INVALID_TYPE[]              = "The next stream value is not of the requested type.";
+const int		STREAM_ERR_END_OF_STREAM               = 2;
+const char	STREAM_MSG_END_OF_STREAM[]             = "The stream does not contain enough data for the requested value.";
+const int		STREAM_ERR_INVALID_OFFSET              = 3;
+const char	STREAM_MSG_INVALID_OFFSET[]            = "The requested read offset is past the end of the stream.";
+const int		STREAM_ERR_INVALID_ORDER               = 4;
+const char	STREAM_MSG_INVALID_ORDER[]             = "The operation is not supported for the stream order.";
+const int		STREAM_ERR_LENGTH                      = 5;
+const char	STREAM_MSG_LENGTH[]                    = "The value is too large to be encoded in the stream.";
+const int		STREAM_ERR_BUFFER_SIZE                 = 6;
+const char	STREAM_MSG_BUFFER_SIZE[]               = "The destination buffer is too small for the decoded value.";
+const int		STREAM_ERR_RANGE                       = 7;
+const char	STREAM_MSG_RANGE[]                     = "The decoded value is out of range for the requested type.";
+const int		STREAM_ERR_INVALID_LENGTH              = 8;
+const char	STREAM_MSG_INVALID_LENGTH[]            = "The decoded value does not match its encoded length.";
+const int		STREAM_ERR_FRAME_SIZE                  = 9;
+const char	STREAM_MSG_FRAME_SIZE[]                = "The frame exceeds the maximum frame size.";
+const int		STREAM_ERR_DICTIONARY                  = 10;
+const char	STREAM_MSG_DICTIONARY[]                = "The interned string does not match the stream's string dictionary.";
+const int		STREAM_ERR_BORROWED                    = 11;
+const char	STREAM_MSG_BORROWED[]                  = "The stream holds borrowed payloads and must be flattened before decoding.";
 
 /*!	@brief Exception type thrown by Address
 	*	@author jcleland
@@ -0,0 +1,72 @@
+/*!
+ *
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//Include once
+#ifndef STREAMABLE_H_INCLUDED
+#define STREAMABLE_H_INCLUDED
+
+//System includes
+#include <sys/types.h>
+
+//Library includes
+
+//Project includes
+#include "NetStream.h"
+
+//Namespace container
+namespace Inet {
+
+/*!	@brief Interface for user types that encode themselves into a NetStream
+ *	Implementations are written and read with NetStream::operator<< and
+ *	operator>>, which wrap the object's values in a STREAMABLE marker. As with
+ *	any other values, decode() must read them back in reverse order from a
+ *	LIFO stream and in written order from a FIFO stream.
+ *	@author jcleland
+ */
+class Streamable {
+public:
+	/*!	@brief Destructor */
+	virtual ~Streamable() {}
+
+	/*!	@brief Returns the number of bytes encode() will append to the stream
+	 *	Used to reserve storage for the object, and everything nested in it, in
+	 *	a single allocation. Sum NetStream::encodedSize() over the values the
+	 *	object writes.
+	 *	@return Encoded size of the object's values in bytes
+	 */
+	virtual u_int32_t encodedSize() const = 0;
+
+	/*!	@brief Append the object's values to the stream
+	 *	@param stream The stream to write to
+	 */
+	virtual void encode(NetStream& stream) const = 0;
+
+	/*!	@brief Read the object's values from the stream
+	 *	In a LIFO stream this is a stream holding only the object's own
+	 *	values, so a failed decode leaves the outer stream intact.
+	 *	@param stream The stream to read from
+	 *	@throw Anything, the outer stream is restored before it propagates
+	 */
+	virtual void decode(NetStream& stream) = 0;
+};
+
+} //Inet namespace
+
+#endif //STREAMABLE_H_INCLUDED
@@ -0,0 +1,98 @@
+/*!
+ *
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//System includes
+
+//Library includes
+
+//Project includes
+#include "StringDictionary.h"
+#include "StreamException.h"
+
+//Namespace container
+namespace Inet {
+
+/*!	@brief Construct an empty dictionary */
+StringDictionary::StringDictionary() {}
+
+/*!	@brief Destructor */
+StringDictionary::~StringDictionary() {}
+
+/*!	@brief Find a string, adding it if it is not yet in the dictionary
+ *	@param val The string to look up
+ *	@param added Set to true if the string was added by this call
+ *	@return The string's index
+ */
+u_int32_t StringDictionary::add(std::string_view val, bool& added) {
+	//Repeated strings are found without allocating
+	const auto it = index_.find(val);
+	if(it != index_.end()) {
+		added = false;
+		return it->second;
+	}
+
+	//Keys refer to the stored copy, which never moves
+	const u_int32_t index = strings_.size();
+	strings_.emplace_back(val);
+	index_.emplace(strings_.back(), index);
+	added = true;
+	return index;
+}
+
+/*!	@brief Record a string at the index given by the encoder
+ *	@param index The string's index, at most the current size
+ *	@param val The string
+ *	@return Reference to the dictionary's copy of the string
+ *	@throw StreamException if the index is out of sequence or already
+ *		holds a different string
+ */
+const std::string& StringDictionary::define(const u_int64_t index, std::string_view val) {
+	//Already defined, by this stream's own encoder or an earlier decode
+	if(index < strings_.size()) {
+		if(strings_[index] != val)
+			throw StreamException(STREAM_ERR_DICTIONARY, STREAM_MSG_DICTIONARY);
+		return strings_[index];
+	}
+
+	if(index != strings_.size())
+		throw StreamException(STREAM_ERR_DICTIONARY, STREAM_MSG_DICTIONARY);
+
+	strings_.emplace_back(val);
+	index_.emplace(strings_.back(), (u_int32_t)index);
+	return strings_.back();
+}
+
+/*!	@brief Returns the string at an index
+ *	@param index The string's index
+ *	@return Reference to the dictionary's copy of the string
+ *	@throw StreamException if no string has the index
+ */
+const std::string& StringDictionary::at(const u_int64_t index) const {
+	if(index >= strings_.size())
+		throw StreamException(STREAM_ERR_DICTIONARY, STREAM_MSG_DICTIONARY);
+	return strings_[index];
+}
+
+/*!	@brief Remove all strings, invalidating any references to them */
+void StringDictionary::clear() {
+	index_.clear();
+	strings_.clear();
+}
+} //Inet namespace end
@@ -0,0 +1,93 @@
+/*!
+ *
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef STRINGDICTIONARY_H_INCLUDED
+#define STRINGDICTIONARY_H_INCLUDED
+
+//System includes
+#include <sys/types.h>
+
+//Library includes
+#include <deque>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+//Project includes
+
+//Namespace container
+namespace Inet {
+
+/*!	@brief Table of interned strings shared by the encoder and decoder of a stream
+ *	Each distinct string is stored once and numbered in the order it was
+ *	first seen. Strings are held in a deque so references and views of them
+ *	stay valid as the table grows, until it is cleared.
+ */
+class StringDictionary {
+public:
+	/*!	@brief Construct an empty dictionary */
+	StringDictionary();
+
+	/*!	@brief Copy constructor, delete default */
+	StringDictionary(const StringDictionary& other) = delete;
+
+	/*!	@brief Assignment operator, delete default */
+	StringDictionary& operator=(const StringDictionary& other) = delete;
+
+	/*!	@brief Destructor */
+	virtual ~StringDictionary();
+
+	/*!	@brief Returns the number of strings in the dictionary */
+	inline size_t size() const { return strings_.size(); }
+
+	/*!	@brief Find a string, adding it if it is not yet in the dictionary
+	 *	@param val The string to look up
+	 *	@param added Set to true if the string was added by this call
+	 *	@return The string's index
+	 */
+	u_int32_t add(std::string_view val, bool& added);
+
+	/*!	@brief Record a string at the index given by the encoder
+	 *	Defining an index that already holds the same string is allowed, so
+	 *	a value decoded twice does not disturb the numbering.
+	 *	@param index The string's index, at most the current size
+	 *	@param val The string
+	 *	@return Reference to the dictionary's copy of the string
+	 *	@throw StreamException if the index is out of sequence or already
+	 *		holds a different string
+	 */
+	const std::string& define(const u_int64_t index, std::string_view val);
+
+	/*!	@brief Returns the string at an index
+	 *	@param index The string's index
+	 *	@return Reference to the dictionary's copy of the string
+	 *	@throw StreamException if no string has the index
+	 */
+	const std::string& at(const u_int64_t index) const;
+
+	/*!	@brief Remove all strings, invalidating any references to them */
+	void clear();
+
+private:
+	std::deque<std::string>												strings_;
+	std::unordered_map<std::string_view, u_int32_t>	index_;
+};
+} //Inet namespace
+
+#endif // STRINGDICTIONARY_H_INCLUDED
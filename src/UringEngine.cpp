@@ -0,0 +1,442 @@
+/*!
+ *
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//System includes
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <linux/io_uring.h>
+#include <unistd.h>
+#include <signal.h>
+#include <errno.h>
+#include <string.h>
+
+//Library includes
+#include <algorithm>
+#include <climits>
+#include <string>
+#include <utility>
+
+//Project includes
+#include "UringEngine.h"
+#include "SocketException.h"
+
+//Namespace container
+namespace Inet {
+
+/*!	@brief Set up the ring
+ *	@param entries Submission queue depth
+ */
+UringEngine::UringEngine(const unsigned entries) {
+	//Declare local
+	struct io_uring_params params;
+
+	memset(&params, 0, sizeof(params));
+	ring_ = ::syscall(__NR_io_uring_setup, std::max(entries, 1u), &params);
+	if(ring_ < 0) {
+		ring_ = -1;
+		throw SocketException(errno, std::string("Error creating io_uring: ") + strerror(errno));
+	}
+
+	try {
+		//Waiting with a timeout needs the extended enter arguments
+		if(!(params.features & IORING_FEAT_EXT_ARG))
+			throw SocketException(ENOSYS, "Kernel io_uring lacks timed waits");
+
+		sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+		cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+		if(params.features & IORING_FEAT_SINGLE_MMAP)
+			sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+
+		sqRing_ = ::mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+			ring_, IORING_OFF_SQ_RING);
+		if(sqRing_ == MAP_FAILED) {
+			sqRing_ = nullptr;
+			throw SocketException(errno, std::string("Error mapping io_uring: ") + strerror(errno));
+		}
+
+		if(params.features & IORING_FEAT_SINGLE_MMAP) {
+			cqRing_ = sqRing_;
+		}
+		else {
+			cqRing_ = ::mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+				ring_, IORING_OFF_CQ_RING);
+			if(cqRing_ == MAP_FAILED) {
+				cqRing_ = nullptr;
+				throw SocketException(errno, std::string("Error mapping io_uring: ") + strerror(errno));
+			}
+		}
+
+		sqesSize_ = params.sq_entries * sizeof(struct io_uring_sqe);
+		sqes_ = (struct io_uring_sqe*)::mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE,
+			MAP_SHARED | MAP_POPULATE, ring_, IORING_OFF_SQES);
+		if(sqes_ == MAP_FAILED) {
+			sqes_ = nullptr;
+			throw SocketException(errno, std::string("Error mapping io_uring: ") + strerror(errno));
+		}
+	}
+	catch(...) {
+		destroy();
+		throw;
+	}
+
+	//Ring fields live at the offsets the kernel reported
+	char* sq = (char*)sqRing_;
+	char* cq = (char*)cqRing_;
+	sqHead_ = (unsigned*)(sq + params.sq_off.head);
+	sqTail_ = (unsigned*)(sq + params.sq_off.tail);
+	sqArray_ = (unsigned*)(sq + params.sq_off.array);
+	sqMask_ = *(unsigned*)(sq + params.sq_off.ring_mask);
+	sqEntries_ = params.sq_entries;
+	cqHead_ = (unsigned*)(cq + params.cq_off.head);
+	cqTail_ = (unsigned*)(cq + params.cq_off.tail);
+	cqMask_ = *(unsigned*)(cq + params.cq_off.ring_mask);
+	cqes_ = (struct io_uring_cqe*)(cq + params.cq_off.cqes);
+}
+
+/*!	@brief Destructor */
+UringEngine::~UringEngine() {
+	//The kernel may still write into operations in flight, so wait them out
+	try {
+		drain();
+	}
+	catch(...) {
+	}
+	destroy();
+}
+
+/*!	@brief Queue an accept on a listening socket
+ *	@param sock The listening socket
+ *	@param done Called with the result and client
+ */
+void UringEngine::accept(const AbstractSocket& sock, AcceptCompletion_t done) {
+	std::unique_ptr<Op> op(new Op{ sock.handle(), nullptr, std::move(done), {}, sizeof(SockAddrIn_t), false });
+	void* address = &op->address;
+	void* addrLen = &op->addrLen;
+
+	struct io_uring_sqe* sqe = prepare(IORING_OP_ACCEPT, sock.handle(), address, 0, std::move(op));
+	sqe->addr2 = (u_int64_t)addrLen;
+	sqe->accept_flags = SOCK_CLOEXEC;
+}
+
+/*!	@brief Queue a receive
+ *	@param sock The connected socket
+ *	@param buf Buffer to receive into
+ *	@param len The largest number of bytes to receive
+ *	@param done Called with the result
+ */
+void UringEngine::receive(const AbstractSocket& sock, char* buf, const size_t len, Completion_t done) {
+	std::unique_ptr<Op> op(new Op{ sock.handle(), std::move(done), nullptr, {}, 0, false });
+	const u_int32_t bytes = clampLength(len);
+	const int index = bufferIndex(buf, bytes);
+
+	if(index < 0) {
+		prepare(IORING_OP_RECV, sock.handle(), buf, bytes, std::move(op));
+	}
+	else {
+		struct io_uring_sqe* sqe = prepare(IORING_OP_READ_FIXED, sock.handle(), buf, bytes, std::move(op));
+		sqe->off = (u_int64_t)-1;
+		sqe->buf_index = index;
+	}
+}
+
+/*!	@brief Queue a send
+ *	@param sock The connected socket
+ *	@param buf The data to send
+ *	@param len The number of bytes to send
+ *	@param done Called with the result
+ */
+void UringEngine::send(const AbstractSocket& sock, const char* buf, const size_t len, Completion_t done) {
+	std::unique_ptr<Op> op(new Op{ sock.handle(), std::move(done), nullptr, {}, 0, false });
+	const u_int32_t bytes = clampLength(len);
+	const int index = bufferIndex(buf, bytes);
+
+	if(index < 0) {
+		struct io_uring_sqe* sqe = prepare(IORING_OP_SEND, sock.handle(), buf, bytes, std::move(op));
+		sqe->msg_flags = MSG_NOSIGNAL;
+	}
+	else {
+		struct io_uring_sqe* sqe = prepare(IORING_OP_WRITE_FIXED, sock.handle(), buf, bytes, std::move(op));
+		sqe->off = (u_int64_t)-1;
+		sqe->buf_index = index;
+	}
+}
+
+/*!	@brief Cancel the pending operations of a socket
+ *	@param sock The socket whose operations are cancelled
+ */
+void UringEngine::cancel(const AbstractSocket& sock) {
+	for(auto& inflight : inflight_) {
+		if(inflight.second->handle == sock.handle())
+			cancelOp(inflight.first, *inflight.second);
+	}
+}
+
+/*!	@brief Submit queued operations and dispatch completions
+ *	@param timeout Milliseconds to wait for a completion
+ *	@return The number of completion callbacks called
+ */
+size_t UringEngine::poll(const int timeout) {
+	//Completions already in the ring need no system call
+	size_t dispatched = reap();
+
+	//Wait only when nothing has completed and something could
+	const bool wait = (dispatched == 0 && timeout != 0 && !inflight_.empty());
+	if(queued_ > 0 || wait) {
+		enter(wait ? 1 : 0, timeout);
+		dispatched += reap();
+	}
+
+	return dispatched;
+}
+
+/*!	@brief Register long-lived buffers with the ring
+ *	@param buffers The buffers to register
+ */
+void UringEngine::registerBuffers(const std::vector<struct iovec>& buffers) {
+	unregisterBuffers();
+	if(!buffers.empty())
+		registerResource(IORING_REGISTER_BUFFERS, buffers.data(), buffers.size());
+	IoEngine::registerBuffers(buffers);
+}
+
+/*!	@brief Register sockets in the ring's fixed file table
+ *	@param handles Descriptors of the sockets to register
+ */
+void UringEngine::registerFiles(const std::vector<socket_t>& handles) {
+	unregisterFiles();
+	if(!handles.empty())
+		registerResource(IORING_REGISTER_FILES, handles.data(), handles.size());
+	IoEngine::registerFiles(handles);
+}
+
+/*!	@brief Release the registered buffers */
+void UringEngine::unregisterBuffers() {
+	if(!buffers_.empty())
+		registerResource(IORING_UNREGISTER_BUFFERS, nullptr, 0);
+	IoEngine::unregisterBuffers();
+}
+
+/*!	@brief Release the registered sockets */
+void UringEngine::unregisterFiles() {
+	if(!files_.empty())
+		registerResource(IORING_UNREGISTER_FILES, nullptr, 0);
+	IoEngine::unregisterFiles();
+}
+
+/*!	@brief Take the next submission entry, flushing the ring if full
+ *	@return A zeroed entry, already counted as queued
+ */
+struct io_uring_sqe* UringEngine::nextSqe() {
+	//Declare local
+	const unsigned tail = *sqTail_;
+
+	if(tail - __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE) >= sqEntries_) {
+		enter(0, 0);
+		if(tail - __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE) >= sqEntries_)
+			throw SocketException(EBUSY, "io_uring submission queue is full");
+	}
+
+	//Entries are only read by the kernel when submitted
+	const unsigned index = tail & sqMask_;
+	struct io_uring_sqe* sqe = &sqes_[index];
+	memset(sqe, 0, sizeof(*sqe));
+	sqArray_[index] = index;
+	__atomic_store_n(sqTail_, tail + 1, __ATOMIC_RELEASE);
+	queued_++;
+	return sqe;
+}
+
+/*!	@brief Fill an entry for an operation on a socket
+ *	@param opcode The io_uring operation
+ *	@param handle The socket, replaced by its slot if registered
+ *	@param addr Buffer or address argument
+ *	@param len Length argument
+ *	@param op The operation, owned by the engine until it completes
+ *	@return The entry, for the caller to set operation specific fields
+ */
+struct io_uring_sqe* UringEngine::prepare(const u_int8_t opcode, const socket_t handle,
+	const void* addr, const u_int32_t len, std::unique_ptr<Op>&& op)
+{
+	//Declare local
+	const int slot = fileIndex(handle);
+
+	struct io_uring_sqe* sqe = nextSqe();
+	sqe->opcode = opcode;
+	sqe->fd = handle;
+	if(slot >= 0) {
+		sqe->fd = slot;
+		sqe->flags |= IOSQE_FIXED_FILE;
+	}
+	sqe->addr = (u_int64_t)addr;
+	sqe->len = len;
+	sqe->user_data = nextId_;
+	inflight_.emplace(nextId_++, std::move(op));
+	return sqe;
+}
+
+/*!	@brief Queue a cancel request for an operation in flight
+ *	@param id The operation's user data
+ *	@param op The operation, skipped if a cancel was already submitted
+ */
+void UringEngine::cancelOp(const u_int64_t id, Op& op) {
+	if(op.cancelled)
+		return;
+
+	//Cancel requests complete with user data 0, which reap() ignores
+	struct io_uring_sqe* sqe = nextSqe();
+	sqe->opcode = IORING_OP_ASYNC_CANCEL;
+	sqe->fd = -1;
+	sqe->addr = id;
+	sqe->user_data = 0;
+	op.cancelled = true;
+}
+
+/*!	@brief Cancel every operation in flight and wait for them to complete
+ *	Their callbacks are not called, the operations are abandoned.
+ */
+void UringEngine::drain() {
+	while(!inflight_.empty()) {
+		//A full ring stops the cancels, reaping below makes room for the rest
+		try {
+			for(auto& inflight : inflight_)
+				cancelOp(inflight.first, *inflight.second);
+		}
+		catch(const SocketException&) {
+		}
+		enter(1, -1);
+		reap(false);
+	}
+}
+
+/*!	@brief Submit queued entries and optionally wait for a completion
+ *	@param wait 1 to wait for a completion, 0 to only submit
+ *	@param timeout Milliseconds to wait, or -1 to wait indefinitely
+ */
+void UringEngine::enter(const unsigned wait, const int timeout) {
+	//Declare local
+	struct __kernel_timespec ts;
+	struct io_uring_getevents_arg arg;
+	unsigned flags = wait ? IORING_ENTER_GETEVENTS : 0;
+	void* argp = nullptr;
+	size_t argsz = 0;
+
+	if(wait && timeout >= 0) {
+		ts.tv_sec = timeout / 1000;
+		ts.tv_nsec = (timeout % 1000) * 1000000L;
+		memset(&arg, 0, sizeof(arg));
+		arg.ts = (u_int64_t)&ts;
+		flags |= IORING_ENTER_EXT_ARG;
+		argp = &arg;
+		argsz = sizeof(arg);
+	}
+
+	for(;;) {
+		const int submitted = ::syscall(__NR_io_uring_enter, ring_, queued_, wait, flags, argp, argsz);
+		if(submitted >= 0) {
+			queued_ -= std::min((unsigned)submitted, queued_);
+			return;
+		}
+		if(errno == EINTR)
+			continue;
+		//Timed out, or completions must be reaped before more are accepted
+		if(errno == ETIME || errno == EBUSY || errno == EAGAIN)
+			return;
+		throw SocketException(errno, std::string("Error submitting to io_uring: ") + strerror(errno));
+	}
+}
+
+/*!	@brief Call the callbacks of every completion in the ring
+ *	@param dispatch False to discard the completions instead, closing any
+ *		socket accepted since no callback will take it
+ *	@return The number of completions handled
+ */
+size_t UringEngine::reap(const bool dispatch) {
+	//Declare local
+	size_t dispatched = 0;
+
+	for(;;) {
+		const unsigned head = *cqHead_;
+		if(head == __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE))
+			break;
+
+		//Copy out and free the slot before running the callback
+		const struct io_uring_cqe* cqe = &cqes_[head & cqMask_];
+		const u_int64_t id = cqe->user_data;
+		const int result = cqe->res;
+		__atomic_store_n(cqHead_, head + 1, __ATOMIC_RELEASE);
+
+		auto it = inflight_.find(id);
+		if(it == inflight_.end())
+			continue;
+		std::unique_ptr<Op> op = std::move(it->second);
+		inflight_.erase(it);
+
+		dispatched++;
+		if(!dispatch) {
+			if(!op->done && result >= 0)
+				::close(result);
+		}
+		else if(op->done)
+			op->done(result);
+		else if(result < 0)
+			op->accepted(result, ConnectionEndpoint());
+		else
+			op->accepted(0, endpoint(result, op->address, op->addrLen));
+	}
+
+	return dispatched;
+}
+
+/*!	@brief Register or unregister a resource with the ring
+ *	@param opcode The io_uring register operation
+ *	@param arg Array of resources
+ *	@param count Number of resources in the array
+ */
+void UringEngine::registerResource(const unsigned opcode, const void* arg, const unsigned count) {
+	if(::syscall(__NR_io_uring_register, ring_, opcode, arg, count) < 0)
+		throw SocketException(errno, std::string("Error registering with io_uring: ") + strerror(errno));
+}
+
+/*!	@brief Returns a length that fits an entry and an int result
+ *	@param len The requested length
+ *	@return The length, capped at INT_MAX so larger requests complete partially
+ */
+u_int32_t UringEngine::clampLength(const size_t len) {
+	return (u_int32_t)std::min<size_t>(len, INT_MAX);
+}
+
+/*!	@brief Unmap the rings and close the ring descriptor */
+void UringEngine::destroy() {
+	if(sqes_)
+		::munmap(sqes_, sqesSize_);
+	if(cqRing_ && cqRing_ != sqRing_)
+		::munmap(cqRing_, cqRingSize_);
+	if(sqRing_)
+		::munmap(sqRing_, sqRingSize_);
+	if(ring_ >= 0)
+		::close(ring_);
+	sqes_ = nullptr;
+	cqRing_ = sqRing_ = nullptr;
+	ring_ = -1;
+}
+
+} //Inet namespace
@@ -0,0 +1,140 @@
+/*!
+ *
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//Include once
+#ifndef URINGENGINE_H_INCLUDED
+#define URINGENGINE_H_INCLUDED
+
+//System includes
+#include <sys/types.h>
+#include <linux/io_uring.h>
+
+//Library includes
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+//Project includes
+#include "IoEngine.h"
+
+//Namespace container
+namespace Inet {
+
+/*!	@brief Completion-based engine using io_uring
+ *	Operations are written straight into the shared submission ring, and
+ *	everything queued between polls is handed to the kernel with a single
+ *	system call, which also waits for completions. Completions are read
+ *	from the shared completion ring without a system call.
+ *
+ *	Receives and sends on memory inside a registered buffer use the fixed
+ *	buffer opcodes, and operations on a registered socket refer to it by
+ *	its slot in the fixed file table. The ring is driven with the raw
+ *	system calls, so no io_uring library is needed.
+ */
+class UringEngine : public IoEngine {
+public:
+	/*!	@brief Set up the ring
+	 *	@param entries Submission queue depth, rounded up by the kernel
+	 *	@throw SocketException if the kernel lacks io_uring or the features
+	 *		the engine relies on, as on kernels older than 5.11
+	 */
+	explicit UringEngine(const unsigned entries = 256);
+
+	/*!	@brief Destructor, cancels and waits out any operations in flight
+	 *	before tearing down the ring, without calling their callbacks
+	 */
+	virtual ~UringEngine();
+
+	virtual const char* name() const { return "io_uring"; }
+	virtual void accept(const AbstractSocket& sock, AcceptCompletion_t done);
+	virtual void receive(const AbstractSocket& sock, char* buf, const size_t len, Completion_t done);
+	virtual void send(const AbstractSocket& sock, const char* buf, const size_t len, Completion_t done);
+	virtual void cancel(const AbstractSocket& sock);
+	virtual size_t poll(const int timeout = -1);
+	virtual size_t pending() const { return inflight_.size(); }
+	virtual void registerBuffers(const std::vector<struct iovec>& buffers);
+	virtual void registerFiles(const std::vector<socket_t>& handles);
+	virtual void unregisterBuffers();
+	virtual void unregisterFiles();
+
+protected:
+	/*!	@brief Operation owned by the engine until it completes */
+	struct Op {
+		socket_t						handle;			///< Socket operated on
+		Completion_t				done;				///< Receive and send completion
+		AcceptCompletion_t	accepted;		///< Accept completion
+		SockAddrIn_t				address;		///< Peer address written by accept
+		socklen_t						addrLen;		///< Length of the peer address
+		bool								cancelled;	///< A cancel has been submitted
+	};
+
+	/*!	@brief Take the next submission entry, flushing the ring if full */
+	struct io_uring_sqe* nextSqe();
+
+	/*!	@brief Fill an entry for an operation on a socket */
+	struct io_uring_sqe* prepare(const u_int8_t opcode, const socket_t handle,
+		const void* addr, const u_int32_t len, std::unique_ptr<Op>&& op);
+
+	/*!	@brief Submit queued entries and optionally wait for a completion */
+	void enter(const unsigned wait, const int timeout);
+
+	/*!	@brief Queue a cancel request for an operation in flight */
+	void cancelOp(const u_int64_t id, Op& op);
+
+	/*!	@brief Cancel every operation in flight and wait for them to complete */
+	void drain();
+
+	/*!	@brief Call the callbacks of every completion in the ring, or discard them */
+	size_t reap(const bool dispatch = true);
+
+	/*!	@brief Register or unregister a resource with the ring */
+	void registerResource(const unsigned opcode, const void* arg, const unsigned count);
+
+	/*!	@brief Returns a length that fits an entry and an int result */
+	static u_int32_t clampLength(const size_t len);
+
+	/*!	@brief Unmap the rings and close the ring descriptor */
+	void destroy();
+
+private:
+	int																	ring_ = -1;
+	void*																sqRing_ = nullptr;
+	void*																cqRing_ = nullptr;
+	size_t															sqRingSize_ = 0;
+	size_t															cqRingSize_ = 0;
+	struct io_uring_sqe*								sqes_ = nullptr;
+	size_t															sqesSize_ = 0;
+	unsigned*														sqHead_ = nullptr;
+	unsigned*														sqTail_ = nullptr;
+	unsigned*														sqArray_ = nullptr;
+	unsigned														sqMask_ = 0;
+	unsigned														sqEntries_ = 0;
+	unsigned*														cqHead_ = nullptr;
+	unsigned*														cqTail_ = nullptr;
+	unsigned														cqMask_ = 0;
+	struct io_uring_cqe*								cqes_ = nullptr;
+	unsigned														queued_ = 0;		///< Entries not yet submitted
+	u_int64_t														nextId_ = 1;		///< 0 marks cancel requests
+	std::unordered_map<u_int64_t, std::unique_ptr<Op>>	inflight_;
+};
+
+} //Inet namespace
+
+#endif //URINGENGINE_H_INCLUDED
@@ -23,6 +23,7 @@
 //System includes
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <poll.h>
 #include <unistd.h>
 #include <errno.h>
 
@@ -47,24 +48,23 @@
 //Namespace container
 namespace Inet {
 
-//Typedefs
-typedef std::unique_ptr<char[]>				BufferPtr_t;
-
+/*!	@brief Wait until a non-blocking socket is ready
+ *	@param sock The socket to wait on
+ *	@param events POLLIN or POLLOUT
+ */
+void WaitReady(const AbstractSocket& sock, short events) {
+	struct pollfd pfd = { sock.handle(), events, 0 };
+	while(::poll(&pfd, 1, -1) < 0 && errno == EINTR) {}
+}
 
-/*!	@brief Send a message to the endpoint specified
+/*!	@brief Send a message to the endpoint specified as one frame
  *	@param conn The ConnectionEndpoint to which the message will be sent
- *	@param buffer The buffer containing message data
- *	@param buflen The length of data in the buffer
+ *	@param message The stream holding the message data
  *	@return True if send is successful, false on failure
  */
-bool SendMessage(ConnectionEndpoint& conn, BufferPtr_t& buffer, int32_t buflen) {
-	//Declare local
-	uint32_t netbytes = htonl(buflen);
-	int32_t len = 0;
-
+bool SendMessage(ConnectionEndpoint& conn, const NetStream& message) {
 	try {
-		len = conn.send((char*)&netbytes, sizeof(uint32_t));
-		len = conn.send((char*)&buffer[0], buflen);
+		conn.sendStream(message);
 	}
 	catch(SocketException& se) {
 		return false;
@@ -72,46 +72,19 @@ bool SendMessage(ConnectionEndpoint& conn, BufferPtr_t& buffer, int32_t buflen)
 	return true;
 }
 
-/*!	@brief Recieve a message from the endpoint, adjusting buffer size and alloc as necessary
+/*!	@brief Recieve a message frame from the endpoint into a stream
  *	@param conn The ConnectionEndpoint from which the message will be read
- *	@param buffer The buffer to receive the message data
- *	@param buflen The bytes currently allocated at buffer, output adjusted if realloc
+ *	@param message The stream to receive the message data, replaced each call
  *	@return True if a message was read, false if the connection was closed
  */
-bool ReceiveMessage(ConnectionEndpoint& conn, BufferPtr_t& buffer, uint32_t& buflen, uint32_t& chunks) {
-	//Local data
-	int32_t len = 0;
-	uint32_t msglen = 0;
-
+bool ReceiveMessage(ConnectionEndpoint& conn, NetStream& message) {
 	try {
-		//Get the buffer length from first 4 bytes and byte-swap network to host
-		len = conn.receive((char*)&msglen, 4);
-		if(len > 0) {
-			msglen = ntohl(msglen);
-
-			//Realloc auto ptr if required, first pass recvlen == >0, buflen == 0
-			if(msglen != buflen) {
-				//Reset buffer and allocate new array (should only on first client message)
-				buffer.reset();
-				buffer = std::unique_ptr<char[]>(new char[msglen]);
-				buflen = msglen;
-			}
-
-			//Receive data
-			uint32_t totalbytes = 0;
-			while(totalbytes < msglen) {
-				len = conn.receive((char*)&buffer[totalbytes], msglen - totalbytes);
-				totalbytes += len;
-				chunks++;
-			}
-		}
+		return conn.receiveStream(message);
 	}
 	catch(SocketException &clientSe) {
 		//Client has gone away?
 		return false;
 	}
-
-	return true;
 }
 
 }; //Inet namespace
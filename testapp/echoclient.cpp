@@ -52,9 +52,6 @@ bool blocking					= true;
  *	@return Non-zero return value on application error
  */
 int main(int argc, char *argv[]) {
-	//Declare locals for message buffer
-	uint32_t recvbytes = 0;
-
 	try {
 		//Process command line
 		GetArgs(argc, argv);
@@ -72,28 +69,31 @@ int main(int argc, char *argv[]) {
 
 		//Create a client socket instance and connect to first returned address
 		ClientSocket *client = new ClientSocket();
+		client->setBlocking(blocking);
 		client->connect(*(upAddr.get()));
 
-		//Build message buffers
+		//Build the message as a single blob, the reply is read back the same way
 		std::unique_ptr<char[]> buffer(new char[msgSize]);
 		memset((char*)&buffer[0], 'A', msgSize);
-		std::unique_ptr<char[]> recvbuf(new char[msgSize]);
+		NetStream message(NetStream::Order::FIFO), reply(NetStream::Order::FIFO);
+		message.write(&buffer[0], msgSize);
 
 		//Loop for send/receive
 		for(int i = 0; i < msgCount; i++) {
 			//Output message and send data to echo server
 			std::cout << "Sending message to server... ";
-			SendMessage(*client, buffer, msgSize);
-
-			//Chunk counter
-			uint32_t chunks = 0;
-			ReceiveMessage(*client, recvbuf, recvbytes, chunks);
-
-			//Output message
-			std::cout << "Read " << msgSize << "-byte reply in " << chunks << " chunk(s) of data: ";
+			SendMessage(*client, message);
+			if(!ReceiveMessage(*client, reply)) {
+				std::cout << "Server closed the connection." << std::endl;
+				break;
+			}
 
 			//Compare messages
-			if(memcmp(&buffer[0], &recvbuf[0], msgSize) == 0)
+			const char* recvbuf = nullptr;
+			size_t recvbytes = 0;
+			reply.read(recvbuf, recvbytes);
+			std::cout << "Read " << recvbytes << "-byte reply: ";
+			if(recvbytes == msgSize && memcmp(&buffer[0], recvbuf, msgSize) == 0)
 				std::cout << "VALID" << std::endl;
 			else
 				std::cout << "INVALID" << std:: endl;
@@ -181,7 +181,7 @@ void GetArgs(int argc, char **argv) {
 				std::cout << "                The default message size is 1024 bytes." << std::endl;
 				std::cout << "  -c <COUNT>    The number of times to send an echo request" << std::endl;
 				std::cout << "                10 requests are sent by default." << std::endl;
-				std::cout << "  -n            Configure server socket as non-blocking" << std::endl;
+				std::cout << "  -n            Configure client socket as non-blocking" << std::endl;
 				std::cout << "                The client socket will be configured as blocking by default." << std::endl;
 				std::cout << "  -h            Display help for this application" << std::endl;
 				throw 0;
@@ -22,27 +22,35 @@
 #include <sys/socket.h>
 #include <unistd.h>
 #include <errno.h>
+#include <signal.h>
 
 //Library includes
 #include <utility>
 #include <exception>
 #include <iostream>
 #include <cstring>
+#include <memory>
+#include <unordered_map>
+#include <vector>
 
 //Project includes
 #include "appcommon.h"
 #include "Address.h"
 #include "ServerSocket.h"
+#include "ShardedServer.h"
+#include "FrameParser.h"
 
 using namespace Inet;
 
 //Forward decl funcs
 void GetArgs(int argc, char **argv);
+void RunSharded();
 
 //Globals
 uint16_t port					= 30100; //TODO: Fix this so client and server take similar types
 bool blocking					= true;
 bool oneshot 					= true;
+size_t threads					= 0;
 
 /*!	@brief
  *	@return Non-zero return value on application error
@@ -55,6 +63,12 @@ int main(int argc, char *argv[]) {
 		//Process command line
 		GetArgs(argc, argv);
 
+		//Sharded mode runs until interrupted
+		if(threads > 0) {
+			RunSharded();
+			return 0;
+		}
+
 		//Output message
 		std::cout << "Listening on port " << port;
 		if(!blocking) std::cout << " using non-blocking socket";
@@ -62,34 +76,29 @@ int main(int argc, char *argv[]) {
 
 		//Create the server socket and bind. Set listen backlog and socket opts as reqd
 		ServerSocket *pSock = new ServerSocket();
+		pSock->setBlocking(blocking);
 		pSock->bind(port);
 		pSock->listen(12);
 
 		do {
-			//Buffer stored using unique ptr and sizes
-			std::unique_ptr<char[]> buffer;
-			uint32_t buflen = 0;
+			//Each frame is received into the same stream's storage
+			NetStream message(NetStream::Order::FIFO);
 
 			//Accept connection
 			std::cout << "Waiting for clients..." << std::endl;
-			ConnectionEndpoint &&client = pSock->accept();
+			ConnectionEndpoint client;
+			while(!pSock->accept(client))
+				WaitReady(*pSock, POLLIN);
 
 			//Receive messages from the client and echo them back until connection closed
-			bool connected = true;
-			do {
-				//Receive client message data
-				uint32_t chunks = 0;
-				connected = ReceiveMessage(client, buffer, buflen, chunks);
-				if(connected) {
-					//Output message
-					std::cout << "Message length: " << buflen << " bytes in " <<
-					chunks << " chunk(s), echoing...";
-
-					//Echo reply to client
-					SendMessage(client, buffer, buflen);
-					std::cout << " Done." << std::endl;
-				}
-			} while(connected); //Continue until socket close by client
+			while(ReceiveMessage(client, message)) {
+				//Output message
+				std::cout << "Message length: " << message.size() << " bytes, echoing...";
+
+				//Echo reply to client
+				SendMessage(client, message);
+				std::cout << " Done." << std::endl;
+			}
 
 			//Output message
 			std::cout << "Peer disconnected." << std::endl;
@@ -112,6 +121,100 @@ int main(int argc, char *argv[]) {
 	return 0;
 }
 
+/*!	@brief A client served by a shard's event loop */
+struct ShardClient {
+	ConnectionEndpoint	endpoint;		///< Non-blocking connection to the client
+	FrameParser					parser;			///< Reassembles frames split across reads
+	NetStream						reply;			///< Storage reused for each echoed frame
+
+	explicit ShardClient(ConnectionEndpoint&& client) :
+		endpoint(std::move(client)), parser(NetStream::Order::FIFO), reply(NetStream::Order::FIFO) {}
+};
+
+//Clients by handle, one map per shard and only touched from that shard's thread
+typedef std::unordered_map<socket_t, std::unique_ptr<ShardClient>>		ShardClients_t;
+
+/*!	@brief Echo every complete frame waiting on a client
+ *	@param client The client whose socket is readable
+ *	@param shard The shard serving the client, for output
+ *	@return False once the client has closed or failed
+ */
+bool EchoFrames(ShardClient& client, const size_t shard) {
+	//Declare locals
+	char buf[64 * 1024];
+	NetStreamView frame(nullptr, 0);
+
+	try {
+		//Edge-triggered, so read until the socket is drained
+		for(;;) {
+			const int bytes = client.endpoint.receive(buf, sizeof(buf));
+			if(bytes == WOULD_BLOCK)
+				return true;
+			if(bytes == 0)
+				return false;
+
+			client.parser.feed(buf, bytes);
+			while(client.parser.next(frame)) {
+				memcpy(client.reply.prepareRaw(frame.remaining()), frame.data(), frame.remaining());
+				client.endpoint.sendStream(client.reply);
+				std::cout << "[" << shard << "] Echoed " << client.reply.size() << " bytes." << std::endl;
+			}
+		}
+	}
+	catch(const std::exception &e) {
+		std::cout << "[" << shard << "] " << e.what() << std::endl;
+	}
+	return false;
+}
+
+/*!	@brief Serve clients with one listener and event loop per thread on the same port
+ *	Each thread echoes frames for all of its clients from its event loop, the
+ *	kernel spreads new connections across the threads. Runs until SIGINT or
+ *	SIGTERM.
+ */
+void RunSharded() {
+	//Declare locals
+	sigset_t signals;
+	int signal = 0;
+
+	//Block the signals before the workers start so only sigwait() sees them
+	sigemptyset(&signals);
+	sigaddset(&signals, SIGINT);
+	sigaddset(&signals, SIGTERM);
+	pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+	ShardedServer server(threads);
+	std::vector<ShardClients_t> clients(server.shards());
+	server.start(port, 12, [&clients](ConnectionEndpoint&& client, EventLoop& loop, const size_t shard) {
+		//Accepted clients are non-blocking, so the loop is never held by one of them
+		std::unique_ptr<ShardClient> served(new ShardClient(std::move(client)));
+		ShardClient* conn = served.get();
+		ShardClients_t& shardClients = clients[shard];
+		shardClients[conn->endpoint.handle()] = std::move(served);
+
+		loop.add(conn->endpoint, EventLoop::READ, [conn, &loop, &shardClients, shard](u_int32_t events) {
+			if(!(events & EventLoop::READ) || !EchoFrames(*conn, shard)) {
+				//The loop keeps this callback alive until it returns
+				const socket_t handle = conn->endpoint.handle();
+				loop.remove(conn->endpoint);
+				conn->endpoint.close();
+				shardClients.erase(handle);
+			}
+		});
+	});
+
+	std::cout << "Listening on port " << port << " with " << server.shards() <<
+		" threads, interrupt to stop." << std::endl;
+	sigwait(&signals, &signal);
+	server.stop();
+
+	//The loops have stopped, so the remaining clients can be closed here
+	for(ShardClients_t& shardClients : clients) {
+		for(auto& client : shardClients)
+			client.second->endpoint.close();
+	}
+}
+
 /*!	@brief Process command line arguments
  * 	@param argc As passed to main()
  * 	@param argv As passed to main()
@@ -121,13 +224,18 @@ void GetArgs(int argc, char **argv) {
 	char c;
 
 	//Iterate over arguments
-	while((c = getopt(argc, argv, "p:nfh")) != -1) {
+	while((c = getopt(argc, argv, "p:t:nfh")) != -1) {
 		switch(c) {
 			//Get port to use for connect address
 			case 'p':
 				if(strlen(optarg) > 0) port = atol(optarg);
 				break;
 
+			//Get number of sharded listener threads
+			case 't':
+				if(strlen(optarg) > 0) threads = atol(optarg);
+				break;
+
 			//Set non-blocking socket
 			case 'n':
 				blocking = false;
@@ -151,6 +259,8 @@ void GetArgs(int argc, char **argv) {
 				std::cout << "Options: " << std::endl;
 				std::cout << "   -p <PORT>    Specify the port on which the server will listen" << std::endl;
 				std::cout << "                Port 30100 is used by default." << std::endl;
+				std::cout << "   -t <COUNT>   Listen with COUNT threads sharing the port, one per core" << std::endl;
+				std::cout << "                Runs until interrupted, -f is implied, clients are non-blocking." << std::endl;
 				std::cout << "   -n           Configure server socket as non-blocking" << std::endl;
 				std::cout << "                The client socket will be configured as blocking by default." << std::endl;
 				std::cout << "   -f           Don't exit when client closes connection" << std::endl;
@@ -0,0 +1,186 @@
+/**
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//Include once
+#ifndef EVENTLOOPTESTS_H_INCLUDED
+#define EVENTLOOPTESTS_H_INCLUDED
+
+//CxxTest includes
+#include <cxxtest/TestSuite.h>
+
+//System includes
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <errno.h>
+
+//Standard library includes
+#include <memory>
+#include <thread>
+
+//Include library headers
+#include "ConnectionEndpoint.h"
+#include "EventLoop.h"
+#include "SocketException.h"
+
+//Include shared test config header
+#include "TestCommon.h"
+
+//Using Inet namespace
+using namespace Inet;
+
+/*!
+ * Unit tests for dispatching socket readiness with EventLoop
+ * @author jcleland
+ */
+class EventLoopTests : public CxxTest::TestSuite {
+public:
+	/*!	@brief Create a connected pair of endpoints */
+	void setUp() {
+		MakePair(left_, right_);
+		left_->setBlocking(false);
+		right_->setBlocking(false);
+	}
+
+	/*!	@brief Close the endpoints */
+	void tearDown() {
+		left_.reset();
+		right_.reset();
+	}
+
+	/*!	@brief Test a read callback fires once per edge and drains the socket */
+	void test_read(void) {
+		EventLoop loop;
+		char buf[16];
+		size_t calls = 0, bytes = 0;
+
+		try {
+			loop.add(*right_, EventLoop::READ, [&](u_int32_t events) {
+				TS_ASSERT(events & EventLoop::READ);
+				calls++;
+
+				//Read until the socket would block
+				ssize_t n;
+				while((n = ::read(right_->handle(), buf, sizeof(buf))) > 0)
+					bytes += n;
+				TS_ASSERT(n < 0 && errno == EAGAIN);
+			});
+			TS_ASSERT(loop.size() == 1);
+			TS_ASSERT(loop.poll(0) == 0);
+
+			left_->send("event loop", 10);
+			TS_ASSERT(loop.poll(1000) == 1);
+			TS_ASSERT(calls == 1 && bytes == 10);
+
+			//No new edge until more data arrives
+			TS_ASSERT(loop.poll(0) == 0);
+			left_->send("again", 5);
+			TS_ASSERT(loop.poll(1000) == 1);
+			TS_ASSERT(calls == 2 && bytes == 15);
+
+			loop.remove(*right_);
+			TS_ASSERT(loop.size() == 0);
+			left_->send("ignored", 7);
+			TS_ASSERT(loop.poll(0) == 0);
+		}
+		catch(const SocketException &se) {
+			TS_FAIL(se.what());
+		}
+	}
+
+	/*!	@brief Test write readiness and switching the watched events */
+	void test_write(void) {
+		EventLoop loop;
+		u_int32_t seen = 0;
+
+		try {
+			//Blocking sockets are rejected and left in blocking mode
+			left_->setBlocking(true);
+			TS_ASSERT_THROWS(loop.add(*left_, EventLoop::WRITE, [](u_int32_t) {}), SocketException);
+			TS_ASSERT(loop.size() == 0 && left_->blocking());
+			left_->setBlocking(false);
+
+			loop.add(*left_, EventLoop::WRITE, [&](u_int32_t events) { seen = events; });
+			TS_ASSERT(loop.poll(1000) == 1);
+			TS_ASSERT(seen & EventLoop::WRITE);
+
+			//Registering twice is an error
+			TS_ASSERT_THROWS(loop.add(*left_, EventLoop::READ, [](u_int32_t) {}), SocketException);
+
+			seen = 0;
+			loop.modify(*left_, EventLoop::READ);
+			right_->send("x", 1);
+			TS_ASSERT(loop.poll(1000) == 1);
+			TS_ASSERT((seen & EventLoop::READ) && !(seen & EventLoop::WRITE));
+		}
+		catch(const SocketException &se) {
+			TS_FAIL(se.what());
+		}
+	}
+
+	/*!	@brief Test the peer closing is reported and callbacks can remove themselves */
+	void test_hangup(void) {
+		EventLoop loop;
+		size_t calls = 0;
+
+		try {
+			loop.add(*right_, EventLoop::READ, [&](u_int32_t events) {
+				TS_ASSERT(events & EventLoop::HANGUP);
+				calls++;
+				loop.remove(*right_);
+				right_->close();
+			});
+			left_->close();
+			TS_ASSERT(loop.poll(1000) == 1);
+			TS_ASSERT(calls == 1 && loop.size() == 0);
+		}
+		catch(const SocketException &se) {
+			TS_FAIL(se.what());
+		}
+	}
+
+	/*!	@brief Test run() returns when stopped from a callback or another thread */
+	void test_stop(void) {
+		EventLoop loop;
+
+		try {
+			//Stopped from a callback
+			loop.add(*right_, EventLoop::READ, [&](u_int32_t) { loop.stop(); });
+			left_->send("s", 1);
+			loop.run();
+			TS_ASSERT(!loop.stopped());
+			loop.remove(*right_);
+
+			//Stopped from another thread while waiting
+			std::thread stopper([&]() { loop.stop(); });
+			loop.run();
+			stopper.join();
+			TS_ASSERT(!loop.stopped());
+		}
+		catch(const SocketException &se) {
+			TS_FAIL(se.what());
+		}
+	}
+
+private:
+	std::unique_ptr<PairEndpoint>		left_;
+	std::unique_ptr<PairEndpoint>		right_;
+};
+
+#endif //Include once
@@ -0,0 +1,219 @@
+/**
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//Include once
+#ifndef EXECUTORTESTS_H_INCLUDED
+#define EXECUTORTESTS_H_INCLUDED
+
+//CxxTest includes
+#include <cxxtest/TestSuite.h>
+
+//System includes
+#include <sys/types.h>
+
+//Standard library includes
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+//Include library headers
+#include "Executor.h"
+#include "NetStream.h"
+#include "StreamException.h"
+
+//Using Inet namespace
+using namespace Inet;
+
+/*!
+ * Unit tests for the work-stealing executor
+ * @author jcleland
+ */
+class ExecutorTests : public CxxTest::TestSuite {
+public:
+	/*!	@brief Test every submitted task runs once */
+	void test_submit(void) {
+		Executor executor(4, false);
+		std::atomic<size_t> count(0);
+
+		TS_ASSERT_EQUALS(executor.workers(), 4u);
+		TS_ASSERT_EQUALS(executor.current(), Executor::ANY);
+		for(size_t i = 0; i < 1000; i++)
+			executor.submit([&]() { count++; });
+		executor.wait();
+
+		TS_ASSERT_EQUALS(count.load(), 1000u);
+		TS_ASSERT_EQUALS(executor.stats().submitted, 1000u);
+		TS_ASSERT_EQUALS(executor.stats().executed, 1000u);
+	}
+
+	/*!	@brief Test tasks run on their hinted worker unless stolen */
+	void test_affinity(void) {
+		Executor executor(4, false);
+		std::vector<size_t> ran(500, Executor::ANY);
+		size_t moved = 0;
+
+		for(size_t i = 0; i < ran.size(); i++)
+			executor.submit([&, i]() { ran[i] = executor.current(); }, 6);
+		executor.wait();
+
+		//Hint is taken modulo the worker count
+		for(size_t worker : ran) {
+			TS_ASSERT(worker < 4);
+			moved += worker != 2 ? 1 : 0;
+		}
+		TS_ASSERT_EQUALS(moved, executor.stats().stolen);
+	}
+
+	/*!	@brief Test a blocked worker's queue is drained by the others */
+	void test_steal(void) {
+		Executor executor(2, false);
+		std::atomic<bool> release(false);
+		std::atomic<size_t> count(0), stuck(Executor::ANY);
+
+		//Whichever worker picks up the blocker is the one left stuck
+		executor.submit([&]() { stuck = executor.current(); while(!release) std::this_thread::yield(); }, 0);
+		while(stuck == Executor::ANY)
+			std::this_thread::yield();
+		for(size_t i = 0; i < 10; i++)
+			executor.submit([&]() { count++; }, stuck);
+
+		//The worker is stuck, so everything queued behind it must be stolen
+		for(int i = 0; i < 1000 && count < 10; i++)
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		TS_ASSERT_EQUALS(count.load(), 10u);
+		release = true;
+		executor.wait();
+		TS_ASSERT(executor.stats().stolen >= 10);
+	}
+
+	/*!	@brief Test the owner runs its oldest task first and thieves take the newest */
+	void test_order(void) {
+		Executor executor(2, false);
+		std::atomic<bool> release0(false), release1(false);
+		std::atomic<size_t> started(0), done(0);
+		std::vector<size_t> owned, stolen;
+
+		//Worker 0 is busy before worker 1's blocker is queued, so neither is stolen
+		executor.submit([&]() { started++; while(!release0) std::this_thread::yield(); }, 0);
+		while(started < 1)
+			std::this_thread::yield();
+		executor.submit([&]() { started++; while(!release1) std::this_thread::yield(); }, 1);
+		while(started < 2)
+			std::this_thread::yield();
+
+		//Worker 1 steals everything queued on worker 0 while it stays blocked
+		for(size_t i = 0; i < 4; i++)
+			executor.submit([&, i]() { stolen.push_back(i); done++; }, 0);
+		release1 = true;
+		for(int i = 0; i < 1000 && done < 4; i++)
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		TS_ASSERT(stolen == std::vector<size_t>({ 3, 2, 1, 0 }));
+
+		//With worker 1 blocked again, worker 0 runs its own queue in order
+		release1 = false;
+		executor.submit([&]() { started++; while(!release1) std::this_thread::yield(); }, 1);
+		while(started < 3)
+			std::this_thread::yield();
+		for(size_t i = 0; i < 4; i++)
+			executor.submit([&, i]() { owned.push_back(i); done++; }, 0);
+		release0 = true;
+		for(int i = 0; i < 1000 && done < 8; i++)
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		release1 = true;
+		executor.wait();
+		TS_ASSERT(owned == std::vector<size_t>({ 0, 1, 2, 3 }));
+	}
+
+	/*!	@brief Test messages posted with one affinity are handled in order */
+	void test_post_order(void) {
+		Executor executor(1, false);
+		std::vector<u_int32_t> seen;
+
+		for(u_int32_t i = 0; i < 100; i++) {
+			NetStream message(NetStream::Order::FIFO);
+			message << i;
+			executor.post(std::move(message), [&](NetStream& msg) {
+				u_int32_t val = 0;
+				msg >> val;
+				seen.push_back(val);
+			}, 0);
+		}
+		executor.wait();
+
+		TS_ASSERT_EQUALS(seen.size(), 100u);
+		for(u_int32_t i = 0; i < seen.size(); i++)
+			TS_ASSERT_EQUALS(seen[i], i);
+	}
+
+	/*!	@brief Test tasks queued by a task stay with its worker and are waited for */
+	void test_nested(void) {
+		Executor executor(3, false);
+		std::atomic<size_t> count(0);
+
+		for(size_t i = 0; i < 3; i++) {
+			executor.submit([&]() {
+				for(size_t j = 0; j < 10; j++)
+					executor.submit([&]() { count++; });
+			}, i);
+		}
+		executor.wait();
+		TS_ASSERT_EQUALS(count.load(), 30u);
+		TS_ASSERT_EQUALS(executor.stats().executed, 33u);
+	}
+
+	/*!	@brief Test a task's exception is reported once by wait() */
+	void test_error(void) {
+		Executor executor(2, false);
+		std::atomic<size_t> count(0);
+
+		executor.submit([]() { throw StreamException(STREAM_ERR_END_OF_STREAM, "Task failed"); });
+		executor.submit([&]() { count++; });
+		TS_ASSERT_THROWS(executor.wait(), StreamException);
+		TS_ASSERT_EQUALS(count.load(), 1u);
+		TS_ASSERT_THROWS_NOTHING(executor.wait());
+	}
+
+	/*!	@brief Test a decoded message is handed over without copying */
+	void test_post(void) {
+		Executor executor(2);
+		NetStream message(NetStream::Order::FIFO);
+		std::string text;
+		int32_t value = 0;
+
+		message << std::string("posted") << (int32_t)42;
+		const char* data = message.data().data();
+		const char* seen = nullptr;
+		executor.post(std::move(message), [&](NetStream& msg) {
+			seen = msg.data().data();
+			msg >> text >> value;
+		}, 1);
+		executor.wait();
+
+		TS_ASSERT(seen == data);
+		TS_ASSERT(text == "posted");
+		TS_ASSERT_EQUALS(value, 42);
+		for(size_t i = 0; i < executor.workers(); i++)
+			TS_ASSERT(executor.cpu(i) >= 0);
+	}
+};
+
+#endif //Include once
@@ -0,0 +1,306 @@
+/**
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//Include once
+#ifndef IOENGINETESTS_H_INCLUDED
+#define IOENGINETESTS_H_INCLUDED
+
+//CxxTest includes
+#include <cxxtest/TestSuite.h>
+
+//System includes
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <errno.h>
+
+//Standard library includes
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <vector>
+
+//Include library headers
+#include "ConnectionEndpoint.h"
+#include "ServerSocket.h"
+#include "IoEngine.h"
+#include "SocketException.h"
+
+//Include shared test config header
+#include "TestCommon.h"
+
+//Using Inet namespace
+using namespace Inet;
+
+/*!
+ * Unit tests for asynchronous I/O with the io_uring and epoll engines
+ * @author jcleland
+ */
+class IoEngineTests : public CxxTest::TestSuite {
+public:
+	/*!	@brief Create a connected pair of endpoints and both engines */
+	void setUp() {
+		MakePair(left_, right_);
+
+		//Falls back to epoll twice where io_uring is unavailable
+		engines_.clear();
+		engines_.push_back(IoEngine::create(64));
+		engines_.push_back(IoEngine::create(64, false));
+	}
+
+	/*!	@brief Close the endpoints */
+	void tearDown() {
+		engines_.clear();
+		left_.reset();
+		right_.reset();
+	}
+
+	/*!	@brief Test a send and receive complete with their byte counts */
+	void test_send_receive(void) {
+		for(auto& engine : engines_) {
+			char buf[16] = {};
+			int sent = 1, received = 1;
+
+			try {
+				engine->receive(*right_, buf, sizeof(buf), [&](int result) { received = result; });
+				engine->send(*left_, "uring", 5, [&](int result) { sent = result; });
+				TS_ASSERT(engine->pending() == 2);
+				wait(*engine, [&]() { return engine->pending() == 0; });
+				TS_ASSERT_EQUALS(sent, 5);
+				TS_ASSERT_EQUALS(received, 5);
+				TS_ASSERT(memcmp(buf, "uring", 5) == 0);
+			}
+			catch(const SocketException &se) {
+				TS_FAIL(se.what());
+			}
+		}
+	}
+
+	/*!	@brief Test a length beyond 32 bits completes partially instead of wrapping */
+	void test_large_length(void) {
+		for(auto& engine : engines_) {
+			char buf[16] = {};
+			int received = 1;
+
+			try {
+				//Only the bytes waiting are written, whatever length is given
+				TS_ASSERT(::send(left_->handle(), "uring", 5, 0) == 5);
+				engine->receive(*right_, buf, (size_t)1 << 32, [&](int result) { received = result; });
+				wait(*engine, [&]() { return engine->pending() == 0; });
+				TS_ASSERT_EQUALS(received, 5);
+				TS_ASSERT(memcmp(buf, "uring", 5) == 0);
+			}
+			catch(const SocketException &se) {
+				TS_FAIL(se.what());
+			}
+		}
+	}
+
+	/*!	@brief Test the engines leave blocking sockets blocking */
+	void test_mode(void) {
+		for(auto& engine : engines_) {
+			char buf[16] = {};
+			int received = 0;
+
+			try {
+				engine->send(*left_, "mode", 4, [](int) {});
+				engine->receive(*right_, buf, sizeof(buf), [&](int result) { received = result; });
+				wait(*engine, [&]() { return engine->pending() == 0; });
+				TS_ASSERT_EQUALS(received, 4);
+				TS_ASSERT(right_->blocking());
+				TS_ASSERT((::fcntl(left_->handle(), F_GETFL, 0) & O_NONBLOCK) == 0);
+				TS_ASSERT((::fcntl(right_->handle(), F_GETFL, 0) & O_NONBLOCK) == 0);
+				engine->cancel(*left_);
+				engine->cancel(*right_);
+			}
+			catch(const SocketException &se) {
+				TS_FAIL(se.what());
+			}
+		}
+	}
+
+	/*!	@brief Test the peer closing completes a receive with 0 */
+	void test_closed(void) {
+		for(auto& engine : engines_) {
+			std::unique_ptr<PairEndpoint> left, right;
+			char buf[16];
+			int received = 1;
+
+			MakePair(left, right);
+			try {
+				engine->receive(*right, buf, sizeof(buf), [&](int result) { received = result; });
+				left->close();
+				wait(*engine, [&]() { return engine->pending() == 0; });
+				TS_ASSERT_EQUALS(received, 0);
+				engine->cancel(*right);
+			}
+			catch(const SocketException &se) {
+				TS_FAIL(se.what());
+			}
+		}
+	}
+
+	/*!	@brief Test operations on registered buffers and sockets */
+	void test_registered(void) {
+		for(auto& engine : engines_) {
+			std::vector<char> memory(8192);
+			char* out = memory.data();
+			char* in = memory.data() + 4096;
+			int sent = -1, received = -1;
+
+			try {
+				engine->registerBuffers({ { memory.data(), memory.size() } });
+				engine->registerFiles({ left_->handle(), right_->handle() });
+
+				memcpy(out, "registered", 10);
+				engine->send(*left_, out, 10, [&](int result) { sent = result; });
+				engine->receive(*right_, in, 4096, [&](int result) { received = result; });
+				wait(*engine, [&]() { return engine->pending() == 0; });
+				TS_ASSERT_EQUALS(sent, 10);
+				TS_ASSERT_EQUALS(received, 10);
+				TS_ASSERT(memcmp(in, "registered", 10) == 0);
+
+				engine->unregisterFiles();
+				engine->unregisterBuffers();
+			}
+			catch(const SocketException &se) {
+				TS_FAIL(se.what());
+			}
+		}
+	}
+
+	/*!	@brief Test a pending receive can be cancelled */
+	void test_cancel(void) {
+		for(auto& engine : engines_) {
+			char buf[16];
+			int received = 1;
+
+			try {
+				engine->receive(*right_, buf, sizeof(buf), [&](int result) { received = result; });
+				TS_ASSERT(engine->poll(0) == 0);
+				engine->cancel(*right_);
+				wait(*engine, [&]() { return engine->pending() == 0; });
+				TS_ASSERT_EQUALS(received, -ECANCELED);
+			}
+			catch(const SocketException &se) {
+				TS_FAIL(se.what());
+			}
+		}
+	}
+
+	/*!	@brief Test an accept completes with a connected endpoint */
+	void test_accept(void) {
+		const uint16_t listen = (uint16_t)atoi(port) + 1;
+		ServerSocket server;
+		SockAddrIn_t addr;
+
+		server.bind(listen);
+		server.listen(8);
+		memset(&addr, 0, sizeof(addr));
+		addr.sin_family = AF_INET;
+		addr.sin_port = htons(listen);
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+		for(auto& engine : engines_) {
+			int accepted = 1;
+			socket_t handle = INVALID_SOCKET;
+
+			try {
+				engine->accept(server, [&](int result, ConnectionEndpoint&& client) {
+					accepted = result;
+					handle = client.handle();
+				});
+				TS_ASSERT(engine->poll(0) == 0);
+
+				int client = ::socket(AF_INET, SOCK_STREAM, 0);
+				TS_ASSERT(::connect(client, (SockAddrPtr_t)&addr, sizeof(addr)) == 0);
+				wait(*engine, [&]() { return engine->pending() == 0; });
+				TS_ASSERT_EQUALS(accepted, 0);
+				TS_ASSERT(handle > 0);
+				::close(handle);
+				::close(client);
+				engine->cancel(server);
+			}
+			catch(const SocketException &se) {
+				TS_FAIL(se.what());
+			}
+		}
+		server.close();
+	}
+
+	/*!	@brief Test destroying an engine abandons its operations without consuming data */
+	void test_destroy(void) {
+		const uint16_t listen = (uint16_t)atoi(port) + 4;
+		ServerSocket server;
+		SockAddrIn_t addr;
+
+		server.bind(listen);
+		server.listen(8);
+		memset(&addr, 0, sizeof(addr));
+		addr.sin_family = AF_INET;
+		addr.sin_port = htons(listen);
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+		for(bool uring : { true, false }) {
+			char buf[16] = {};
+			bool called = false;
+
+			try {
+				std::unique_ptr<IoEngine> engine = IoEngine::create(64, uring);
+				engine->receive(*right_, buf, sizeof(buf), [&](int) { called = true; });
+				engine->accept(server, [&](int, ConnectionEndpoint&&) { called = true; });
+				TS_ASSERT(engine->poll(0) == 0);
+				engine.reset();
+				TS_ASSERT(!called);
+
+				//Data and connections arriving afterwards are left for the owner
+				TS_ASSERT(::send(left_->handle(), "later", 5, 0) == 5);
+				TS_ASSERT(::recv(right_->handle(), buf, sizeof(buf), 0) == 5);
+				int client = ::socket(AF_INET, SOCK_STREAM, 0);
+				TS_ASSERT(::connect(client, (SockAddrPtr_t)&addr, sizeof(addr)) == 0);
+				int accepted = ::accept(server.handle(), nullptr, nullptr);
+				TS_ASSERT(accepted >= 0);
+				::close(accepted);
+				::close(client);
+			}
+			catch(const SocketException &se) {
+				TS_FAIL(se.what());
+			}
+		}
+		server.close();
+	}
+
+private:
+	/*!	@brief Poll until the condition holds, for up to ten seconds */
+	static void wait(IoEngine& engine, std::function<bool()> done) {
+		for(int i = 0; i < 100 && !done(); i++)
+			engine.poll(100);
+		TS_ASSERT(done());
+	}
+
+	std::unique_ptr<PairEndpoint>					left_;
+	std::unique_ptr<PairEndpoint>					right_;
+	std::vector<std::unique_ptr<IoEngine>>	engines_;
+};
+
+#endif //Include once
@@ -0,0 +1,220 @@
+/**
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//Include once
+#ifndef SHARDEDSERVERTESTS_H_INCLUDED
+#define SHARDEDSERVERTESTS_H_INCLUDED
+
+//CxxTest includes
+#include <cxxtest/TestSuite.h>
+
+//System includes
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+//Standard library includes
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <thread>
+#include <vector>
+
+//Include library headers
+#include "ServerSocket.h"
+#include "ShardedServer.h"
+#include "SocketException.h"
+
+//Include shared test config header
+#include "TestCommon.h"
+
+//Using Inet namespace
+using namespace Inet;
+
+/*!
+ * Unit tests for the SO_REUSEPORT sharded acceptor
+ * @author jcleland
+ */
+class ShardedServerTests : public CxxTest::TestSuite {
+public:
+	/*!	@brief Test server sockets set both reuse options */
+	void test_reuse_options(void) {
+		ServerSocket first, second;
+		int value = 0;
+		socklen_t len = sizeof(value);
+
+		try {
+			first.bind(listen());
+			TS_ASSERT(getsockopt(first.handle(), SOL_SOCKET, SO_REUSEADDR, &value, &len) == 0);
+			TS_ASSERT(value != 0);
+			value = 0;
+			TS_ASSERT(getsockopt(first.handle(), SOL_SOCKET, SO_REUSEPORT, &value, &len) == 0);
+			TS_ASSERT(value != 0);
+
+			//A second listener can share the port
+			first.listen(8);
+			second.bind(listen());
+			second.listen(8);
+		}
+		catch(const SocketException &se) {
+			TS_FAIL(se.what());
+		}
+		second.close();
+		first.close();
+	}
+
+	/*!	@brief Test connections are accepted and spread across the shards */
+	void test_accept(void) {
+		const size_t clients = 64;
+		ShardedServer server(4);
+		std::atomic<size_t> handled(0);
+		std::atomic<bool> valid(true);
+		std::vector<int> peers;
+
+		try {
+			TS_ASSERT_EQUALS(server.shards(), 4u);
+			server.start(listen(), 64, [&](ConnectionEndpoint&& client, EventLoop&, const size_t shard) {
+				//Checked here, asserts aren't made from worker threads
+				if(shard >= 4 || client.blocking())
+					valid = false;
+				client.close();
+				handled++;
+			});
+			TS_ASSERT(server.running());
+			for(size_t i = 0; i < server.shards(); i++)
+				TS_ASSERT(server.cpu(i) >= 0);
+
+			for(size_t i = 0; i < clients; i++)
+				peers.push_back(connect());
+			wait([&]() { return handled == clients; });
+
+			//Every connection counted once, and the kernel used more than one listener
+			size_t total = 0, used = 0;
+			for(size_t i = 0; i < server.shards(); i++) {
+				total += server.accepted(i);
+				used += server.accepted(i) > 0 ? 1 : 0;
+			}
+			TS_ASSERT_EQUALS(total, clients);
+			TS_ASSERT(used > 1);
+			TS_ASSERT(valid);
+
+			server.stop();
+			TS_ASSERT(!server.running());
+		}
+		catch(const SocketException &se) {
+			TS_FAIL(se.what());
+		}
+		for(int peer : peers)
+			::close(peer);
+	}
+
+	/*!	@brief Test a handler can serve its connection on the shard's loop */
+	void test_loop(void) {
+		ShardedServer server(2, false);
+		std::vector<std::vector<std::unique_ptr<ConnectionEndpoint>>> clients(server.shards());
+
+		try {
+			server.start(listen(), 8, [&](ConnectionEndpoint&& client, EventLoop& loop, const size_t shard) {
+				//Each shard's list is only touched from its own thread
+				clients[shard].emplace_back(new ConnectionEndpoint(std::move(client)));
+				ConnectionEndpoint* conn = clients[shard].back().get();
+				loop.add(*conn, EventLoop::READ, [conn](u_int32_t) {
+					char buf[64];
+					int bytes;
+					while((bytes = conn->receive(buf, sizeof(buf))) > 0)
+						conn->send(buf, bytes);
+				});
+			});
+			TS_ASSERT(server.cpu(0) == -1);
+
+			int peer = connect();
+			char buf[8] = {};
+			TS_ASSERT(::send(peer, "sharded", 7, 0) == 7);
+			TS_ASSERT(::recv(peer, buf, 7, MSG_WAITALL) == 7);
+			TS_ASSERT(memcmp(buf, "sharded", 7) == 0);
+			::close(peer);
+
+			server.stop();
+		}
+		catch(const SocketException &se) {
+			TS_FAIL(se.what());
+		}
+		for(auto& shard : clients) {
+			for(auto& client : shard)
+				client->close();
+		}
+	}
+
+	/*!	@brief Test the server restarts and reports misuse */
+	void test_restart(void) {
+		ShardedServer server(2);
+		std::atomic<size_t> handled(0);
+		auto handler = [&](ConnectionEndpoint&& client, EventLoop&, const size_t) {
+			client.close();
+			handled++;
+		};
+
+		try {
+			server.stop();
+			server.start(listen(), 8, handler);
+			TS_ASSERT_THROWS(server.start(listen(), 8, handler), SocketException);
+			server.stop();
+
+			//Listeners are closed, so the port can be bound again
+			server.start(listen(), 8, handler);
+			::close(connect());
+			wait([&]() { return handled == 1; });
+			server.stop();
+		}
+		catch(const SocketException &se) {
+			TS_FAIL(se.what());
+		}
+	}
+
+private:
+	/*!	@brief Returns the port used by this suite */
+	static uint16_t listen() { return (uint16_t)atoi(port) + 3; }
+
+	/*!	@brief Returns a socket connected to the suite's port */
+	static int connect() {
+		SockAddrIn_t addr;
+		memset(&addr, 0, sizeof(addr));
+		addr.sin_family = AF_INET;
+		addr.sin_port = htons(listen());
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+		int peer = ::socket(AF_INET, SOCK_STREAM, 0);
+		TS_ASSERT(::connect(peer, (SockAddrPtr_t)&addr, sizeof(addr)) == 0);
+		return peer;
+	}
+
+	/*!	@brief Wait until the condition holds, for up to ten seconds */
+	static void wait(std::function<bool()> done) {
+		for(int i = 0; i < 1000 && !done(); i++)
+			std::this_thread::sleep_for(std::chrono::milliseconds(10));
+		TS_ASSERT(done());
+	}
+};
+
+#endif //Include once
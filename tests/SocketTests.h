@@ -0,0 +1,192 @@
+/**
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//Include once
+#ifndef SOCKETTESTS_H_INCLUDED
+#define SOCKETTESTS_H_INCLUDED
+
+//CxxTest includes
+#include <cxxtest/TestSuite.h>
+
+//System includes
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+//Standard library includes
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+//Include library headers
+#include "ConnectionEndpoint.h"
+#include "ServerSocket.h"
+#include "NetStream.h"
+#include "SocketException.h"
+
+//Include shared test config header
+#include "TestCommon.h"
+
+//Using Inet namespace
+using namespace Inet;
+
+/*!
+ * Unit tests for socket blocking modes
+ * @author jcleland
+ */
+class SocketTests : public CxxTest::TestSuite {
+public:
+	/*!	@brief Create a connected pair of endpoints */
+	void setUp() {
+		MakePair(left_, right_);
+	}
+
+	/*!	@brief Close the endpoints */
+	void tearDown() {
+		left_.reset();
+		right_.reset();
+	}
+
+	/*!	@brief Test a non-blocking receive reports would-block and a close */
+	void test_nonblocking_receive(void) {
+		char buf[16];
+
+		try {
+			right_->setBlocking(false);
+			TS_ASSERT(!right_->blocking());
+			TS_ASSERT(fcntl(right_->handle(), F_GETFL) & O_NONBLOCK);
+			TS_ASSERT_EQUALS(right_->receive(buf, sizeof(buf)), WOULD_BLOCK);
+
+			left_->send("ready", 5);
+			TS_ASSERT_EQUALS(right_->receive(buf, sizeof(buf)), 5);
+			TS_ASSERT_EQUALS(right_->receive(buf, sizeof(buf)), WOULD_BLOCK);
+
+			//Closed peer is reported as 0, not thrown
+			left_->close();
+			TS_ASSERT_EQUALS(right_->receive(buf, sizeof(buf)), 0);
+
+			right_->setBlocking(true);
+			TS_ASSERT(!(fcntl(right_->handle(), F_GETFL) & O_NONBLOCK));
+			TS_ASSERT_THROWS(right_->receive(buf, sizeof(buf)), SocketException);
+		}
+		catch(const SocketException &se) {
+			TS_FAIL(se.what());
+		}
+	}
+
+	/*!	@brief Test a non-blocking send reports partial writes and would-block */
+	void test_nonblocking_send(void) {
+		const std::vector<char> data(256 * 1024, 'w');
+		std::vector<char> buf(data.size());
+		size_t sent = 0, received = 0;
+		int bytes;
+
+		try {
+			left_->setBlocking(false);
+
+			//Fill the socket buffer until nothing more fits
+			while((bytes = left_->send(data.data(), data.size())) != WOULD_BLOCK) {
+				TS_ASSERT(bytes > 0 && (size_t)bytes <= data.size());
+				sent += bytes;
+			}
+			TS_ASSERT(sent > 0);
+
+			//Draining the peer makes room again
+			while(received < sent)
+				received += right_->receive(buf.data(), buf.size());
+			TS_ASSERT(left_->send(data.data(), 1) == 1);
+		}
+		catch(const SocketException &se) {
+			TS_FAIL(se.what());
+		}
+	}
+
+	/*!	@brief Test frames go through non-blocking sockets whole */
+	void test_nonblocking_frame(void) {
+		NetStream out(NetStream::Order::FIFO), in(NetStream::Order::FIFO);
+		const std::string big(1024 * 1024, 'f');
+		std::string str;
+
+		try {
+			left_->setBlocking(false);
+			right_->setBlocking(false);
+			out << big;
+
+			//Frame is larger than the socket buffer, so both ends must wait
+			std::thread receiver([&]() { right_->receiveStream(in); });
+			left_->sendStream(out);
+			receiver.join();
+			in >> str;
+			TS_ASSERT(str == big);
+		}
+		catch(const SocketException &se) {
+			TS_FAIL(se.what());
+		}
+	}
+
+	/*!	@brief Test a non-blocking server socket accepts only when a client waits */
+	void test_nonblocking_accept(void) {
+		const uint16_t listen = (uint16_t)atoi(port) + 2;
+		ServerSocket server;
+		ConnectionEndpoint client;
+		SockAddrIn_t addr;
+
+		try {
+			server.setBlocking(false);
+			server.bind(listen);
+			server.listen(8);
+			TS_ASSERT(fcntl(server.handle(), F_GETFL) & O_NONBLOCK);
+			TS_ASSERT(!server.accept(client));
+			TS_ASSERT_THROWS(server.accept(), SocketException);
+
+			memset(&addr, 0, sizeof(addr));
+			addr.sin_family = AF_INET;
+			addr.sin_port = htons(listen);
+			addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+			int peer = ::socket(AF_INET, SOCK_STREAM, 0);
+			TS_ASSERT(::connect(peer, (SockAddrPtr_t)&addr, sizeof(addr)) == 0);
+
+			//Accepted endpoint takes the requested mode
+			TS_ASSERT(server.accept(client, false));
+			TS_ASSERT(!client.blocking());
+			TS_ASSERT(fcntl(client.handle(), F_GETFL) & O_NONBLOCK);
+			char buf[4];
+			TS_ASSERT_EQUALS(client.receive(buf, sizeof(buf)), WOULD_BLOCK);
+
+			client.close();
+			::close(peer);
+		}
+		catch(const SocketException &se) {
+			TS_FAIL(se.what());
+		}
+		server.close();
+	}
+
+private:
+	std::unique_ptr<PairEndpoint>		left_;
+	std::unique_ptr<PairEndpoint>		right_;
+};
+
+#endif //Include once
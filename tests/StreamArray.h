@@ -0,0 +1,208 @@
+/**
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//Include once
+#ifndef STREAMARRAY_H_INCLUDED
+#define STREAMARRAY_H_INCLUDED
+
+//CxxTest includes
+#include <cxxtest/TestSuite.h>
+
+//Standard library includes
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstring>
+
+//Include library headers
+#include "NetStream.h"
+#include "StreamException.h"
+#include "ByteOrder.h"
+
+//Include shared test config header
+#include "TestCommon.h"
+
+//Using Inet namespace
+using namespace Inet;
+
+/*!
+ * Unit tests for NetStream integer array encoding
+ * @author jcleland
+ */
+class StreamArray : public CxxTest::TestSuite {
+public:
+	/*!	@brief Round-trip arrays of every supported type in both orders */
+	void test_roundtrip(void) {
+		const size_t counts[] = { 0, 1, 7, 33, 100003 };
+
+		for(size_t count : counts) {
+			roundtrip<int16_t>(count, NetStream::Order::LIFO);
+			roundtrip<u_int16_t>(count, NetStream::Order::LIFO);
+			roundtrip<int32_t>(count, NetStream::Order::LIFO);
+			roundtrip<u_int32_t>(count, NetStream::Order::FIFO);
+			roundtrip<int64_t>(count, NetStream::Order::FIFO);
+			roundtrip<u_int64_t>(count, NetStream::Order::FIFO);
+			roundtrip<float>(count, NetStream::Order::LIFO);
+			roundtrip<double>(count, NetStream::Order::FIFO);
+			roundtrip<char>(count, NetStream::Order::LIFO);
+			roundtrip<u_char>(count, NetStream::Order::FIFO);
+		}
+	}
+
+	/*!	@brief Round-trip packed varint arrays from compact streams */
+	void test_compact_roundtrip(void) {
+		const size_t counts[] = { 0, 1, 7, 33, 100003 };
+
+		for(size_t count : counts) {
+			roundtrip<int16_t>(count, NetStream::Order::LIFO, true);
+			roundtrip<u_int16_t>(count, NetStream::Order::FIFO, true);
+			roundtrip<int32_t>(count, NetStream::Order::LIFO, true);
+			roundtrip<u_int32_t>(count, NetStream::Order::FIFO, true);
+			roundtrip<int64_t>(count, NetStream::Order::LIFO, true);
+			roundtrip<u_int64_t>(count, NetStream::Order::FIFO, true);
+		}
+	}
+
+	/*!	@brief Test compact streams pack small integers without per-element markers */
+	void test_compact_layout(void) {
+		NetStream stream(NetStream::Order::FIFO);
+		std::vector<int32_t> values = { 0, -1, 64 };
+		std::vector<u_int16_t> narrow;
+		const char expected[] = {
+			'A', 0x00, 0x00, 0x00, 0x05, 'z',
+			0x00, 0x01, (char)0x80, 0x01, 'A'
+		};
+
+		stream.setCompact(true);
+		stream << values;
+		TS_ASSERT(stream.size() == sizeof(expected));
+		TS_ASSERT(memcmp(stream.data().data(), expected, sizeof(expected)) == 0);
+
+		//Signedness must match, values must fit the destination type
+		TS_ASSERT_THROWS(stream >> narrow, const StreamException&);
+		stream.seek(0);
+		stream.setCompact(true);
+		stream.prepareRaw(0);
+		stream << std::vector<u_int32_t>{ 1, 70000 };
+		TS_ASSERT_THROWS(stream >> narrow, const StreamException&);
+		TS_ASSERT(stream.offset() == 0);
+	}
+
+	/*!	@brief Test elements are written in network byte order */
+	void test_wire_layout(void) {
+		NetStream stream(NetStream::Order::FIFO);
+		std::vector<u_int32_t> values = { 0x01020304, 0x0a0b0c0d };
+		const char expected[] = {
+			'A', 0x00, 0x00, 0x00, 0x09, 'L',
+			0x01, 0x02, 0x03, 0x04, 0x0a, 0x0b, 0x0c, 0x0d, 'A'
+		};
+
+		stream << values;
+		TS_ASSERT(stream.size() == sizeof(expected));
+		TS_ASSERT(memcmp(stream.data().data(), expected, sizeof(expected)) == 0);
+	}
+
+	/*!	@brief Test double elements are written as network order IEEE-754 */
+	void test_float_wire_layout(void) {
+		NetStream stream(NetStream::Order::FIFO);
+		std::vector<double> values = { 1.0, -2.0 };
+		const char expected[] = {
+			'A', 0x00, 0x00, 0x00, 0x11, 'd',
+			0x3f, (char)0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			(char)0xc0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 'A'
+		};
+
+		stream << values;
+		TS_ASSERT(stream.size() == sizeof(expected));
+		TS_ASSERT(memcmp(stream.data().data(), expected, sizeof(expected)) == 0);
+	}
+
+	/*!	@brief Test decode into a caller-provided buffer */
+	void test_buffer_decode(void) {
+		NetStream stream(NetStream::Order::FIFO);
+		std::vector<int64_t> values = { -1, 2, -3, 4, -5 };
+		int64_t out[8] = { 0 };
+		size_t count = 4;
+
+		stream << values;
+
+		//Too small, nothing is consumed
+		TS_ASSERT_THROWS(stream.read(out, count), const StreamException&);
+		TS_ASSERT(stream.offset() == 0);
+
+		count = 8;
+		stream.read(out, count);
+		TS_ASSERT(count == values.size());
+		TS_ASSERT(memcmp(out, values.data(), sizeof(int64_t) * count) == 0);
+	}
+
+	/*!	@brief Test the element type is checked on decode */
+	void test_type_mismatch(void) {
+		NetStream stream;
+		std::vector<int32_t> values = { 1, 2, 3 };
+		std::vector<u_int32_t> out;
+
+		stream << values;
+		TS_ASSERT_THROWS(stream >> out, const StreamException&);
+	}
+
+	/*!	@brief Compare the selected conversion against a scalar swap */
+	void test_byte_order_copy(void) {
+		std::vector<u_int64_t> src(67), dst(67);
+		for(size_t i = 0; i < src.size(); i++)
+			src[i] = 0x0102030405060708ULL * (i + 1);
+
+		NetOrderCopy64(dst.data(), src.data(), src.size());
+		for(size_t i = 0; i < src.size(); i++)
+			TS_ASSERT(dst[i] == __builtin_bswap64(src[i]));
+
+		//In-place conversion is its own inverse
+		NetOrderCopy64(dst.data(), dst.data(), dst.size());
+		TS_ASSERT(dst == src);
+		TS_ASSERT(NetOrderBackend() != nullptr);
+	}
+
+private:
+	/*!	@brief Encode and decode an array surrounded by scalar values */
+	template<typename T>
+	void roundtrip(size_t count, NetStream::Order order, bool compact = false) {
+		NetStream stream(order);
+		std::vector<T> values(count), out;
+		int16_t before = 0, after = 0;
+
+		for(size_t i = 0; i < count; i++)
+			values[i] = (T)((i * 0x9E3779B97F4A7C15ULL) >> 7);
+
+		try {
+			stream.setCompact(compact);
+			stream << (int16_t)-1 << values << (int16_t)1;
+			if(order == NetStream::Order::FIFO)
+				stream >> before >> out >> after;
+			else
+				stream >> after >> out >> before;
+			TS_ASSERT(before == -1 && after == 1);
+			TS_ASSERT(out == values);
+		}
+		catch(const StreamException &se) {
+			TS_FAIL(se.what());
+		}
+	}
+};
+
+#endif //Include once
@@ -0,0 +1,187 @@
+/**
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//Include once
+#ifndef STREAMBLOB_H_INCLUDED
+#define STREAMBLOB_H_INCLUDED
+
+//CxxTest includes
+#include <cxxtest/TestSuite.h>
+
+//Standard library includes
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstring>
+
+//Include library headers
+#include "NetStream.h"
+#include "StreamException.h"
+
+//Include shared test config header
+#include "TestCommon.h"
+
+//Using Inet namespace
+using namespace Inet;
+
+/*!
+ * Unit tests for NetStream binary blob encoding
+ * @author jcleland
+ */
+class StreamBlob : public CxxTest::TestSuite {
+public:
+	/*!	@brief Test zero-copy decode of a blob between other values */
+	void test_fifo_blob(void) {
+		NetStream stream(NetStream::Order::FIFO);
+		const char data[] = { 0x00, 0x01, 0x7f, (char)0x80, (char)0xff, 0x00 };
+		const char* buf = nullptr;
+		size_t bytes = 0;
+		u_int32_t before = 0, after = 0;
+
+		try {
+			stream << (u_int32_t)1;
+			stream.write(data, sizeof(data));
+			stream << (u_int32_t)2;
+
+			stream >> before;
+			stream.read(buf, bytes);
+			stream >> after;
+			TS_ASSERT(before == 1 && after == 2);
+			TS_ASSERT(bytes == sizeof(data));
+			TS_ASSERT(memcmp(buf, data, sizeof(data)) == 0);
+
+			//Blob points into the stream's own storage
+			TS_ASSERT(buf > stream.data().data());
+			TS_ASSERT(buf < stream.data().data() + stream.size());
+		}
+		catch(const StreamException &se) {
+			TS_FAIL(se.what());
+		}
+	}
+
+	/*!	@brief Test copying decode of a blob from a LIFO stream */
+	void test_lifo_blob(void) {
+		NetStream stream;
+		std::vector<char> data(4 * 1024 * 1024);
+		std::vector<char> out;
+		u_int16_t value = 0;
+
+		for(size_t i = 0; i < data.size(); i++)
+			data[i] = (char)(i * 31);
+
+		try {
+			stream << (u_int16_t)77;
+			stream.write(data.data(), data.size());
+			stream.read(out);
+			stream >> value;
+			TS_ASSERT(out == data);
+			TS_ASSERT(value == 77);
+			TS_ASSERT(stream.size() == 0);
+		}
+		catch(const StreamException &se) {
+			TS_FAIL(se.what());
+		}
+	}
+
+	/*!	@brief Test a LIFO stream refuses to hand out a pointer to released data */
+	void test_lifo_view_rejected(void) {
+		NetStream stream;
+		const char* buf = nullptr;
+		size_t bytes = 0;
+
+		stream.write("abc", 3);
+		TS_ASSERT_THROWS(stream.read(buf, bytes), const StreamException&);
+	}
+
+	/*!	@brief Test a borrowed blob is not copied until the stream is flattened */
+	void test_borrowed_blob(void) {
+		const size_t orders = 2;
+		NetStream::Order order[orders] = { NetStream::Order::FIFO, NetStream::Order::LIFO };
+		std::vector<char> data(NetStream::MIN_BORROWED_BYTES * 4);
+		std::vector<char> out;
+		u_int32_t before = 0, after = 0;
+
+		for(size_t i = 0; i < data.size(); i++)
+			data[i] = (char)(i * 7);
+
+		for(size_t i = 0; i < orders; i++) {
+			NetStream stream(order[i]), copied(order[i]);
+			try {
+				stream << (u_int32_t)1;
+				stream.writeRef(data.data(), data.size());
+				stream << (u_int32_t)2;
+				copied << (u_int32_t)1;
+				copied.write(data.data(), data.size());
+				copied << (u_int32_t)2;
+
+				//Only the markers and length are held by the stream
+				TS_ASSERT(stream.segments().size() == 1);
+				TS_ASSERT(stream.segments()[0].data == data.data());
+				TS_ASSERT(stream.totalSize() == copied.size());
+				TS_ASSERT(stream.size() == copied.size() - data.size());
+				TS_ASSERT_THROWS(stream >> after, const StreamException&);
+				TS_ASSERT_THROWS(stream.seek(0), const StreamException&);
+
+				//Flattened stream matches one written by copying
+				stream.flatten();
+				TS_ASSERT(stream.segments().empty());
+				TS_ASSERT(stream.data() == copied.data());
+
+				if(order[i] == NetStream::Order::FIFO)
+					stream >> before;
+				else
+					stream >> after;
+				stream.read(out);
+				TS_ASSERT(out == data);
+			}
+			catch(const StreamException &se) {
+				TS_FAIL(se.what());
+			}
+		}
+	}
+
+	/*!	@brief Test short payloads are copied and borrowed strings embed intact */
+	void test_borrowed_small(void) {
+		NetStream stream(NetStream::Order::FIFO), outer(NetStream::Order::FIFO), inner(NetStream::Order::FIFO);
+		const std::string small("short string");
+		const std::string large(NetStream::MIN_BORROWED_BYTES, 'z');
+		std::string str;
+
+		try {
+			stream.stringRef(small);
+			TS_ASSERT(stream.segments().empty());
+			stream >> str;
+			TS_ASSERT(str == small);
+
+			//Embedding copies the borrowed payload into the outer stream
+			stream.stringRef(large);
+			TS_ASSERT(stream.segments().size() == 1);
+			outer << stream;
+			TS_ASSERT(outer.segments().empty());
+			outer >> inner;
+			inner >> str;
+			TS_ASSERT(str == large);
+		}
+		catch(const StreamException &se) {
+			TS_FAIL(se.what());
+		}
+	}
+};
+
+#endif //Include once
@@ -0,0 +1,264 @@
+/**
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//Include once
+#ifndef STREAMCOLUMNS_H_INCLUDED
+#define STREAMCOLUMNS_H_INCLUDED
+
+//CxxTest includes
+#include <cxxtest/TestSuite.h>
+
+//Standard library includes
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstring>
+
+//Include library headers
+#include "NetStream.h"
+#include "NetStreamView.h"
+#include "ColumnBatch.h"
+#include "StreamException.h"
+
+//Include shared test config header
+#include "TestCommon.h"
+
+//Using Inet namespace
+using namespace Inet;
+
+/*!	@brief Sample record type for column batch tests */
+struct Trade {
+	enum class Side : u_char { BUY = 'b', SELL = 's' };
+
+	u_int64_t		id;
+	int32_t			price;
+	double			size;
+	Side				side;
+	bool				final;
+};
+
+typedef Field<&Trade::id>			TradeId_t;
+typedef Field<&Trade::price>	TradePrice_t;
+typedef Field<&Trade::size>		TradeSize_t;
+typedef Field<&Trade::side>		TradeSide_t;
+typedef Field<&Trade::final>	TradeFinal_t;
+
+typedef ColumnBatch<Trade,
+	TradeId_t, TradePrice_t, TradeSize_t, TradeSide_t, TradeFinal_t
+> TradeBatch_t;
+
+/*!
+ * Unit tests for columnar record batches
+ * @author jcleland
+ */
+class StreamColumns : public CxxTest::TestSuite {
+public:
+	/*!	@brief Round-trip batches in both orders, fixed-width and compact */
+	void test_roundtrip(void) {
+		const std::vector<Trade> in = sample(1000);
+
+		for(NetStream::Order order : { NetStream::Order::LIFO, NetStream::Order::FIFO }) {
+			for(bool compact : { false, true }) {
+				NetStream stream(order);
+				std::vector<Trade> out;
+				u_int16_t before = 0, after = 0;
+
+				try {
+					stream.setCompact(compact);
+					stream << (u_int16_t)1;
+					TradeBatch_t::encode(stream, in);
+					stream << (u_int16_t)2;
+
+					if(order == NetStream::Order::FIFO) {
+						stream >> before;
+						TradeBatch_t::decode(stream, out);
+						stream >> after;
+					}
+					else {
+						stream >> after;
+						TradeBatch_t::decode(stream, out);
+						stream >> before;
+					}
+					TS_ASSERT(before == 1 && after == 2);
+					TS_ASSERT(equal(in, out));
+					TS_ASSERT(stream.remaining() == 0);
+				}
+				catch(const StreamException &se) {
+					TS_FAIL(se.what());
+				}
+			}
+		}
+	}
+
+	/*!	@brief Test columns are written one after another as arrays */
+	void test_wire_layout(void) {
+		NetStream stream(NetStream::Order::FIFO);
+		NetStreamView batch(nullptr, 0, NetStream::Order::FIFO);
+		std::vector<int32_t> prices;
+		u_int32_t rows;
+
+		TradeBatch_t::encode(stream, sample(3));
+		TS_ASSERT(stream.peek() == NetStream::Type::STREAM);
+
+		NetStreamView view(stream);
+		view >> batch;
+		batch >> rows;
+		TS_ASSERT(rows == 3);
+		TS_ASSERT(batch.peek() == NetStream::Type::ARRAY);
+		batch.skip();
+		batch >> prices;
+		TS_ASSERT(prices.size() == 3 && prices[2] == sample(3)[2].price);
+		batch.skip().skip().skip();
+		TS_ASSERT(batch.remaining() == 0);
+	}
+
+	/*!	@brief Test compact batches pack integer columns as varints */
+	void test_compact_size(void) {
+		const std::vector<Trade> in = sample(1000);
+		NetStream fixed(NetStream::Order::FIFO), compact(NetStream::Order::FIFO);
+
+		compact.setCompact(true);
+		TradeBatch_t::encode(fixed, in);
+		TradeBatch_t::encode(compact, in);
+		TS_ASSERT(compact.size() < fixed.size());
+	}
+
+	/*!	@brief Test decoding only some columns leaves the others untouched */
+	void test_selected_columns(void) {
+		const std::vector<Trade> in = sample(100);
+		NetStream stream(NetStream::Order::FIFO);
+		std::vector<Trade> out(in.size());
+		std::string trailer;
+
+		memset(out.data(), 0, out.size() * sizeof(Trade));
+		stream << (u_int32_t)in.size();
+		TradeBatch_t::encode(stream, in);
+		stream << std::string("end");
+
+		try {
+			stream.skip();
+			TradeBatch_t::decodeColumns<TradeSize_t, TradePrice_t>(stream, out);
+			for(size_t i = 0; i < in.size(); i++) {
+				TS_ASSERT(out[i].price == in[i].price && out[i].size == in[i].size);
+				TS_ASSERT(out[i].id == 0);
+			}
+			stream >> trailer;
+			TS_ASSERT(trailer == "end");
+		}
+		catch(const StreamException &se) {
+			TS_FAIL(se.what());
+		}
+	}
+
+	/*!	@brief Test a single column is read straight into a vector */
+	void test_single_column(void) {
+		const std::vector<Trade> in = sample(50);
+		NetStream stream(NetStream::Order::LIFO);
+		std::vector<Trade::Side> sides;
+		std::vector<u_int64_t> ids;
+
+		stream.setCompact(true);
+		TradeBatch_t::encode(stream, in);
+
+		//Reading from a view leaves the stream untouched
+		NetStreamView view(stream);
+		TradeBatch_t::column<TradeId_t>(view, ids);
+		TS_ASSERT(view.remaining() == 0);
+
+		TradeBatch_t::column<TradeSide_t>(stream, sides);
+		TS_ASSERT(stream.remaining() == 0);
+		TS_ASSERT(ids.size() == in.size() && sides.size() == in.size());
+		for(size_t i = 0; i < in.size(); i++)
+			TS_ASSERT(ids[i] == in[i].id && sides[i] == in[i].side);
+	}
+
+	/*!	@brief Test malformed batches are reported without consuming data */
+	void test_malformed(void) {
+		NetStream stream(NetStream::Order::FIFO), inner(NetStream::Order::FIFO);
+		const std::vector<Trade> in = sample(3);
+		std::vector<Trade> out = in;
+
+		//Row count disagrees with a later column, after the first has been read
+		inner << (u_int32_t)1 << std::vector<u_int64_t>{ 1 } << std::vector<int32_t>{ 1, 2 } <<
+			std::vector<double>{ 1 } << std::vector<u_char>{ 'b' } << std::vector<u_char>{ 0 };
+		stream << inner;
+		TS_ASSERT_THROWS(TradeBatch_t::decode(stream, out), const StreamException&);
+		TS_ASSERT(stream.offset() == 0);
+		TS_ASSERT(equal(in, out));
+
+		//Row count larger than the batch could hold is rejected before allocating
+		NetStream huge(NetStream::Order::FIFO), rows(NetStream::Order::FIFO);
+		rows << (u_int32_t)UINT32_MAX << std::vector<u_int64_t>{ 1 };
+		huge << rows;
+		TS_ASSERT_THROWS(TradeBatch_t::decode(huge, out), const StreamException&);
+		TS_ASSERT(equal(in, out) && huge.offset() == 0);
+
+		//Each column needs a byte per row, so one column's worth is not enough
+		NetStream narrow(NetStream::Order::FIFO), few(NetStream::Order::FIFO);
+		few << (u_int32_t)64 << std::string(64, 'x');
+		narrow << few;
+		TS_ASSERT_THROWS(TradeBatch_t::decode(narrow, out), const StreamException&);
+		TS_ASSERT(equal(in, out) && narrow.offset() == 0);
+	}
+
+	/*!	@brief Test selected columns keep the other fields of existing records */
+	void test_selected_grow(void) {
+		const std::vector<Trade> in = sample(4);
+		NetStream stream(NetStream::Order::FIFO);
+		std::vector<Trade> out = sample(2);
+
+		for(Trade& trade : out)
+			trade.id += 1000;
+		TradeBatch_t::encode(stream, in);
+		TradeBatch_t::decodeColumns<TradePrice_t>(stream, out);
+		TS_ASSERT(out.size() == in.size());
+		TS_ASSERT(out[0].id == in[0].id + 1000 && out[1].id == in[1].id + 1000);
+		TS_ASSERT(out[3].id == 0);
+		for(size_t i = 0; i < in.size(); i++)
+			TS_ASSERT(out[i].price == in[i].price);
+	}
+
+private:
+	/*!	@brief Build a set of trades with predictable field values */
+	static std::vector<Trade> sample(size_t count) {
+		std::vector<Trade> trades(count);
+		for(size_t i = 0; i < count; i++) {
+			trades[i].id = 1000000 + i;
+			trades[i].price = (int32_t)(10000 - 7 * i);
+			trades[i].size = 0.25 * i;
+			trades[i].side = (i % 3) ? Trade::Side::BUY : Trade::Side::SELL;
+			trades[i].final = (i % 2) == 0;
+		}
+		return trades;
+	}
+
+	/*!	@brief Compare trade sets field by field */
+	static bool equal(const std::vector<Trade>& a, const std::vector<Trade>& b) {
+		if(a.size() != b.size())
+			return false;
+		for(size_t i = 0; i < a.size(); i++) {
+			if(a[i].id != b[i].id || a[i].price != b[i].price || a[i].size != b[i].size ||
+				a[i].side != b[i].side || a[i].final != b[i].final)
+				return false;
+		}
+		return true;
+	}
+};
+
+#endif //Include once
@@ -0,0 +1,183 @@
+/**
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//Include once
+#ifndef STREAMCOMPACT_H_INCLUDED
+#define STREAMCOMPACT_H_INCLUDED
+
+//CxxTest includes
+#include <cxxtest/TestSuite.h>
+
+//Standard library includes
+#include <string>
+#include <vector>
+#include <memory>
+#include <limits>
+
+//Include library headers
+#include "NetStream.h"
+#include "StreamException.h"
+
+//Include shared test config header
+#include "TestCommon.h"
+
+//Using Inet namespace
+using namespace Inet;
+
+/*!
+ * Unit tests for NetStream compact (varint) integer encoding
+ * @author jcleland
+ */
+class StreamCompact : public CxxTest::TestSuite {
+public:
+	/*!	@brief Round-trip values around each varint length boundary */
+	void test_unsigned(void) {
+		const u_int64_t values[] = {
+			0, 1, 127, 128, 16383, 16384, 0xffffffffULL,
+			0x00ffffffffffffffULL, 0x0100000000000000ULL,
+			std::numeric_limits<u_int64_t>::max()
+		};
+
+		for(u_int64_t value : values) {
+			roundtrip<u_int64_t>(value);
+			if(value <= 0xffffffffULL) roundtrip<u_int32_t>((u_int32_t)value);
+			if(value <= 0xffffULL) roundtrip<u_int16_t>((u_int16_t)value);
+		}
+	}
+
+	/*!	@brief Round-trip signed values including the type limits */
+	void test_signed(void) {
+		const int64_t values[] = {
+			0, -1, 1, -64, 64, -8193, 8192,
+			std::numeric_limits<int32_t>::min(),
+			std::numeric_limits<int64_t>::min(),
+			std::numeric_limits<int64_t>::max()
+		};
+
+		for(int64_t value : values) {
+			roundtrip<int64_t>(value);
+			if(value >= INT32_MIN && value <= INT32_MAX) roundtrip<int32_t>((int32_t)value);
+			if(value >= INT16_MIN && value <= INT16_MAX) roundtrip<int16_t>((int16_t)value);
+		}
+	}
+
+	/*!	@brief Test small values encode in fewer bytes than fixed-width */
+	void test_size(void) {
+		NetStream stream;
+		stream.setCompact(true);
+
+		stream << (u_int64_t)5;
+		TS_ASSERT(stream.size() == 3);
+		stream << (u_int32_t)16000;
+		TS_ASSERT(stream.size() == 7);
+		stream << (int16_t)-3;
+		TS_ASSERT(stream.size() == 10);
+	}
+
+	/*!	@brief Test compact and fixed-width values mixed in one stream */
+	void test_mixed(void) {
+		NetStream stream(NetStream::Order::FIFO);
+		u_int32_t a = 0, b = 0;
+		int64_t c = 0;
+		std::string str;
+
+		try {
+			stream << (u_int32_t)1000;
+			stream.setCompact(true);
+			stream << (u_int32_t)2000 << std::string("between") << (int64_t)-3000;
+			stream.setCompact(false);
+
+			stream >> a >> b >> str >> c;
+			TS_ASSERT(a == 1000 && b == 2000 && c == -3000);
+			TS_ASSERT(str == "between");
+			TS_ASSERT(stream.remaining() == 0);
+		}
+		catch(const StreamException &se) {
+			TS_FAIL(se.what());
+		}
+	}
+
+	/*!	@brief Test values too large for the destination are rejected */
+	void test_range(void) {
+		NetStream stream;
+		u_int16_t narrow = 0;
+		int16_t snarrow = 0;
+		u_int32_t wide = 0;
+
+		stream.setCompact(true);
+		stream << (u_int32_t)70000;
+		TS_ASSERT_THROWS(stream >> narrow, const StreamException&);
+		stream >> wide;
+		TS_ASSERT(wide == 70000);
+
+		stream << (int32_t)-40000;
+		TS_ASSERT_THROWS(stream >> snarrow, const StreamException&);
+	}
+
+	/*!	@brief Test a tenth varint byte carrying bits past 64 is rejected */
+	void test_overflow(void) {
+		NetStream scalar(NetStream::Order::FIFO), array(NetStream::Order::FIFO);
+		u_int64_t val = 0;
+		std::vector<u_int64_t> vals;
+
+		scalar.setCompact(true);
+		scalar << (u_int64_t)UINT64_MAX;
+		array.setCompact(true);
+		array << std::vector<u_int64_t>{ UINT64_MAX };
+
+		//The last varint byte sits just ahead of the closing marker
+		for(NetStream* stream : { &scalar, &array }) {
+			std::vector<char> bytes(stream->data().begin(), stream->data().end());
+			TS_ASSERT(bytes[bytes.size() - 2] == 0x01);
+			bytes[bytes.size() - 2] = 0x02;
+			NetStream bad(bytes.data(), bytes.size(), NetStream::Order::FIFO);
+			if(stream == &scalar)
+				TS_ASSERT_THROWS(bad >> val, const StreamException&);
+			else
+				TS_ASSERT_THROWS(bad >> vals, const StreamException&);
+			TS_ASSERT(bad.offset() == 0);
+		}
+
+		scalar >> val;
+		TS_ASSERT(val == UINT64_MAX);
+	}
+
+private:
+	/*!	@brief Encode a run of values and decode them in both orders */
+	template<typename T>
+	void roundtrip(T value) {
+		for(NetStream::Order order : { NetStream::Order::LIFO, NetStream::Order::FIFO }) {
+			NetStream stream(order);
+			std::vector<T> out(3);
+
+			try {
+				stream.setCompact(true);
+				stream << value << (T)1 << value;
+				stream >> out[0] >> out[1] >> out[2];
+				TS_ASSERT(out[0] == value && out[1] == 1 && out[2] == value);
+				TS_ASSERT(stream.remaining() == 0);
+			}
+			catch(const StreamException &se) {
+				TS_FAIL(se.what());
+			}
+		}
+	}
+};
+
+#endif //Include once
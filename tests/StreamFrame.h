@@ -0,0 +1,206 @@
+/**
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//Include once
+#ifndef STREAMFRAME_H_INCLUDED
+#define STREAMFRAME_H_INCLUDED
+
+//CxxTest includes
+#include <cxxtest/TestSuite.h>
+
+//System includes
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+
+//Standard library includes
+#include <string>
+#include <memory>
+#include <cstring>
+
+//Include library headers
+#include "ConnectionEndpoint.h"
+#include "NetStream.h"
+#include "StreamException.h"
+#include "SocketException.h"
+
+//Include shared test config header
+#include "TestCommon.h"
+
+//Using Inet namespace
+using namespace Inet;
+
+/*!
+ * Unit tests for sending NetStream frames over a ConnectionEndpoint
+ * @author jcleland
+ */
+class StreamFrame : public CxxTest::TestSuite {
+public:
+	/*!	@brief Create a connected pair of endpoints */
+	void setUp() {
+		MakePair(left_, right_);
+	}
+
+	/*!	@brief Close the endpoints */
+	void tearDown() {
+		left_.reset();
+		right_.reset();
+	}
+
+	/*!	@brief Test a stream arrives as one frame with its values intact */
+	void test_round_trip(void) {
+		NetStream out(NetStream::Order::FIFO), in(NetStream::Order::FIFO);
+		u_int32_t val = 0;
+		std::string str;
+
+		try {
+			out << (u_int32_t)42 << std::string("framed");
+			TS_ASSERT(left_->sendStream(out) == (int)out.size());
+			TS_ASSERT(right_->receiveStream(in) && in.size() == out.size());
+
+			in >> val >> str;
+			TS_ASSERT(val == 42 && str == "framed");
+			TS_ASSERT(out.remaining() == out.size());
+		}
+		catch(const std::exception &e) {
+			TS_FAIL(e.what());
+		}
+	}
+
+	/*!	@brief Test back to back frames and a partly read FIFO stream */
+	void test_sequence(void) {
+		NetStream out(NetStream::Order::FIFO), in(NetStream::Order::FIFO);
+		const std::string big(64 * 1024, 'f');
+		u_int16_t skipped = 0;
+		std::string str;
+
+		try {
+			//Only the unread part of a FIFO stream is framed
+			out << (u_int16_t)1 << big;
+			out >> skipped;
+			left_->sendStream(out);
+			left_->sendStream(NetStream());
+
+			right_->receiveStream(in);
+			in >> str;
+			TS_ASSERT(str == big && in.remaining() == 0);
+
+			TS_ASSERT(right_->receiveStream(in));
+			TS_ASSERT(in.size() == 0);
+		}
+		catch(const std::exception &e) {
+			TS_FAIL(e.what());
+		}
+	}
+
+	/*!	@brief Test the maximum frame size is applied in both directions */
+	void test_max_frame(void) {
+		NetStream out, in;
+		out.write(std::string(1024, 'x').data(), 1024);
+
+		left_->setMaxFrameSize(512);
+		TS_ASSERT_THROWS(left_->sendStream(out), SocketException);
+
+		left_->setMaxFrameSize(DEFAULT_MAX_FRAME_SIZE);
+		right_->setMaxFrameSize(512);
+		left_->sendStream(out);
+		TS_ASSERT_THROWS(right_->receiveStream(in), SocketException);
+	}
+
+	/*!	@brief Test a close between frames is reported without an exception */
+	void test_clean_close(void) {
+		NetStream out(NetStream::Order::FIFO), in(NetStream::Order::FIFO);
+
+		try {
+			out << std::string("last");
+			left_->sendStream(out);
+			left_->close();
+
+			TS_ASSERT(right_->receiveStream(in) && in.size() == out.size());
+			TS_ASSERT(!right_->receiveStream(in));
+			TS_ASSERT(in.size() == 0);
+		}
+		catch(const std::exception &e) {
+			TS_FAIL(e.what());
+		}
+	}
+
+	/*!	@brief Test a frame cut short throws and leaves the stream empty */
+	void test_truncated(void) {
+		NetStream in(NetStream::Order::FIFO);
+		const u_int32_t length = htonl(16);
+
+		in << std::string("stale");
+		TS_ASSERT(::write(left_->handle(), &length, sizeof(length)) == sizeof(length));
+		TS_ASSERT(::write(left_->handle(), "part", 4) == 4);
+		left_->close();
+
+		TS_ASSERT_THROWS(right_->receiveStream(in), SocketException);
+		TS_ASSERT(in.size() == 0 && in.remaining() == 0);
+	}
+
+	/*!	@brief Test sending to a closed peer throws instead of raising SIGPIPE */
+	void test_closed_peer(void) {
+		NetStream out(NetStream::Order::FIFO);
+
+		out << std::string("unheard");
+		right_->close();
+		TS_ASSERT_THROWS(left_->sendStream(out), SocketException);
+	}
+
+	/*!	@brief Test borrowed payloads are gathered into the frame in order */
+	void test_borrowed(void) {
+		NetStream out(NetStream::Order::FIFO), in(NetStream::Order::FIFO);
+		const std::string first(NetStream::MIN_BORROWED_BYTES * 2, 'a');
+		const std::string second(NetStream::MIN_BORROWED_BYTES, 'b');
+		const char* buf = nullptr;
+		size_t bytes = 0;
+		u_int32_t val = 0;
+		std::string str;
+
+		try {
+			out << (u_int32_t)7;
+			out.writeRef(first.data(), first.length());
+			out.stringRef(second);
+			out << std::string("tail");
+			TS_ASSERT(out.segments().size() == 2);
+			TS_ASSERT(left_->sendStream(out) == (int)out.totalSize());
+			TS_ASSERT(right_->receiveStream(in) && in.size() == out.totalSize());
+
+			in >> val;
+			in.read(buf, bytes);
+			TS_ASSERT(val == 7 && bytes == first.length());
+			TS_ASSERT(memcmp(buf, first.data(), bytes) == 0);
+			in >> str;
+			TS_ASSERT(str == second);
+			in >> str;
+			TS_ASSERT(str == "tail" && in.remaining() == 0);
+		}
+		catch(const std::exception &e) {
+			TS_FAIL(e.what());
+		}
+	}
+
+private:
+	std::unique_ptr<PairEndpoint>		left_;
+	std::unique_ptr<PairEndpoint>		right_;
+};
+
+#endif //STREAMFRAME_H_INCLUDED
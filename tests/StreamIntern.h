@@ -0,0 +1,183 @@
+/**
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//Include once
+#ifndef STREAMINTERN_H_INCLUDED
+#define STREAMINTERN_H_INCLUDED
+
+//CxxTest includes
+#include <cxxtest/TestSuite.h>
+
+//Standard library includes
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <cstring>
+
+//Include library headers
+#include "NetStream.h"
+#include "NetStreamView.h"
+#include "StringDictionary.h"
+#include "StreamException.h"
+
+//Include shared test config header
+#include "TestCommon.h"
+
+//Using Inet namespace
+using namespace Inet;
+
+/*!
+ * Unit tests for NetStream interned strings
+ * @author jcleland
+ */
+class StreamIntern : public CxxTest::TestSuite {
+public:
+	/*!	@brief Round-trip repeated strings mixed with other values */
+	void test_roundtrip(void) {
+		NetStream stream(NetStream::Order::FIFO);
+		const std::vector<std::string> symbols = { "INET", "", "SOCK", "INET", "SOCK", "INET" };
+		std::string val;
+		u_int32_t n;
+
+		try {
+			stream.setInterning(true);
+			for(size_t i = 0; i < symbols.size(); i++)
+				stream << symbols[i] << (u_int32_t)i;
+
+			for(size_t i = 0; i < symbols.size(); i++) {
+				stream >> val >> n;
+				TS_ASSERT(val == symbols[i] && n == i);
+			}
+			TS_ASSERT(stream.remaining() == 0);
+		}
+		catch(const StreamException &se) {
+			TS_FAIL(se.what());
+		}
+	}
+
+	/*!	@brief Test repeats are written as a small index */
+	void test_layout(void) {
+		NetStream stream(NetStream::Order::FIFO);
+		const char expected[] = {
+			'n', 0x00, 0x00, 0x00, 0x05, 0x00, 'I', 'N', 'E', 'T', 'n',
+			'n', 0x00, 0x00, 0x00, 0x05, 0x01, 'S', 'O', 'C', 'K', 'n',
+			'N', 0x00, 'N',
+			'N', 0x01, 'N'
+		};
+
+		stream.setInterning(true);
+		stream << std::string("INET") << std::string("SOCK")
+			<< std::string("INET") << std::string("SOCK");
+		TS_ASSERT(stream.size() == sizeof(expected));
+		TS_ASSERT(memcmp(stream.data().data(), expected, sizeof(expected)) == 0);
+	}
+
+	/*!	@brief Test a receiving stream decodes without interning enabled */
+	void test_receive(void) {
+		NetStream out(NetStream::Order::FIFO);
+		std::string_view first, second;
+		std::string skipped, val;
+
+		out.setInterning(true);
+		out << std::string("skipped") << std::string("INET") << std::string("INET")
+			<< std::string("skipped");
+
+		NetStream in(out.data().data(), out.size(), NetStream::Order::FIFO);
+		try {
+			//Skipped definitions are still recorded for later references
+			in.skip();
+			in >> first >> second >> val;
+			TS_ASSERT(first == "INET" && second == "INET");
+			TS_ASSERT(val == "skipped");
+
+			//Repeats are views of the same dictionary entry
+			TS_ASSERT(first.data() == second.data());
+		}
+		catch(const StreamException &se) {
+			TS_FAIL(se.what());
+		}
+	}
+
+	/*!	@brief Test a view of raw memory decodes with a caller's dictionary */
+	void test_view(void) {
+		NetStream out(NetStream::Order::FIFO);
+		StringDictionary dictionary;
+		std::string_view a, b;
+
+		out.setInterning(true);
+		out << std::string("INET") << std::string("INET");
+
+		NetStreamView view(out.data().data(), out.size(), NetStream::Order::FIFO);
+		TS_ASSERT_THROWS(view >> a, const StreamException&);
+
+		view.setDictionary(&dictionary);
+		view >> a >> b;
+		TS_ASSERT(a == "INET" && b == "INET" && dictionary.size() == 1);
+	}
+
+	/*!	@brief Test replacing the contents starts a fresh dictionary */
+	void test_reset(void) {
+		NetStream stream(NetStream::Order::FIFO);
+		std::string val;
+
+		stream.setInterning(true);
+		stream << std::string("INET");
+		stream.prepareRaw(0);
+		stream << std::string("SOCK");
+		stream >> val;
+		TS_ASSERT(val == "SOCK");
+	}
+
+	/*!	@brief Test a moved-from stream writes strings in full */
+	void test_move(void) {
+		NetStream stream(NetStream::Order::FIFO);
+		std::string val;
+
+		stream.setInterning(true);
+		stream << std::string("INET");
+		NetStream moved(std::move(stream));
+		TS_ASSERT(moved.interning() && !stream.interning());
+
+		NetStream assigned(NetStream::Order::FIFO);
+		assigned = std::move(moved);
+		TS_ASSERT(assigned.interning() && !moved.interning());
+
+		moved << std::string("SOCK");
+		moved >> val;
+		TS_ASSERT(val == "SOCK");
+	}
+
+	/*!	@brief Test unresolved references and LIFO streams are rejected */
+	void test_errors(void) {
+		NetStream lifo, out(NetStream::Order::FIFO);
+		std::string val;
+
+		TS_ASSERT_THROWS(lifo.setInterning(true), const StreamException&);
+
+		//Reference without its definition
+		out.setInterning(true);
+		out << std::string("INET") << std::string("INET");
+		NetStream in(out.data().data() + 11, out.size() - 11, NetStream::Order::FIFO);
+		TS_ASSERT_THROWS(in >> val, const StreamException&);
+		TS_ASSERT(in.offset() == 0);
+	}
+};
+
+#endif //Include once
@@ -0,0 +1,145 @@
+/**
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//Include once
+#ifndef STREAMNESTED_H_INCLUDED
+#define STREAMNESTED_H_INCLUDED
+
+//CxxTest includes
+#include <cxxtest/TestSuite.h>
+
+//Standard library includes
+#include <string>
+#include <vector>
+#include <memory>
+
+//Include library headers
+#include "NetStream.h"
+#include "StreamException.h"
+
+//Include shared test config header
+#include "TestCommon.h"
+
+//Using Inet namespace
+using namespace Inet;
+
+/*!
+ * Unit tests for nested NetStream sub-streams and value skipping
+ * @author jcleland
+ */
+class StreamNested : public CxxTest::TestSuite {
+public:
+	/*!	@brief Test a sub-stream decodes into its own stream */
+	void test_substream(void) {
+		for(NetStream::Order order : { NetStream::Order::LIFO, NetStream::Order::FIFO }) {
+			NetStream body(order), message(order), out(order);
+			std::string str;
+			u_int32_t header = 0, value = 0;
+
+			try {
+				body << (u_int32_t)42 << std::string("payload");
+				message << (u_int32_t)7 << body;
+				TS_ASSERT(body.remaining() == body.size());
+
+				if(order == NetStream::Order::FIFO) {
+					message >> header >> out;
+					out >> value >> str;
+				}
+				else {
+					message >> out >> header;
+					out >> str >> value;
+				}
+				TS_ASSERT(header == 7 && value == 42);
+				TS_ASSERT(str == "payload");
+			}
+			catch(const StreamException &se) {
+				TS_FAIL(se.what());
+			}
+		}
+	}
+
+	/*!	@brief Test a router reading the header and forwarding the body */
+	void test_zero_copy(void) {
+		NetStream body(NetStream::Order::FIFO), message(NetStream::Order::FIFO);
+		const char* buf = nullptr;
+		size_t bytes = 0;
+		u_int16_t route = 0;
+		std::string str;
+
+		try {
+			body << std::string("forwarded");
+			message << (u_int16_t)3 << body;
+
+			message >> route;
+			message.readStream(buf, bytes);
+			TS_ASSERT(route == 3);
+			TS_ASSERT(bytes == body.size());
+
+			NetStream forwarded(buf, bytes, NetStream::Order::FIFO);
+			forwarded >> str;
+			TS_ASSERT(str == "forwarded");
+		}
+		catch(const StreamException &se) {
+			TS_FAIL(se.what());
+		}
+	}
+
+	/*!	@brief Test skipping over values of each kind */
+	void test_skip(void) {
+		for(NetStream::Order order : { NetStream::Order::LIFO, NetStream::Order::FIFO }) {
+			NetStream stream(order), body(order);
+			std::vector<int32_t> array = { 1, 2, 3 };
+			u_int64_t marker = 0;
+
+			try {
+				body << std::string(1000, 'x');
+				stream << (u_int64_t)1 << 'c' << (int16_t)2 << std::string("s") << array
+					<< body << (u_int64_t)9;
+				stream.setCompact(true);
+				stream << (int32_t)-1;
+				stream.write("blob", 4);
+
+				if(order == NetStream::Order::FIFO) {
+					stream >> marker;
+					TS_ASSERT(marker == 1);
+					for(int i = 0; i < 5; i++)
+						stream.skip();
+					stream >> marker;
+					TS_ASSERT(marker == 9);
+					stream.skip().skip();
+				}
+				else {
+					stream.skip().skip();
+					stream >> marker;
+					TS_ASSERT(marker == 9);
+					for(int i = 0; i < 5; i++)
+						stream.skip();
+					stream >> marker;
+					TS_ASSERT(marker == 1);
+				}
+				TS_ASSERT(stream.remaining() == 0);
+			}
+			catch(const StreamException &se) {
+				TS_FAIL(se.what());
+			}
+		}
+	}
+};
+
+#endif //Include once
@@ -0,0 +1,162 @@
+/**
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//Include once
+#ifndef STREAMPARSER_H_INCLUDED
+#define STREAMPARSER_H_INCLUDED
+
+//CxxTest includes
+#include <cxxtest/TestSuite.h>
+
+//System includes
+#include <netinet/in.h>
+
+//Standard library includes
+#include <string>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+
+//Include library headers
+#include "FrameParser.h"
+#include "NetStream.h"
+#include "NetStreamView.h"
+#include "StreamException.h"
+
+//Include shared test config header
+#include "TestCommon.h"
+
+//Using Inet namespace
+using namespace Inet;
+
+/*!
+ * Unit tests for incremental frame parsing
+ * @author jcleland
+ */
+class StreamParser : public CxxTest::TestSuite {
+public:
+	/*!	@brief Append a frame holding a single string to the wire buffer */
+	static void frame(std::vector<char>& wire, const std::string& str) {
+		NetStream stream(NetStream::Order::FIFO);
+		stream << str;
+
+		const u_int32_t length = htonl(stream.size());
+		wire.insert(wire.end(), (const char*)&length, (const char*)&length + sizeof(length));
+		wire.insert(wire.end(), stream.data().begin(), stream.data().end());
+	}
+
+	/*!	@brief Test whole frames are returned in place without copying */
+	void test_whole_frames(void) {
+		FrameParser parser(NetStream::Order::FIFO);
+		std::vector<char> wire;
+		NetStreamView view(nullptr, 0);
+		std::string str;
+
+		try {
+			frame(wire, "one");
+			frame(wire, "two");
+			parser.feed(wire.data(), wire.size());
+
+			TS_ASSERT(parser.next(view));
+			TS_ASSERT(view.data() >= wire.data() && view.data() < wire.data() + wire.size());
+			view >> str;
+			TS_ASSERT(str == "one");
+
+			TS_ASSERT(parser.next(view));
+			view >> str;
+			TS_ASSERT(str == "two");
+
+			TS_ASSERT(!parser.next(view));
+			TS_ASSERT(parser.buffered() == 0);
+		}
+		catch(const StreamException &se) {
+			TS_FAIL(se.what());
+		}
+	}
+
+	/*!	@brief Test frames split at every possible boundary are reassembled */
+	void test_split(void) {
+		std::vector<char> wire;
+		std::vector<std::string> expect = { "alpha", "", std::string(300, 'z'), "omega" };
+
+		for(const std::string& str : expect)
+			frame(wire, str);
+
+		for(size_t chunk = 1; chunk <= wire.size(); chunk++) {
+			FrameParser parser(NetStream::Order::FIFO);
+			NetStreamView view(nullptr, 0);
+			std::vector<std::string> found;
+			std::string str;
+
+			try {
+				for(size_t offset = 0; offset < wire.size(); offset += chunk) {
+					const size_t bytes = std::min(chunk, wire.size() - offset);
+					std::vector<char> read(wire.begin() + offset, wire.begin() + offset + bytes);
+					parser.feed(read.data(), read.size());
+					while(parser.next(view)) {
+						view >> str;
+						found.push_back(str);
+					}
+				}
+			}
+			catch(const StreamException &se) {
+				TS_FAIL(se.what());
+			}
+			TS_ASSERT(found == expect);
+			TS_ASSERT(parser.buffered() == 0);
+		}
+	}
+
+	/*!	@brief Test input left undrained is kept when more is fed */
+	void test_undrained(void) {
+		FrameParser parser(NetStream::Order::FIFO);
+		std::vector<char> first, second;
+		NetStreamView view(nullptr, 0);
+		std::string str;
+
+		frame(first, "kept");
+		frame(first, "also kept");
+		frame(second, "last");
+
+		parser.feed(first.data(), first.size());
+		parser.feed(second.data(), second.size());
+
+		for(const char* expect : { "kept", "also kept", "last" }) {
+			TS_ASSERT(parser.next(view));
+			view >> str;
+			TS_ASSERT(str == expect);
+		}
+		TS_ASSERT(!parser.next(view));
+	}
+
+	/*!	@brief Test an oversized frame is rejected from its prefix alone */
+	void test_max_frame(void) {
+		FrameParser parser(NetStream::Order::FIFO, 16);
+		NetStreamView view(nullptr, 0);
+		const u_int32_t length = htonl(17);
+
+		parser.feed((const char*)&length, sizeof(length));
+		TS_ASSERT_THROWS(parser.next(view), StreamException);
+
+		parser.reset();
+		TS_ASSERT(parser.buffered() == 0 && !parser.next(view));
+	}
+};
+
+#endif //STREAMPARSER_H_INCLUDED
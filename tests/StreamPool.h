@@ -0,0 +1,158 @@
+/**
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//Include once
+#ifndef STREAMPOOL_H_INCLUDED
+#define STREAMPOOL_H_INCLUDED
+
+//CxxTest includes
+#include <cxxtest/TestSuite.h>
+
+//Standard library includes
+#include <string>
+#include <utility>
+#include <vector>
+
+//Include library headers
+#include "NetStream.h"
+#include "BufferPool.h"
+#include "StreamException.h"
+
+//Include shared test config header
+#include "TestCommon.h"
+
+//Using Inet namespace
+using namespace Inet;
+
+/*!
+ * Unit tests for NetStream storage taken from a BufferPool
+ * @author jcleland
+ */
+class StreamPool : public CxxTest::TestSuite {
+public:
+	/*!	@brief Test released storage is reused by the next stream */
+	void test_reuse(void) {
+		BufferPool pool(4, 4096, 128);
+		const char* storage = nullptr;
+		std::string str;
+
+		try {
+			{
+				NetStream stream(pool, NetStream::Order::FIFO);
+				stream << std::string("first message") << (u_int32_t)1;
+				storage = stream.data().data();
+			}
+			TS_ASSERT(pool.stats().pooled == 1);
+
+			NetStream stream(pool, NetStream::Order::FIFO);
+			TS_ASSERT(stream.size() == 0);
+			stream << std::string("second");
+			TS_ASSERT(stream.data().data() == storage);
+			stream >> str;
+			TS_ASSERT(str == "second");
+
+			const BufferPool::Stats stats = pool.stats();
+			TS_ASSERT(stats.acquired == 2 && stats.reused == 1);
+			TS_ASSERT(stats.released == 1 && stats.pooled == 0);
+		}
+		catch(const StreamException &se) {
+			TS_FAIL(se.what());
+		}
+	}
+
+	/*!	@brief Test flattening and raw fills keep the pooled storage */
+	void test_flatten(void) {
+		BufferPool pool(4, 64 * 1024, 32 * 1024);
+		std::vector<char> payload(NetStream::MIN_BORROWED_BYTES * 2, 'p');
+		std::vector<char> out;
+		u_int32_t before = 0, after = 0;
+
+		try {
+			NetStream stream(pool, NetStream::Order::FIFO);
+			const char* storage = stream.data().data();
+			stream << (u_int32_t)1;
+			stream.writeRef(payload.data(), payload.size());
+			stream << (u_int32_t)2;
+			stream.flatten();
+			TS_ASSERT(stream.data().data() == storage);
+
+			stream >> before;
+			stream.read(out);
+			stream >> after;
+			TS_ASSERT(before == 1 && out == payload && after == 2);
+
+			TS_ASSERT(stream.prepareRaw(1024) == storage);
+		}
+		catch(const StreamException &se) {
+			TS_FAIL(se.what());
+		}
+		TS_ASSERT(pool.stats().released == 1);
+	}
+
+	/*!	@brief Test the pool keeps a bounded number and size of buffers */
+	void test_bounds(void) {
+		BufferPool pool(2, 1024, 64);
+
+		{
+			NetStream a(pool), b(pool), c(pool), big(pool);
+			big.write(std::string(4096, 'x').data(), 4096);
+		}
+
+		const BufferPool::Stats stats = pool.stats();
+		TS_ASSERT(stats.pooled == 2);
+		TS_ASSERT(stats.released == 2 && stats.discarded == 2);
+		TS_ASSERT(stats.pooledBytes <= 2 * 1024);
+
+		pool.clear();
+		TS_ASSERT(pool.stats().pooled == 0 && pool.stats().pooledBytes == 0);
+	}
+
+	/*!	@brief Test moved streams return their storage exactly once */
+	void test_move(void) {
+		BufferPool pool(4, 4096, 64);
+		pool.prime(2);
+		TS_ASSERT(pool.stats().pooled == 2);
+
+		{
+			NetStream a(pool), b(pool);
+			TS_ASSERT(pool.stats().pooled == 0);
+
+			NetStream moved(std::move(a));
+			b = std::move(moved);
+			TS_ASSERT(pool.stats().pooled == 1);
+		}
+
+		const BufferPool::Stats stats = pool.stats();
+		TS_ASSERT(stats.pooled == 2 && stats.released == 2);
+		TS_ASSERT(stats.reused == 2);
+	}
+
+	/*!	@brief Test the calling thread's pool */
+	void test_local(void) {
+		BufferPool& pool = BufferPool::local();
+		TS_ASSERT(&pool == &BufferPool::local());
+
+		const size_t reused = pool.stats().reused;
+		{ NetStream stream(pool); stream << (u_int16_t)1; }
+		{ NetStream stream(pool); stream << (u_int16_t)2; }
+		TS_ASSERT(pool.stats().reused >= reused + 1);
+	}
+};
+
+#endif //STREAMPOOL_H_INCLUDED
@@ -28,10 +28,13 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <cstring>
+#include <limits>
 
 //Include library headers
 #include "NetStream.h"
 #include "StreamException.h"
+#include "ByteOrder.h"
 
 //Include shared test config header
 #include "TestCommon.h"
@@ -165,6 +168,160 @@ public:
 		}
 	}
 
+	/*!	@brief Test encode/decode of single and double precision floats */
+	void test_float(void) {
+		NetStream stream;
+		float f = 0.0f;
+		double d = 0.0;
+
+		try {
+			stream << 3.25f << -1.0e300;
+			stream >> d >> f;
+			TS_ASSERT(f == 3.25f);
+			TS_ASSERT(d == -1.0e300);
+		}
+		catch(const StreamException &se) {
+			TS_FAIL(se.what());
+		}
+	}
+
+	/*!	@brief Test special float values keep their exact bit patterns */
+	void test_float_special(void) {
+		NetStream stream(NetStream::Order::FIFO);
+		const double values[] = {
+			std::numeric_limits<double>::infinity(),
+			-std::numeric_limits<double>::infinity(),
+			std::numeric_limits<double>::quiet_NaN(),
+			std::numeric_limits<double>::denorm_min(),
+			-0.0
+		};
+		double d;
+
+		for(double val : values)
+			stream << val;
+
+		for(double val : values) {
+			stream >> d;
+			TS_ASSERT(memcmp(&d, &val, sizeof(double)) == 0);
+		}
+	}
+
+	/*!	@brief Test floats are written as network order IEEE-754 with their own markers */
+	void test_float_wire_layout(void) {
+		NetStream stream;
+		const char expected[] = {
+			'f', 0x3f, (char)0x80, 0x00, 0x00, 'f',
+			'd', (char)0xc0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 'd'
+		};
+		int32_t wrong;
+
+		stream << 1.0f << -2.0;
+		TS_ASSERT(stream.size() == sizeof(expected));
+		TS_ASSERT(memcmp(stream.data().data(), expected, sizeof(expected)) == 0);
+
+		//Floats are typed, not interchangeable with integers of the same width
+		TS_ASSERT_THROWS(stream >> wrong, const StreamException&);
+	}
+
+	/*!	@brief Test LIFO decode of multiple values returns them in reverse */
+	void test_lifo_order(void) {
+		NetStream stream;
+		int32_t a = 0;
+		u_int16_t b = 0;
+		char c = 0;
+
+		try {
+			stream << (int32_t)-12345 << (u_int16_t)42 << 'x';
+			stream >> c >> b >> a;
+			TS_ASSERT(a == -12345 && b == 42 && c == 'x');
+			TS_ASSERT(stream.size() == 0);
+		}
+		catch(const StreamException &se) {
+			TS_FAIL(se.what());
+		}
+	}
+
+	/*!	@brief Test FIFO decode of multiple values returns them in written order */
+	void test_fifo_order(void) {
+		NetStream stream(NetStream::Order::FIFO);
+		int32_t a = 0;
+		u_int64_t b = 0;
+		u_char c = 0;
+
+		try {
+			stream << (int32_t)-12345 << (u_int64_t)0x0102030405060708ULL << (u_char)0xfe;
+			u_int32_t encoded = stream.size();
+			stream >> a >> b >> c;
+			TS_ASSERT(a == -12345 && b == 0x0102030405060708ULL && c == 0xfe);
+
+			//Forward reads leave the buffer intact and advance the offset
+			TS_ASSERT(stream.size() == encoded);
+			TS_ASSERT(stream.offset() == encoded);
+			TS_ASSERT(stream.remaining() == 0);
+
+			//Rewind and read again
+			stream.seek(0);
+			stream >> a;
+			TS_ASSERT(a == -12345);
+		}
+		catch(const StreamException &se) {
+			TS_FAIL(se.what());
+		}
+	}
+
+	/*!	@brief Test type mismatch and short data are reported */
+	void test_decode_errors(void) {
+		NetStream stream(NetStream::Order::FIFO);
+		int16_t i = 0;
+		u_int32_t u = 0;
+
+		stream << (int16_t)7;
+		TS_ASSERT_THROWS(stream >> u, const StreamException&);
+		stream >> i;
+		TS_ASSERT_THROWS(stream >> i, const StreamException&);
+		TS_ASSERT_THROWS(stream.seek(stream.size() + 1), const StreamException&);
+
+		//LIFO streams decode from the tail and have no read offset to move
+		NetStream lifo;
+		lifo << (int16_t)7;
+		TS_ASSERT_THROWS(lifo.seek(0), const StreamException&);
+	}
+
+	/*!	@brief Test the encoded layout of fixed-width values */
+	void test_wire_layout(void) {
+		NetStream stream;
+		const char expected[] = {
+			'l', 0x01, 0x02, 0x03, 0x04, 'l',
+			'I', 0x0a, 0x0b, 'I'
+		};
+
+		stream << (int32_t)0x01020304 << (u_int16_t)0x0a0b;
+		TS_ASSERT(stream.size() == sizeof(expected));
+		TS_ASSERT(memcmp(stream.data().data(), expected, sizeof(expected)) == 0);
+	}
+
+	/*!	@brief Test 64-bit values are written most significant byte first */
+	void test_wire_layout_64(void) {
+		NetStream stream;
+		const char expected[] = {
+			'W', 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 'W',
+			'w', (char)0xff, (char)0xff, (char)0xff, (char)0xff,
+				(char)0xff, (char)0xff, (char)0xff, (char)0xfe, 'w'
+		};
+		int64_t val = 0;
+
+		//Conversion is resolved at compile time
+		static_assert(NetOrder(NetOrder((u_int64_t)0x0102030405060708ULL)) ==
+			0x0102030405060708ULL, "NetOrder must be its own inverse");
+
+		stream << (u_int64_t)0x0102030405060708ULL << (int64_t)-2;
+		TS_ASSERT(stream.size() == sizeof(expected));
+		TS_ASSERT(memcmp(stream.data().data(), expected, sizeof(expected)) == 0);
+
+		stream >> val;
+		TS_ASSERT(val == -2);
+	}
+
 };
 
 #endif //Inet namespace
@@ -0,0 +1,193 @@
+/**
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//Include once
+#ifndef STREAMSCHEMA_H_INCLUDED
+#define STREAMSCHEMA_H_INCLUDED
+
+//CxxTest includes
+#include <cxxtest/TestSuite.h>
+
+//Standard library includes
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstring>
+
+//Include library headers
+#include "NetStream.h"
+#include "Schema.h"
+#include "StreamException.h"
+
+//Include shared test config header
+#include "TestCommon.h"
+
+//Using Inet namespace
+using namespace Inet;
+
+/*!	@brief Sample message type for schema tests */
+struct Quote {
+	enum class Side : u_char { BID = 'b', ASK = 'a' };
+
+	u_int32_t		id;
+	int64_t			price;
+	u_int16_t		quantity;
+	Side				side;
+	char				symbol[8];
+};
+
+typedef Schema<Quote,
+	Field<&Quote::id>,
+	Field<&Quote::price>,
+	Field<&Quote::quantity>,
+	Field<&Quote::side>,
+	Field<&Quote::symbol>
+> QuoteSchema_t;
+
+static_assert(QuoteSchema_t::size == 4 + 8 + 2 + 1 + 8, "Unexpected schema size");
+
+/*!	@brief Sample message type with floating-point fields */
+struct Tick {
+	double			bid;
+	float				sizes[2];
+};
+
+typedef Schema<Tick,
+	Field<&Tick::bid>,
+	Field<&Tick::sizes>
+> TickSchema_t;
+
+/*!
+ * Unit tests for schema-encoded NetStream messages
+ * @author jcleland
+ */
+class StreamSchema : public CxxTest::TestSuite {
+public:
+	/*!	@brief Test encode/decode of a schema message in both orders */
+	void test_roundtrip(void) {
+		for(NetStream::Order order : { NetStream::Order::LIFO, NetStream::Order::FIFO }) {
+			NetStream stream(order);
+			Quote in = sample(1), out;
+			memset(&out, 0, sizeof(out));
+
+			try {
+				QuoteSchema_t::encode(stream, in);
+				TS_ASSERT(stream.size() == QuoteSchema_t::size);
+				QuoteSchema_t::decode(stream, out);
+				TS_ASSERT(equal(in, out));
+				TS_ASSERT(stream.remaining() == 0);
+			}
+			catch(const StreamException &se) {
+				TS_FAIL(se.what());
+			}
+		}
+	}
+
+	/*!	@brief Test fields are written back to back in network byte order */
+	void test_wire_layout(void) {
+		NetStream stream;
+		Quote in = sample(0x01020304);
+		in.price = 0x0a0b0c0d0e0f1011LL;
+		in.quantity = 0x1213;
+
+		QuoteSchema_t::encode(stream, in);
+		const char* p = stream.data().data();
+		const char expected[] = {
+			0x01, 0x02, 0x03, 0x04,
+			0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11,
+			0x12, 0x13, 'b', 'A', 'B', 'C', 'D', 0, 0, 0, 0
+		};
+		TS_ASSERT(memcmp(p, expected, sizeof(expected)) == 0);
+	}
+
+	/*!	@brief Test floating-point fields are written as network order IEEE-754 */
+	void test_float_fields(void) {
+		NetStream stream;
+		Tick in = { -2.0, { 1.0f, 0.5f } }, out = { 0, { 0, 0 } };
+		const char expected[] = {
+			(char)0xc0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+			0x3f, (char)0x80, 0x00, 0x00, 0x3f, 0x00, 0x00, 0x00
+		};
+
+		TickSchema_t::encode(stream, in);
+		TS_ASSERT(stream.size() == sizeof(expected));
+		TS_ASSERT(memcmp(stream.data().data(), expected, sizeof(expected)) == 0);
+
+		TickSchema_t::decode(stream, out);
+		TS_ASSERT(out.bid == in.bid);
+		TS_ASSERT(out.sizes[0] == in.sizes[0] && out.sizes[1] == in.sizes[1]);
+	}
+
+	/*!	@brief Test schema messages mixed with tagged values */
+	void test_mixed(void) {
+		NetStream stream(NetStream::Order::FIFO);
+		std::vector<Quote> in = { sample(1), sample(2), sample(3) };
+		Quote out;
+		u_int32_t count = 0;
+		std::string trailer;
+
+		try {
+			stream << (u_int32_t)in.size();
+			QuoteSchema_t::encode(stream, in.data(), in.size());
+			stream << std::string("end");
+
+			stream >> count;
+			TS_ASSERT(count == in.size());
+			for(u_int32_t i = 0; i < count; i++) {
+				QuoteSchema_t::decode(stream, out);
+				TS_ASSERT(equal(in[i], out));
+			}
+			stream >> trailer;
+			TS_ASSERT(trailer == "end");
+		}
+		catch(const StreamException &se) {
+			TS_FAIL(se.what());
+		}
+	}
+
+	/*!	@brief Test short data is reported */
+	void test_short(void) {
+		NetStream stream(NetStream::Order::FIFO);
+		Quote out;
+
+		stream << (u_int32_t)1;
+		TS_ASSERT_THROWS(QuoteSchema_t::decode(stream, out), const StreamException&);
+	}
+
+private:
+	/*!	@brief Build a quote with predictable field values */
+	static Quote sample(u_int32_t id) {
+		Quote q;
+		memset(&q, 0, sizeof(q));
+		q.id = id;
+		q.price = -123456789012LL * id;
+		q.quantity = (u_int16_t)(100 * id);
+		q.side = Quote::Side::BID;
+		memcpy(q.symbol, "ABCD", 4);
+		return q;
+	}
+
+	/*!	@brief Compare quotes field by field */
+	static bool equal(const Quote& a, const Quote& b) {
+		return a.id == b.id && a.price == b.price && a.quantity == b.quantity &&
+			a.side == b.side && memcmp(a.symbol, b.symbol, sizeof(a.symbol)) == 0;
+	}
+};
+
+#endif //Include once
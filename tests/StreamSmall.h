@@ -0,0 +1,139 @@
+/**
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//Include once
+#ifndef STREAMSMALL_H_INCLUDED
+#define STREAMSMALL_H_INCLUDED
+
+//CxxTest includes
+#include <cxxtest/TestSuite.h>
+
+//Standard library includes
+#include <string>
+#include <utility>
+
+//Include library headers
+#include "NetStream.h"
+#include "SmallNetStream.h"
+#include "BufferPool.h"
+#include "StreamException.h"
+
+//Include shared test config header
+#include "TestCommon.h"
+
+//Using Inet namespace
+using namespace Inet;
+
+/*!
+ * Unit tests for SmallNetStream inline storage
+ * @author jcleland
+ */
+class StreamSmall : public CxxTest::TestSuite {
+public:
+	/*!	@brief Test short messages stay inside the object */
+	void test_inline(void) {
+		SmallNetStream<128> stream(NetStream::Order::FIFO);
+		const char* begin = reinterpret_cast<const char*>(&stream);
+		std::string str;
+		u_int32_t val = 0;
+
+		try {
+			stream << (u_int32_t)17 << std::string("control");
+			TS_ASSERT(stream.isInline());
+			TS_ASSERT(stream.data().data() >= begin &&
+				stream.data().data() < begin + sizeof(stream));
+
+			stream >> val >> str;
+			TS_ASSERT(val == 17 && str == "control");
+		}
+		catch(const StreamException &se) {
+			TS_FAIL(se.what());
+		}
+	}
+
+	/*!	@brief Test a message outgrowing the inline storage moves to the heap */
+	void test_spill(void) {
+		SmallNetStream<32> stream;
+		const std::string big(100, 'b');
+		std::string str;
+		u_int16_t val = 0;
+
+		try {
+			stream << (u_int16_t)5;
+			TS_ASSERT(stream.isInline());
+			stream << big;
+			TS_ASSERT(!stream.isInline());
+
+			stream >> str >> val;
+			TS_ASSERT(str == big && val == 5);
+		}
+		catch(const StreamException &se) {
+			TS_FAIL(se.what());
+		}
+	}
+
+	/*!	@brief Test moves copy inline data and take over heap storage */
+	void test_move(void) {
+		SmallNetStream<64> a(NetStream::Order::FIFO), c;
+		std::string str;
+
+		try {
+			a << std::string("inline");
+			SmallNetStream<64> b(std::move(a));
+			TS_ASSERT(b.isInline() && b.order() == NetStream::Order::FIFO);
+			TS_ASSERT(a.size() == 0);
+			b >> str;
+			TS_ASSERT(str == "inline");
+
+			//Heap storage changes hands without a copy
+			c << std::string(200, 'h');
+			const char* heap = c.data().data();
+			b = std::move(c);
+			TS_ASSERT(b.data().data() == heap && !b.isInline());
+
+			//A plain stream can take over inline data
+			SmallNetStream<64> d;
+			d << (u_char)'x';
+			NetStream plain(std::move(d));
+			u_char uc = 0;
+			plain >> uc;
+			TS_ASSERT(uc == 'x');
+		}
+		catch(const StreamException &se) {
+			TS_FAIL(se.what());
+		}
+	}
+
+	/*!	@brief Test inline storage is never kept by a pool */
+	void test_pool(void) {
+		BufferPool pool(4, 4096, 64);
+
+		{
+			NetStream pooled(pool);
+			SmallNetStream<64> small;
+			small << (u_int32_t)1;
+			pooled = std::move(small);
+		}
+
+		const BufferPool::Stats stats = pool.stats();
+		TS_ASSERT(stats.released == 1 && stats.pooled == 1);
+	}
+};
+
+#endif //STREAMSMALL_H_INCLUDED
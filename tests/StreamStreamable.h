@@ -0,0 +1,211 @@
+/**
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//Include once
+#ifndef STREAMSTREAMABLE_H_INCLUDED
+#define STREAMSTREAMABLE_H_INCLUDED
+
+//CxxTest includes
+#include <cxxtest/TestSuite.h>
+
+//Standard library includes
+#include <string>
+#include <vector>
+#include <memory>
+
+//Include library headers
+#include "NetStream.h"
+#include "Streamable.h"
+#include "StreamException.h"
+
+//Include shared test config header
+#include "TestCommon.h"
+
+//Using Inet namespace
+using namespace Inet;
+
+/*!	@brief Simple streamable type, decodes in either order */
+class Point : public Streamable {
+public:
+	int32_t x = 0;
+	int32_t y = 0;
+
+	u_int32_t encodedSize() const override {
+		return NetStream::encodedSize(x) + NetStream::encodedSize(y);
+	}
+
+	void encode(NetStream& stream) const override {
+		stream << x << y;
+	}
+
+	void decode(NetStream& stream) override {
+		if(stream.order() == NetStream::Order::FIFO)
+			stream >> x >> y;
+		else
+			stream >> y >> x;
+	}
+};
+
+/*!	@brief Streamable type holding nested streamable values */
+class Path : public Streamable {
+public:
+	std::string name;
+	std::vector<Point> points;
+
+	u_int32_t encodedSize() const override {
+		u_int32_t bytes = NetStream::encodedSize(name) +
+			NetStream::encodedSize((u_int32_t)points.size());
+		for(const Point& point : points)
+			bytes += NetStream::encodedSize(point);
+		return bytes;
+	}
+
+	void encode(NetStream& stream) const override {
+		stream << name << (u_int32_t)points.size();
+		for(const Point& point : points)
+			stream << point;
+	}
+
+	void decode(NetStream& stream) override {
+		u_int32_t count = 0;
+		stream >> name >> count;
+		points.resize(count);
+		for(Point& point : points)
+			stream >> point;
+	}
+};
+
+/*!	@brief Streamable type that reads back less than it wrote */
+class Truncated : public Point {
+public:
+	void decode(NetStream& stream) override {
+		stream >> x;
+	}
+};
+
+/*!	@brief Streamable type whose decode fails after reading a value */
+class Failing : public Point {
+public:
+	void decode(NetStream& stream) override {
+		stream >> x;
+		throw StreamException(STREAM_ERR_INVALID_TYPE, "Decode failed");
+	}
+};
+
+/*!
+ * Unit tests for Streamable user types in NetStream
+ * @author jcleland
+ */
+class StreamStreamable : public CxxTest::TestSuite {
+public:
+	/*!	@brief Test a streamable value in both orders */
+	void test_point(void) {
+		for(NetStream::Order order : { NetStream::Order::LIFO, NetStream::Order::FIFO }) {
+			NetStream stream(order);
+			Point in, out;
+			u_int16_t before = 0, after = 0;
+			in.x = -5; in.y = 70000;
+
+			try {
+				stream << (u_int16_t)1 << in << (u_int16_t)2;
+				if(order == NetStream::Order::FIFO)
+					stream >> before >> out >> after;
+				else
+					stream >> after >> out >> before;
+				TS_ASSERT(before == 1 && after == 2);
+				TS_ASSERT(out.x == in.x && out.y == in.y);
+				TS_ASSERT(stream.remaining() == 0);
+			}
+			catch(const StreamException &se) {
+				TS_FAIL(se.what());
+			}
+		}
+	}
+
+	/*!	@brief Test a nested object graph is reserved in a single step */
+	void test_nested(void) {
+		NetStream stream(NetStream::Order::FIFO);
+		Path in, out;
+
+		in.name = "route";
+		for(int32_t i = 0; i < 50; i++) {
+			Point point;
+			point.x = i; point.y = -i;
+			in.points.push_back(point);
+		}
+
+		try {
+			stream << in;
+			TS_ASSERT(stream.size() == NetStream::encodedSize(in));
+			TS_ASSERT(stream.data().capacity() == stream.size());
+
+			stream >> out;
+			TS_ASSERT(out.name == in.name);
+			TS_ASSERT(out.points.size() == in.points.size());
+			for(size_t i = 0; i < out.points.size(); i++)
+				TS_ASSERT(out.points[i].x == (int32_t)i && out.points[i].y == -(int32_t)i);
+		}
+		catch(const StreamException &se) {
+			TS_FAIL(se.what());
+		}
+	}
+
+	/*!	@brief Test a decode that does not consume its value is reported */
+	void test_length_mismatch(void) {
+		NetStream stream(NetStream::Order::FIFO);
+		Point in;
+		Truncated out;
+
+		stream << in;
+		TS_ASSERT_THROWS(stream >> out, const StreamException&);
+		TS_ASSERT(stream.offset() == 0);
+	}
+
+	/*!	@brief Test a throwing decode leaves the stream as it was */
+	void test_decode_error(void) {
+		for(NetStream::Order order : { NetStream::Order::LIFO, NetStream::Order::FIFO }) {
+			NetStream stream(order);
+			Point in, out;
+			Failing failing;
+			u_int16_t before = 0;
+			in.x = 3; in.y = 4;
+
+			try {
+				stream << (u_int16_t)1 << in;
+				if(order == NetStream::Order::FIFO)
+					stream >> before;
+				const u_int32_t size = stream.size(), offset = stream.offset();
+
+				TS_ASSERT_THROWS(stream >> failing, const StreamException&);
+				TS_ASSERT(stream.size() == size && stream.offset() == offset);
+
+				stream >> out;
+				if(order == NetStream::Order::LIFO)
+					stream >> before;
+				TS_ASSERT(out.x == 3 && out.y == 4 && before == 1);
+				TS_ASSERT(stream.remaining() == 0);
+			}
+			catch(const StreamException &se) {
+				TS_FAIL(se.what());
+			}
+		}
+	}
+};
+
+#endif //Include once
@@ -31,6 +31,8 @@
 #include <string>
 #include <vector>
 #include <memory>
+#include <cstring>
+#include <string_view>
 
 //Include library headers
 #include "NetStream.h"
@@ -83,6 +85,128 @@ public:
 			TS_FAIL(se.what());
 		}
 	}
+	/*!	@brief Test FIFO decode of strings mixed with other values */
+	void test_fifo_string(void) {
+		NetStream stream(NetStream::Order::FIFO);
+		std::string first, second;
+		u_int32_t value = 0;
+
+		try {
+			stream << std::string(STRING_DATA) << (u_int32_t)99 << std::string("second");
+			stream >> first >> value >> second;
+			TS_ASSERT(first.compare(STRING_DATA) == 0);
+			TS_ASSERT(value == 99);
+			TS_ASSERT(second.compare("second") == 0);
+			TS_ASSERT(stream.remaining() == 0);
+		}
+		catch(const StreamException &se) {
+			TS_FAIL(se.what());
+		}
+	}
+
+	/*!	@brief Test setting raw FIFO stream data */
+	void test_fifo_rawstring(void) {
+		std::string str;
+		char raw[] = {
+			0x73, 0x00, 0x00, 0x00, 0x10, 0x54, 0x68, 0x69,
+			0x73, 0x20, 0x69, 0x73, 0x20, 0x61, 0x20, 0x73,
+			0x74, 0x72, 0x69, 0x6e, 0x67, 0x73
+		};
+
+		try {
+			NetStream stream(raw, sizeof(raw), NetStream::Order::FIFO);
+			stream >> str;
+			TS_ASSERT(str.compare(STRING_DATA) == 0);
+		}
+		catch(const StreamException &se) {
+			TS_FAIL(se.what());
+		}
+	}
+
+	/*!	@brief Test the encoded string layout in both orders */
+	void test_string_layout(void) {
+		const char lifo[] = {
+			0x73, 0x54, 0x68, 0x69, 0x73, 0x20, 0x69, 0x73,
+			0x20, 0x61, 0x20, 0x73, 0x74, 0x72, 0x69, 0x6e,
+			0x67, 0x00, 0x00, 0x00, 0x10, 0x73
+		};
+		const char fifo[] = {
+			0x73, 0x00, 0x00, 0x00, 0x10, 0x54, 0x68, 0x69,
+			0x73, 0x20, 0x69, 0x73, 0x20, 0x61, 0x20, 0x73,
+			0x74, 0x72, 0x69, 0x6e, 0x67, 0x73
+		};
+		NetStream lstream;
+		NetStream fstream(NetStream::Order::FIFO);
+
+		lstream << std::string(STRING_DATA);
+		fstream << std::string(STRING_DATA);
+		TS_ASSERT(lstream.size() == sizeof(lifo));
+		TS_ASSERT(memcmp(lstream.data().data(), lifo, sizeof(lifo)) == 0);
+		TS_ASSERT(fstream.size() == sizeof(fifo));
+		TS_ASSERT(memcmp(fstream.data().data(), fifo, sizeof(fifo)) == 0);
+	}
+
+	/*!	@brief Test strings with embedded NULs decode intact */
+	void test_binary_string(void) {
+		for(NetStream::Order order : { NetStream::Order::LIFO, NetStream::Order::FIFO }) {
+			NetStream stream(order);
+			const std::string in("nul\0inside\0", 11);
+			std::string out;
+
+			try {
+				stream << in;
+				stream >> out;
+				TS_ASSERT(out.size() == 11 && out == in);
+			}
+			catch(const StreamException &se) {
+				TS_FAIL(se.what());
+			}
+		}
+	}
+
+	/*!	@brief Test decoding into an existing string keeps its storage */
+	void test_reuse_string(void) {
+		NetStream stream(NetStream::Order::FIFO);
+		std::string out;
+
+		try {
+			out.reserve(64);
+			const char* storage = out.data();
+			stream << std::string(STRING_DATA) << std::string("short");
+
+			stream >> out;
+			TS_ASSERT(out == STRING_DATA && out.data() == storage);
+			stream >> out;
+			TS_ASSERT(out == "short" && out.data() == storage);
+		}
+		catch(const StreamException &se) {
+			TS_FAIL(se.what());
+		}
+	}
+
+	/*!	@brief Test a string_view refers to the stream's storage */
+	void test_string_view(void) {
+		NetStream stream(NetStream::Order::FIFO), lstream;
+		std::string_view view;
+
+		try {
+			stream << std::string(STRING_DATA) << std::string("");
+			stream >> view;
+			TS_ASSERT(view == STRING_DATA);
+			TS_ASSERT(view.data() > stream.data().data() &&
+				view.data() < stream.data().data() + stream.size());
+			stream >> view;
+			TS_ASSERT(view.empty() && stream.remaining() == 0);
+
+			//LIFO decode releases the storage, so no view is handed out
+			lstream << std::string(STRING_DATA);
+			TS_ASSERT_THROWS(lstream >> view, StreamException);
+			TS_ASSERT(lstream.remaining() == lstream.size());
+		}
+		catch(const StreamException &se) {
+			TS_FAIL(se.what());
+		}
+	}
 };
 
 #endif //Include once
@@ -0,0 +1,186 @@
+/**
+ *  The latest source code can be downloaded at:
+ *
+ *  Copyright (c) 2020, James A. Cleland <jcleland at jamescleland dot com>
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 3 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+//Include once
+#ifndef STREAMVIEW_H_INCLUDED
+#define STREAMVIEW_H_INCLUDED
+
+//CxxTest includes
+#include <cxxtest/TestSuite.h>
+
+//Standard library includes
+#include <string>
+#include <string_view>
+#include <cstring>
+#include <vector>
+
+//Include library headers
+#include "NetStream.h"
+#include "NetStreamView.h"
+#include "StreamException.h"
+
+//Include shared test config header
+#include "TestCommon.h"
+
+//Using Inet namespace
+using namespace Inet;
+
+/*!
+ * Unit tests for decoding through a NetStreamView
+ * @author jcleland
+ */
+class StreamView : public CxxTest::TestSuite {
+public:
+	/*!	@brief Test values decode from external memory in both orders */
+	void test_decode(void) {
+		for(NetStream::Order order : { NetStream::Order::LIFO, NetStream::Order::FIFO }) {
+			NetStream in(order);
+			char c = 0;
+			int32_t l = 0;
+			u_int64_t w = 0;
+			std::string str;
+
+			try {
+				in << 'x' << (int32_t)-5 << (u_int64_t)1234567890123ULL << std::string("text");
+
+				//Copy to memory the stream does not own
+				std::vector<char> wire(in.data().begin(), in.data().end());
+				NetStreamView view(wire.data(), wire.size(), order);
+
+				if(order == NetStream::Order::FIFO)
+					view >> c >> l >> w >> str;
+				else
+					view >> str >> w >> l >> c;
+
+				TS_ASSERT(c == 'x' && l == -5 && w == 1234567890123ULL);
+				TS_ASSERT(str == "text");
+				TS_ASSERT(view.remaining() == 0);
+				TS_ASSERT(memcmp(wire.data(), in.data().data(), wire.size()) == 0);
+			}
+			catch(const StreamException &se) {
+				TS_FAIL(se.what());
+			}
+		}
+	}
+
+	/*!	@brief Test strings and blobs refer to the underlying memory */
+	void test_zero_copy(void) {
+		for(NetStream::Order order : { NetStream::Order::LIFO, NetStream::Order::FIFO }) {
+			NetStream in(order);
+			const char blob[] = { 1, 2, 3, 4 };
+			std::string_view str;
+			const char* buf = nullptr;
+			size_t bytes = 0;
+
+			try {
+				in << std::string("hello");
+				in.write(blob, sizeof(blob));
+				in << std::string("world");
+
+				const NetStream::Buffer_t& wire = in.data();
+				const char* begin = wire.data();
+				const char* end = begin + wire.size();
+				NetStreamView view(begin, wire.size(), order);
+
+				view >> str;
+				TS_ASSERT(str == ((order == NetStream::Order::FIFO) ? "hello" : "world"));
+				TS_ASSERT(str.data() > begin && str.data() < end);
+
+				view.read(buf, bytes);
+				TS_ASSERT(bytes == sizeof(blob) && memcmp(buf, blob, bytes) == 0);
+				TS_ASSERT(buf > begin && buf < end);
+
+				//Decoding through the view leaves the stream untouched
+				TS_ASSERT(in.remaining() == wire.size());
+			}
+			catch(const StreamException &se) {
+				TS_FAIL(se.what());
+			}
+		}
+	}
+
+	/*!	@brief Test compact integers and arrays decode through a view */
+	void test_compact_array(void) {
+		NetStream in(NetStream::Order::FIFO);
+		std::vector<int32_t> values = { -1, 0, 1, 1 << 30 }, out;
+		u_int32_t v = 0;
+		int16_t z = 0;
+
+		try {
+			in.setCompact(true);
+			in << (u_int32_t)300 << (int16_t)-2 << values;
+
+			NetStreamView view(in.data().data(), in.size(), NetStream::Order::FIFO);
+			view >> v >> z >> out;
+			TS_ASSERT(v == 300 && z == -2);
+			TS_ASSERT(out == values);
+		}
+		catch(const StreamException &se) {
+			TS_FAIL(se.what());
+		}
+	}
+
+	/*!	@brief Test a sub-stream decodes as a view and values can be skipped */
+	void test_substream_skip(void) {
+		for(NetStream::Order order : { NetStream::Order::LIFO, NetStream::Order::FIFO }) {
+			NetStream body(order), message(order);
+			NetStreamView sub(nullptr, 0, order);
+			u_int16_t value = 0;
+
+			try {
+				body << (u_int16_t)99;
+				message << std::string("skipped") << body << std::string("skipped");
+
+				NetStreamView view(message);
+				view.skip() >> sub;
+				view.skip();
+				TS_ASSERT(view.remaining() == 0);
+
+				sub >> value;
+				TS_ASSERT(value == 99);
+			}
+			catch(const StreamException &se) {
+				TS_FAIL(se.what());
+			}
+		}
+	}
+
+	/*!	@brief Test a view of a stream starts at its read offset */
+	void test_stream_view(void) {
+		NetStream stream(NetStream::Order::FIFO);
+		u_char uc = 0;
+
+		try {
+			stream << (u_char)1 << (u_char)2;
+			stream >> uc;
+
+			//View starts at the stream's read offset
+			NetStreamView view(stream);
+			TS_ASSERT(view.remaining() == 3);
+			view >> uc;
+			TS_ASSERT(uc == 2);
+			TS_ASSERT_THROWS(view >> uc, StreamException);
+		}
+		catch(const StreamException &se) {
+			TS_FAIL(se.what());
+		}
+	}
+};
+
+#endif //STREAMVIEW_H_INCLUDED
@@ -21,8 +21,19 @@
 
 #pragma once
 
+//CxxTest includes
+#include <cxxtest/TestSuite.h>
+
+//System includes
+#include <sys/types.h>
+#include <sys/socket.h>
+
+//Standard library includes
+#include <memory>
+
 //Project includes
 #include "Address.h"
+#include "ConnectionEndpoint.h"
 
 //Namespace container
 namespace Inet {
@@ -31,4 +42,26 @@ namespace Inet {
 const char* hostname				 = "localhost";
 const char* port						 = "56000";
 
+/*!	@brief Endpoint wrapping one end of a local socket pair */
+class PairEndpoint : public ConnectionEndpoint {
+public:
+	explicit PairEndpoint(socket_t sock) :
+		ConnectionEndpoint(sock, &address(), sizeof(SockAddrIn_t)) {}
+	virtual ~PairEndpoint() { close(); }
+
+private:
+	static SockAddrIn_t& address() { static SockAddrIn_t addr = {}; return addr; }
+};
+
+/*!	@brief Connect a pair of endpoints over a local socket pair
+ *	@param left Receives one end of the pair
+ *	@param right Receives the other end
+ */
+inline void MakePair(std::unique_ptr<PairEndpoint>& left, std::unique_ptr<PairEndpoint>& right) {
+	int fds[2];
+	TS_ASSERT(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+	left.reset(new PairEndpoint(fds[0]));
+	right.reset(new PairEndpoint(fds[1]));
+}
+
 }